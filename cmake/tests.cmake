@@ -40,11 +40,16 @@ add_executable(
   run_unit_tests
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/run_unit_tests.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_buffer.c
+  ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_dbc.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_dict.c
+  ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_dispatch.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_nmt.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_os.c
+  ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_pdo.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_scripts.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_sdo.c
+  ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_sdo_cache.c
+  ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_sdo_client.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_wrapper.c)
 
 add_dependencies(
@@ -67,7 +72,8 @@ target_link_options(
   run_unit_tests
   PUBLIC
   -Wl,--wrap=can_read
-  -Wl,--wrap=can_write)
+  -Wl,--wrap=can_write
+  -Wl,--wrap=can_write_batch)
 
 include_directories(
   PUBLIC ${CMAKE_CURRENT_SOURCE_DIR}/src
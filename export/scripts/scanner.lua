@@ -9,21 +9,26 @@ local nodes      = {}
 local start_time = os.clock()
 local timeout_ms = 3000
 
+can_set_filter(0x700, 0x780) -- Heartbeat and boot-up messages only.
 nmt_send_command(0x00, 0x81) -- Reset all nodes.
 
 while (os.clock() - start_time) * 1000 <= timeout_ms do
-  local id, length, message = can_read()
+  local frames = can_read_batch()
 
   if key_is_hit() then
     break
   end
 
   -- Wait for boot-up messages.
-  if length == 1 and message == 0x00 then
-    table.insert(nodes, id - 0x700)
+  for _, frame in ipairs(frames or {}) do
+    if frame.length == 1 and frame.data == 0x00 then
+      table.insert(nodes, frame.id - 0x700)
+    end
   end
 end
 
+can_clear_filter()
+
 for _, node_id in ipairs(nodes) do
   local temp, dev_name = sdo_read(node_id, 0x1008, 0x00)
   if nil == dev_name then
@@ -74,10 +74,11 @@ print("\nTime         CAN-ID  Length  Data")
 trace_filename = generate_trace_filename()
 
 while not key_is_hit() do
-    local id, length, data, timestamp_us = can_read()
+    local frames = can_read_batch()
 
-    if data then
-        data = utils.swap_bytes(data, length)
+    for _, frame in ipairs(frames or {}) do
+        local id, length, timestamp_us = frame.id, frame.length, frame.timestamp_us
+        local data = utils.swap_bytes(frame.data, length)
 
         if not initial_timestamp_us then
             initial_timestamp_us = timestamp_us
@@ -35,14 +35,22 @@ end
 local output    = dbc_decode(watch_id, 0x0000000000000000)
 local num_lines = select(2, output:gsub('\n', '\n')) + 1
 
+can_set_filter(watch_id)
 utils.clear_screen()
 
 while false == key_is_hit() do
-  local id, length, data = can_read()
+  local frames = can_read_batch()
+  local latest = nil
 
-  if id == watch_id then
-    print(id)
-    output = dbc_decode(watch_id, data)
+  -- Only the most recent frame of a batch is worth displaying.
+  for _, frame in ipairs(frames or {}) do
+    if frame.id == watch_id then
+      latest = frame
+    end
+  end
+
+  if latest then
+    output = dbc_decode(watch_id, latest.data)
     utils.print_multiline_at_same_position(output, num_lines)
   end
 end
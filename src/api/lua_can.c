@@ -9,10 +9,14 @@
 
 #include "can.h"
 #include "core.h"
+#include "dispatch.h"
 #include "lua.h"
 #include "lauxlib.h"
 #include "lua_can.h"
 #include "os.h"
+#include "scripts.h"
+
+static void to_filter(lua_State *L, can_filter_t* filter);
 
 int lua_can_write(lua_State *L)
 {
@@ -91,12 +95,10 @@ int lua_can_write(lua_State *L)
 int lua_can_read(lua_State *L)
 {
     can_message_t message = { 0 };
-    status_t      status;
     uint32        length;
     uint64        data    = 0;;
 
-    status = can_read(&message);
-    if (ALL_OK == status)
+    if (1 == dispatch_read(scripts_get_subscriber(), &message, 1, SCRIPT_READ_TIMEOUT_MS))
     {
         length = message.length;
 
@@ -120,10 +122,105 @@ int lua_can_read(lua_State *L)
     }
 }
 
+int lua_can_read_batch(lua_State *L)
+{
+    can_message_t   messages[CAN_BATCH_SIZE];
+    dispatch_sub_t* sub          = scripts_get_subscriber();
+    uint32          max_messages = (uint32)luaL_optinteger(L, 1, CAN_BATCH_SIZE);
+    uint32          num_read;
+    uint32          length;
+    uint32          index;
+    uint64          data;
+
+    if (NULL == sub)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    if (max_messages > CAN_BATCH_SIZE)
+    {
+        max_messages = CAN_BATCH_SIZE;
+    }
+
+    num_read = dispatch_read(sub, messages, max_messages, SCRIPT_READ_TIMEOUT_MS);
+
+    lua_createtable(L, (int)num_read, 0);
+
+    for (index = 0; index < num_read; index += 1)
+    {
+        length = messages[index].length;
+        data   = 0;
+
+        if (length > 8)
+        {
+            length = 8;
+        }
+
+        os_memcpy(&data, &messages[index].data, sizeof(uint64));
+
+        lua_createtable(L, 0, 4);
+        lua_pushinteger(L, messages[index].id);
+        lua_setfield(L, -2, "id");
+        lua_pushinteger(L, length);
+        lua_setfield(L, -2, "length");
+        lua_pushinteger(L, data);
+        lua_setfield(L, -2, "data");
+        lua_pushinteger(L, messages[index].timestamp_us);
+        lua_setfield(L, -2, "timestamp_us");
+        lua_rawseti(L, -2, index + 1);
+    }
+
+    return 1;
+}
+
+int lua_can_set_filter(lua_State *L)
+{
+    can_filter_t filter;
+
+    to_filter(L, &filter);
+
+    lua_pushboolean(L, (ALL_OK == dispatch_set_filter(scripts_get_subscriber(), &filter, 1)) ? 1 : 0);
+    return 1;
+}
+
+int lua_can_add_filter(lua_State *L)
+{
+    can_filter_t filter;
+
+    to_filter(L, &filter);
+
+    lua_pushboolean(L, (ALL_OK == dispatch_add_filter(scripts_get_subscriber(), &filter)) ? 1 : 0);
+    return 1;
+}
+
+int lua_can_clear_filter(lua_State *L)
+{
+    lua_pushboolean(L, (ALL_OK == dispatch_set_filter(scripts_get_subscriber(), NULL, 0)) ? 1 : 0);
+    return 1;
+}
+
 void lua_register_can_commands(core_t *core)
 {
     lua_pushcfunction(core->L, lua_can_write);
     lua_setglobal(core->L, "can_write");
     lua_pushcfunction(core->L, lua_can_read);
     lua_setglobal(core->L, "can_read");
+    lua_pushcfunction(core->L, lua_can_read_batch);
+    lua_setglobal(core->L, "can_read_batch");
+    lua_pushcfunction(core->L, lua_can_set_filter);
+    lua_setglobal(core->L, "can_set_filter");
+    lua_pushcfunction(core->L, lua_can_add_filter);
+    lua_setglobal(core->L, "can_add_filter");
+    lua_pushcfunction(core->L, lua_can_clear_filter);
+    lua_setglobal(core->L, "can_clear_filter");
+}
+
+static void to_filter(lua_State *L, can_filter_t* filter)
+{
+    uint32 id = (uint32)luaL_checkinteger(L, 1);
+
+    filter->id          = id & CAN_EFF_ID_MASK;
+    filter->is_extended = (filter->id > CAN_SFF_ID_MASK) ? IS_TRUE : IS_FALSE;
+    filter->mask        = (uint32)luaL_optinteger(L, 2, (IS_TRUE == filter->is_extended) ? CAN_EFF_ID_MASK : CAN_SFF_ID_MASK);
 }
@@ -15,6 +15,10 @@
 
 int  lua_can_write(lua_State *L);
 int  lua_can_read(lua_State *L);
+int  lua_can_read_batch(lua_State *L);
+int  lua_can_set_filter(lua_State *L);
+int  lua_can_add_filter(lua_State *L);
+int  lua_can_clear_filter(lua_State *L);
 void lua_register_can_commands(core_t *core);
 
 #endif /* LUA_CAN_H */
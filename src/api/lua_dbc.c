@@ -14,6 +14,14 @@
 #include "lua_dbc.h"
 #include "os.h"
 
+int lua_dbc_close(lua_State *L)
+{
+    uint32 handle = (uint32)luaL_checkinteger(L, 1);
+
+    lua_pushboolean(L, (ALL_OK == dbc_close(handle)) ? 1 : 0);
+    return 1;
+}
+
 int lua_dbc_decode(lua_State *L)
 {
     int         can_id = luaL_checkinteger(L, 1);
@@ -25,6 +33,129 @@ int lua_dbc_decode(lua_State *L)
     return 1;
 }
 
+int lua_dbc_decode_values(lua_State *L)
+{
+    static dbc_value_t values[DBC_MAX_VALUES];
+    int                can_id  = luaL_checkinteger(L, 1);
+    uint64             data    = luaL_optinteger(L, 2, 0);
+    const message_t*   message = dbc_find_message(can_id);
+    int                count;
+    int                i;
+
+    if (NULL == message)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    /* Tables passed in are refilled, so polling loops don't allocate.  A
+     * group the multiplexer no longer selects mustn't linger in them, nor
+     * a label the value no longer has.
+     */
+    lua_settop(L, 4);
+    if (lua_istable(L, 3))
+    {
+        lua_pushvalue(L, 3);
+
+        for (i = 0; (message->mux_count > 0) && (i < message->signal_count); ++i)
+        {
+            if (message->signals[i].mux_value >= 0)
+            {
+                lua_pushnil(L);
+                lua_setfield(L, -2, message->signals[i].name);
+            }
+        }
+    }
+    else
+    {
+        lua_createtable(L, 0, message->signal_count);
+    }
+
+    count = dbc_decode_values(message, data, values, DBC_MAX_VALUES);
+    for (i = 0; i < count; ++i)
+    {
+        lua_pushnumber(L, values[i].value);
+        lua_setfield(L, -2, message->signals[values[i].signal].name);
+    }
+
+    if (lua_istable(L, 4))
+    {
+        lua_pushvalue(L, 4);
+
+        for (i = 0; i < message->signal_count; ++i)
+        {
+            lua_pushnil(L);
+            lua_setfield(L, -2, message->signals[i].name);
+        }
+    }
+    else
+    {
+        lua_createtable(L, 0, 0);
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        if (NULL != values[i].label)
+        {
+            lua_pushstring(L, values[i].label);
+            lua_setfield(L, -2, message->signals[values[i].signal].name);
+        }
+    }
+
+    return 2;
+}
+
+int lua_dbc_encode(lua_State *L)
+{
+    static dbc_value_t values[DBC_MAX_VALUES];
+    int                can_id  = luaL_checkinteger(L, 1);
+    uint64             data    = os_swap_64(luaL_optinteger(L, 3, 0));
+    const message_t*   message = dbc_find_message(can_id);
+    int                count   = 0;
+
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    if (NULL == message)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushnil(L);
+    while (0 != lua_next(L, 2))
+    {
+        int signal = -1;
+
+        if (LUA_TSTRING == lua_type(L, -2))
+        {
+            signal = dbc_find_signal(message, lua_tostring(L, -2));
+        }
+
+        if ((signal < 0) || (DBC_MAX_VALUES == count))
+        {
+            lua_pop(L, 2);
+            lua_pushnil(L);
+            return 1;
+        }
+
+        values[count].signal = signal;
+        values[count].value  = lua_tonumber(L, -1);
+        count               += 1;
+
+        lua_pop(L, 1);
+    }
+
+    if (ALL_OK != dbc_encode(message, values, count, &data))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    /* First byte in the highest eight bits, as can_write() takes it. */
+    lua_pushinteger(L, (lua_Integer)os_swap_64(data));
+    return 1;
+}
+
 int lua_dbc_find_id_by_name(lua_State *L)
 {
     const char* search = luaL_checkstring(L, 1);
@@ -44,6 +175,44 @@ int lua_dbc_find_id_by_name(lua_State *L)
     return 1;
 }
 
+int lua_dbc_find_messages(lua_State *L)
+{
+    static const char* const match_names[] = { "exact", "prefix", "substring", NULL };
+    const char*              search        = luaL_checkstring(L, 1);
+    dbc_match_t              match         = (dbc_match_t)luaL_checkoption(L, 2, "substring", match_names);
+    const message_t**        messages;
+    int                      count;
+    int                      i;
+
+    count = dbc_find_messages(search, match, NULL, 0);
+
+    lua_createtable(L, count, 0);
+    if (0 == count)
+    {
+        return 1;
+    }
+
+    messages = os_calloc((size_t)count, sizeof(message_t*));
+    if (NULL == messages)
+    {
+        return 1;
+    }
+
+    dbc_find_messages(search, match, messages, count);
+    for (i = 0; i < count; ++i)
+    {
+        lua_createtable(L, 0, 2);
+        lua_pushinteger(L, messages[i]->id);
+        lua_setfield(L, -2, "id");
+        lua_pushstring(L, messages[i]->name);
+        lua_setfield(L, -2, "name");
+        lua_rawseti(L, -2, i + 1);
+    }
+
+    os_free((void*)messages);
+    return 1;
+}
+
 int lua_dbc_load(lua_State *L)
 {
     const char *filename = luaL_checkstring(L, 1);
@@ -63,12 +232,57 @@ int lua_dbc_load(lua_State *L)
     return 1;
 }
 
+int lua_dbc_open(lua_State *L)
+{
+    const char* filename      = luaL_checkstring(L, 1);
+    const char* can_interface = luaL_optstring(L, 2, "");
+    uint32      first_id      = (uint32)luaL_optinteger(L, 3, 0);
+    uint32      last_id       = (uint32)luaL_optinteger(L, 4, 0x1FFFFFFF);
+    uint32      handle;
+
+    if (ALL_OK != dbc_open(filename, &handle))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    if (ALL_OK != dbc_bind(handle, can_interface, first_id, last_id))
+    {
+        dbc_close(handle);
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_pushinteger(L, handle);
+    return 1;
+}
+
+int lua_dbc_select_interface(lua_State *L)
+{
+    const char* can_interface = luaL_checkstring(L, 1);
+
+    lua_pushboolean(L, (ALL_OK == dbc_select_interface(can_interface)) ? 1 : 0);
+    return 1;
+}
+
 void lua_register_dbc_commands(core_t *core)
 {
+    lua_pushcfunction(core->L, lua_dbc_close);
+    lua_setglobal(core->L, "dbc_close");
     lua_pushcfunction(core->L, lua_dbc_decode);
     lua_setglobal(core->L, "dbc_decode");
+    lua_pushcfunction(core->L, lua_dbc_decode_values);
+    lua_setglobal(core->L, "dbc_decode_values");
+    lua_pushcfunction(core->L, lua_dbc_encode);
+    lua_setglobal(core->L, "dbc_encode");
     lua_pushcfunction(core->L, lua_dbc_find_id_by_name);
     lua_setglobal(core->L, "dbc_find_id_by_name");
+    lua_pushcfunction(core->L, lua_dbc_find_messages);
+    lua_setglobal(core->L, "dbc_find_messages");
     lua_pushcfunction(core->L, lua_dbc_load);
     lua_setglobal(core->L, "dbc_load");
+    lua_pushcfunction(core->L, lua_dbc_open);
+    lua_setglobal(core->L, "dbc_open");
+    lua_pushcfunction(core->L, lua_dbc_select_interface);
+    lua_setglobal(core->L, "dbc_select_interface");
 }
@@ -9,14 +9,18 @@
 
 #include "core.h"
 #include "dict.h"
+#include "eds.h"
 #include "lua.h"
 #include "lauxlib.h"
 #include "lua_sdo.h"
 #include "os.h"
 #include "sdo.h"
+#include "sdo_cache.h"
 
 extern bool_t is_printable_string(const char *str, size_t length);
 
+static void to_item(lua_State *L, int position, sdo_item_t* item, uint32* value);
+
 int lua_sdo_lookup_abort_code(lua_State *L)
 {
     int         abort_code = luaL_checkinteger(L, 1);
@@ -28,7 +32,6 @@ int lua_sdo_lookup_abort_code(lua_State *L)
 
 int lua_sdo_read(lua_State *L)
 {
-    can_message_t sdo_response = { 0 };
     disp_mode_t   disp_mode = SILENT;
     sdo_state_t   sdo_state;
     int           node_id = luaL_checkinteger(L, 1);
@@ -37,7 +40,9 @@ int lua_sdo_read(lua_State *L)
     bool_t        show_output = lua_toboolean(L, 4);
     const char*   comment = lua_tostring(L, 5);
     char          str_buffer[5] = { 0 };
-    uint32        result;
+    uint8*        data = NULL;
+    uint32        length = 0;
+    uint32        result = 0;
 
     limit_node_id((uint8 *)&node_id);
 
@@ -46,23 +51,26 @@ int lua_sdo_read(lua_State *L)
         disp_mode = SCRIPT_MODE;
     }
 
-    sdo_state = sdo_read(
-        &sdo_response,
+    sdo_state = sdo_read_data(
         disp_mode,
         (uint8)node_id,
         (uint16)index,
-        (uint16)sub_index,
+        (uint8)sub_index,
+        &data,
+        &length,
         comment);
 
     switch (sdo_state)
     {
         case IS_READ_SEGMENTED:
-            lua_pushstring(L, (const char *)sdo_response.data);
-            lua_pushstring(L, (const char *)sdo_response.data);
+        case IS_READ_BLOCK:
+            /* Lua strings are binary safe, so embedded zeros survive. */
+            lua_pushlstring(L, (const char *)data, length);
+            lua_pushlstring(L, (const char *)data, length);
             break;
         case IS_READ_EXPEDITED:
-            os_memcpy(&result, &sdo_response.data, sizeof(uint32));
-            os_memcpy(&str_buffer, &sdo_response.data, sizeof(uint32));
+            os_memcpy(&result, data, (length < sizeof(uint32)) ? length : sizeof(uint32));
+            os_memcpy(&str_buffer, &result, sizeof(uint32));
             lua_pushinteger(L, result);
 
             if (is_printable_string(str_buffer, sizeof(uint32)))
@@ -81,6 +89,7 @@ int lua_sdo_read(lua_State *L)
             break;
     }
 
+    os_free(data);
     return 2;
 }
 
@@ -127,6 +136,42 @@ int lua_sdo_write(lua_State *L)
     return 1;
 }
 
+int lua_sdo_read_file(lua_State *L)
+{
+    disp_mode_t disp_mode = SILENT;
+    sdo_state_t sdo_state;
+    int         node_id   = luaL_checkinteger(L, 1);
+    int         index     = luaL_checkinteger(L, 2);
+    int         sub_index = luaL_checkinteger(L, 3);
+    const char* filename  = luaL_checkstring(L, 4);
+
+    if (NULL == filename)
+    {
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+
+    sdo_state = sdo_read_file(
+        disp_mode,
+        (uint8)node_id,
+        (uint16)index,
+        (uint8)sub_index,
+        filename,
+        NULL);
+
+    switch (sdo_state)
+    {
+        case ABORT_TRANSFER:
+            lua_pushboolean(L, 0);
+            break;
+        default:
+            lua_pushboolean(L, 1);
+            break;
+    }
+
+    return 1;
+}
+
 int lua_sdo_write_file(lua_State *L)
 {
     can_message_t sdo_response = { 0 };
@@ -216,6 +261,163 @@ int lua_sdo_write_string(lua_State *L)
     return 1;
 }
 
+int lua_sdo_read_many(lua_State *L)
+{
+    sdo_item_t* items;
+    uint32      num_items;
+    uint32      index;
+    uint32      result;
+
+    luaL_checktype(L, 1, LUA_TTABLE);
+    num_items = (uint32)lua_rawlen(L, 1);
+
+    items = (sdo_item_t*)os_calloc(num_items + 1, sizeof(sdo_item_t));
+    if (NULL == items)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    for (index = 0; index < num_items; index += 1)
+    {
+        to_item(L, (int)index + 1, &items[index], NULL);
+    }
+
+    sdo_read_many(items, num_items);
+
+    lua_createtable(L, (int)num_items, 0);
+
+    for (index = 0; index < num_items; index += 1)
+    {
+        sdo_item_t* item = &items[index];
+
+        lua_createtable(L, 0, 3);
+        lua_pushboolean(L, (ABORT_TRANSFER != item->sdo_state) ? 1 : 0);
+        lua_setfield(L, -2, "ok");
+
+        switch (item->sdo_state)
+        {
+            case IS_READ_SEGMENTED:
+            case IS_READ_BLOCK:
+                lua_pushlstring(L, (const char *)item->data, item->length);
+                break;
+            case IS_READ_EXPEDITED:
+                result = 0;
+                os_memcpy(&result, item->data, (item->length < sizeof(uint32)) ? item->length : sizeof(uint32));
+                lua_pushinteger(L, result);
+                break;
+            default:
+            case ABORT_TRANSFER:
+                lua_pushnil(L);
+                break;
+        }
+        lua_setfield(L, -2, "value");
+
+        lua_pushinteger(L, item->abort_code);
+        lua_setfield(L, -2, "abort_code");
+        lua_rawseti(L, -2, index + 1);
+
+        os_free(item->data);
+    }
+
+    os_free(items);
+    return 1;
+}
+
+int lua_sdo_write_many(lua_State *L)
+{
+    sdo_item_t* items;
+    uint32*     values;
+    uint32      num_items;
+    uint32      index;
+
+    luaL_checktype(L, 1, LUA_TTABLE);
+    num_items = (uint32)lua_rawlen(L, 1);
+
+    items  = (sdo_item_t*)os_calloc(num_items + 1, sizeof(sdo_item_t));
+    values = (uint32*)os_calloc(num_items + 1, sizeof(uint32));
+    if ((NULL == items) || (NULL == values))
+    {
+        os_free(items);
+        os_free(values);
+        lua_pushnil(L);
+        return 1;
+    }
+
+    /* Strings stay referenced by the argument table for the whole call. */
+    for (index = 0; index < num_items; index += 1)
+    {
+        to_item(L, (int)index + 1, &items[index], &values[index]);
+    }
+
+    sdo_write_many(items, num_items);
+
+    lua_createtable(L, (int)num_items, 0);
+
+    for (index = 0; index < num_items; index += 1)
+    {
+        lua_createtable(L, 0, 2);
+        lua_pushboolean(L, (ABORT_TRANSFER != items[index].sdo_state) ? 1 : 0);
+        lua_setfield(L, -2, "ok");
+        lua_pushinteger(L, items[index].abort_code);
+        lua_setfield(L, -2, "abort_code");
+        lua_rawseti(L, -2, index + 1);
+    }
+
+    os_free(items);
+    os_free(values);
+    return 1;
+}
+
+int lua_sdo_set_timeout(lua_State *L)
+{
+    uint32 timeout_ms   = (uint32)luaL_checkinteger(L, 1);
+    uint32 prev_timeout = sdo_get_timeout();
+
+    sdo_set_timeout(timeout_ms);
+
+    lua_pushinteger(L, prev_timeout);
+    return 1;
+}
+
+int lua_sdo_set_retries(lua_State *L)
+{
+    uint32 retries      = (uint32)luaL_checkinteger(L, 1);
+    uint32 prev_retries = sdo_get_retries();
+
+    sdo_set_retries(retries);
+
+    lua_pushinteger(L, prev_retries);
+    return 1;
+}
+
+int lua_sdo_cache_enable(lua_State *L)
+{
+    bool_t is_enabled = lua_toboolean(L, 1);
+    bool_t was_enabled = sdo_cache_is_enabled();
+
+    sdo_cache_enable(is_enabled);
+
+    lua_pushboolean(L, was_enabled);
+    return 1;
+}
+
+int lua_sdo_cache_mark(lua_State *L)
+{
+    int    node_id      = luaL_checkinteger(L, 1);
+    int    index        = luaL_checkinteger(L, 2);
+    int    sub_index    = luaL_checkinteger(L, 3);
+    bool_t is_cacheable = IS_TRUE;
+
+    if (lua_gettop(L) >= 4)
+    {
+        is_cacheable = lua_toboolean(L, 4);
+    }
+
+    sdo_cache_mark((uint8)node_id, (uint16)index, (uint8)sub_index, is_cacheable);
+    return 0;
+}
+
 int lua_dict_lookup(lua_State *L)
 {
     int         index       = luaL_checkinteger(L, 1);
@@ -234,6 +436,106 @@ int lua_dict_lookup(lua_State *L)
     return 1;
 }
 
+int lua_dict_get_meta(lua_State *L)
+{
+    int         index     = luaL_checkinteger(L, 1);
+    int         sub_index = luaL_checkinteger(L, 2);
+    dict_meta_t meta;
+
+    if (IS_FALSE == dict_get_meta((uint16)index, (uint8)sub_index, &meta))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_createtable(L, 0, 7);
+
+    if (NULL != meta.name)
+    {
+        lua_pushstring(L, meta.name);
+        lua_setfield(L, -2, "name");
+    }
+
+    if (NULL != meta.access)
+    {
+        lua_pushstring(L, meta.access);
+        lua_setfield(L, -2, "access");
+    }
+
+    if (IS_TRUE == meta.is_from_eds)
+    {
+        lua_pushinteger(L, meta.data_type);
+        lua_setfield(L, -2, "data_type");
+        lua_pushinteger(L, meta.low_limit);
+        lua_setfield(L, -2, "low_limit");
+        lua_pushinteger(L, meta.high_limit);
+        lua_setfield(L, -2, "high_limit");
+        lua_pushinteger(L, meta.default_value);
+        lua_setfield(L, -2, "default_value");
+    }
+
+    lua_pushboolean(L, meta.is_from_eds);
+    lua_setfield(L, -2, "from_eds");
+
+    return 1;
+}
+
+int lua_eds_load(lua_State *L)
+{
+    const char* eds_file = luaL_checkstring(L, 1);
+
+    lua_pushboolean(L, (ALL_OK == eds_load(eds_file)) ? 1 : 0);
+    return 1;
+}
+
+static void to_item(lua_State *L, int position, sdo_item_t* item, uint32* value)
+{
+    /* Anything that isn't { node_id, index, sub_index [, length, data] }
+     * keeps node ID 0 and simply fails.
+     */
+    if (LUA_TTABLE != lua_rawgeti(L, 1, position))
+    {
+        lua_pop(L, 1);
+        return;
+    }
+
+    lua_rawgeti(L, -1, 1);
+    lua_rawgeti(L, -2, 2);
+    lua_rawgeti(L, -3, 3);
+    item->node_id   = (uint8)lua_tointeger(L, -3);
+    item->index     = (uint16)lua_tointeger(L, -2);
+    item->sub_index = (uint8)lua_tointeger(L, -1);
+    lua_pop(L, 3);
+
+    if (NULL != value)
+    {
+        lua_rawgeti(L, -1, 4);
+        lua_rawgeti(L, -2, 5);
+
+        if (LUA_TSTRING == lua_type(L, -1))
+        {
+            size_t length;
+
+            item->data   = (uint8*)lua_tolstring(L, -1, &length);
+            item->length = (uint32)length;
+        }
+        else
+        {
+            *value       = (uint32)lua_tointeger(L, -1);
+            item->data   = (uint8*)value;
+            item->length = (uint32)lua_tointeger(L, -2);
+
+            if (item->length > sizeof(uint32))
+            {
+                item->length = sizeof(uint32);
+            }
+        }
+        lua_pop(L, 2);
+    }
+
+    lua_pop(L, 1);
+}
+
 void lua_register_sdo_commands(core_t *core)
 {
     lua_pushcfunction(core->L, lua_sdo_lookup_abort_code);
@@ -242,6 +544,9 @@ void lua_register_sdo_commands(core_t *core)
     lua_pushcfunction(core->L, lua_sdo_read);
     lua_setglobal(core->L, "sdo_read");
 
+    lua_pushcfunction(core->L, lua_sdo_read_file);
+    lua_setglobal(core->L, "sdo_read_file");
+
     lua_pushcfunction(core->L, lua_sdo_write);
     lua_setglobal(core->L, "sdo_write");
 
@@ -251,6 +556,30 @@ void lua_register_sdo_commands(core_t *core)
     lua_pushcfunction(core->L, lua_sdo_write_string);
     lua_setglobal(core->L, "sdo_write_string");
 
+    lua_pushcfunction(core->L, lua_sdo_read_many);
+    lua_setglobal(core->L, "sdo_read_many");
+
+    lua_pushcfunction(core->L, lua_sdo_write_many);
+    lua_setglobal(core->L, "sdo_write_many");
+
+    lua_pushcfunction(core->L, lua_sdo_set_timeout);
+    lua_setglobal(core->L, "sdo_set_timeout");
+
+    lua_pushcfunction(core->L, lua_sdo_set_retries);
+    lua_setglobal(core->L, "sdo_set_retries");
+
+    lua_pushcfunction(core->L, lua_sdo_cache_enable);
+    lua_setglobal(core->L, "sdo_cache_enable");
+
+    lua_pushcfunction(core->L, lua_sdo_cache_mark);
+    lua_setglobal(core->L, "sdo_cache_mark");
+
     lua_pushcfunction(core->L, lua_dict_lookup);
     lua_setglobal(core->L, "dict_lookup");
+
+    lua_pushcfunction(core->L, lua_dict_get_meta);
+    lua_setglobal(core->L, "dict_get_meta");
+
+    lua_pushcfunction(core->L, lua_eds_load);
+    lua_setglobal(core->L, "eds_load");
 }
@@ -15,10 +15,19 @@
 
 int  lua_sdo_lookup_abort_code(lua_State *L);
 int  lua_sdo_read(lua_State *L);
+int  lua_sdo_read_file(lua_State *L);
 int  lua_sdo_write(lua_State *L);
 int  lua_sdo_write_file(lua_State *L);
 int  lua_sdo_write_string(lua_State *L);
+int  lua_sdo_read_many(lua_State *L);
+int  lua_sdo_write_many(lua_State *L);
+int  lua_sdo_set_timeout(lua_State *L);
+int  lua_sdo_set_retries(lua_State *L);
+int  lua_sdo_cache_enable(lua_State *L);
+int  lua_sdo_cache_mark(lua_State *L);
 int  lua_dict_lookup(lua_State *L);
+int  lua_dict_get_meta(lua_State *L);
+int  lua_eds_load(lua_State *L);
 void lua_register_sdo_commands(core_t *core);
 
 #endif /* LUA_SDO_H */
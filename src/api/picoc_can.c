@@ -9,9 +9,11 @@
 
 #include "can.h"
 #include "core.h"
+#include "dispatch.h"
 #include "interpreter.h"
 #include "os.h"
 #include "picoc_can.h"
+#include "scripts.h"
 
 static can_message_t can_msg = { 0 };
 
@@ -25,14 +27,23 @@ typedef struct can_message { \
 } can_message_t;";
 
 static void c_can_read(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
+static void c_can_read_batch(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
 static void c_can_write(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
+static void c_can_set_filter(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
+static void c_can_add_filter(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
+static void c_can_clear_filter(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
+static void to_filter(unsigned int id, unsigned int mask, can_filter_t* filter);
 static void setup(Picoc* P);
 
 struct LibraryFunction picoc_can_functions[] =
 {
-    { c_can_read,  "can_message_t* can_read(void);" },
-    { c_can_write, "int can_write(can_message_t* message, int show_output, char* comment);" },
-    { NULL,        NULL }
+    { c_can_read,         "can_message_t* can_read(void);" },
+    { c_can_read_batch,   "int can_read_batch(can_message_t* messages, int max_messages);" },
+    { c_can_write,        "int can_write(can_message_t* message, int show_output, char* comment);" },
+    { c_can_set_filter,   "int can_set_filter(unsigned int id, unsigned int mask);" },
+    { c_can_add_filter,   "int can_add_filter(unsigned int id, unsigned int mask);" },
+    { c_can_clear_filter, "int can_clear_filter(void);" },
+    { NULL,               NULL }
 };
 
 void picoc_can_init(core_t* core)
@@ -42,11 +53,7 @@ void picoc_can_init(core_t* core)
 
 static void c_can_read(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
 {
-    uint32 status;
-
-    status = can_read(&can_msg);
-
-    if (ALL_OK == status)
+    if (1 == dispatch_read(scripts_get_subscriber(), &can_msg, 1, SCRIPT_READ_TIMEOUT_MS))
     {
         return_value->Val->Pointer = (void*)&can_msg;
     }
@@ -56,6 +63,26 @@ static void c_can_read(struct ParseState* parser, struct Value* return_value, st
     }
 }
 
+static void c_can_read_batch(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
+{
+    dispatch_sub_t* sub          = scripts_get_subscriber();
+    int             max_messages = param[1]->Val->Integer;
+
+    if ((NULL == param[0]->Val->Pointer) || (max_messages <= 0))
+    {
+        return_value->Val->Integer = 0;
+        return;
+    }
+
+    if (NULL == sub)
+    {
+        return_value->Val->Integer = -1;
+        return;
+    }
+
+    return_value->Val->Integer = (int)dispatch_read(sub, (can_message_t*)param[0]->Val->Pointer, (uint32)max_messages, SCRIPT_READ_TIMEOUT_MS);
+}
+
 static void c_can_write(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
 {
     uint32      status;
@@ -78,6 +105,36 @@ static void c_can_write(struct ParseState* parser, struct Value* return_value, s
     }
 }
 
+static void c_can_set_filter(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
+{
+    can_filter_t filter;
+
+    to_filter(param[0]->Val->UnsignedInteger, param[1]->Val->UnsignedInteger, &filter);
+
+    return_value->Val->Integer = (ALL_OK == dispatch_set_filter(scripts_get_subscriber(), &filter, 1)) ? 1 : 0;
+}
+
+static void c_can_add_filter(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
+{
+    can_filter_t filter;
+
+    to_filter(param[0]->Val->UnsignedInteger, param[1]->Val->UnsignedInteger, &filter);
+
+    return_value->Val->Integer = (ALL_OK == dispatch_add_filter(scripts_get_subscriber(), &filter)) ? 1 : 0;
+}
+
+static void c_can_clear_filter(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
+{
+    return_value->Val->Integer = (ALL_OK == dispatch_set_filter(scripts_get_subscriber(), NULL, 0)) ? 1 : 0;
+}
+
+static void to_filter(unsigned int id, unsigned int mask, can_filter_t* filter)
+{
+    filter->id          = id & CAN_EFF_ID_MASK;
+    filter->is_extended = (filter->id > CAN_SFF_ID_MASK) ? IS_TRUE : IS_FALSE;
+    filter->mask        = mask;
+}
+
 static void setup(Picoc* P)
 {
     (void)P;
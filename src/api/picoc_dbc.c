@@ -13,19 +13,54 @@
 #include "os.h"
 #include "picoc_dbc.h"
 
-static const char defs[] = "";
+static const char defs[] = "                               \
+typedef enum {                                             \
+    DBC_MATCH_EXACT = 0,                                   \
+    DBC_MATCH_PREFIX,                                      \
+    DBC_MATCH_SUBSTRING                                    \
+} dbc_match_t;                                             \
+typedef struct dbc_value {                                 \
+    char*         name;                                    \
+    char*         unit;                                    \
+    unsigned long raw;                                     \
+    double        value;                                   \
+    char*         label;                                   \
+} dbc_value_t;";
 
+/* Mirrors dbc_value_t as declared for scripts above. */
+typedef struct picoc_dbc_value
+{
+    const char*   name;
+    const char*   unit;
+    unsigned long raw;
+    double        value;
+    const char*   label;
+
+} picoc_dbc_value_t;
+
+static void c_dbc_close(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
 static void c_dbc_decode(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
+static void c_dbc_decode_values(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
+static void c_dbc_encode(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
 static void c_dbc_find_id_by_name(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
+static void c_dbc_find_messages(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
 static void c_dbc_load(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
+static void c_dbc_open(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
+static void c_dbc_select_interface(struct ParseState* parser, struct Value* return_value, struct Value** param, int args);
 static void setup(Picoc* P);
 
 struct LibraryFunction picoc_dbc_functions[] =
 {
-    { c_dbc_decode,          "char* dbc_decode(int can_id, char* data);" },
-    { c_dbc_find_id_by_name, "int   dbc_find_id_by_name(int* can_id, char* search);" },
-    { c_dbc_load,            "int   dbc_load(char* filename);" },
-    { NULL,                  NULL }
+    { c_dbc_close,            "int   dbc_close(int handle);" },
+    { c_dbc_decode,           "char* dbc_decode(int can_id, char* data);" },
+    { c_dbc_decode_values,    "int   dbc_decode_values(int can_id, char* data, dbc_value_t* values, int max_values);" },
+    { c_dbc_encode,           "int   dbc_encode(int can_id, dbc_value_t* values, int num_values, char* data);" },
+    { c_dbc_find_id_by_name,  "int   dbc_find_id_by_name(int* can_id, char* search);" },
+    { c_dbc_find_messages,    "int   dbc_find_messages(char* search, int match, int* can_ids, int max_ids);" },
+    { c_dbc_load,             "int   dbc_load(char* filename);" },
+    { c_dbc_open,             "int   dbc_open(char* filename, char* interface, int first_id, int last_id);" },
+    { c_dbc_select_interface, "int   dbc_select_interface(char* interface);" },
+    { NULL,                   NULL }
 };
 
 void picoc_dbc_init(core_t* core)
@@ -33,6 +68,11 @@ void picoc_dbc_init(core_t* core)
     IncludeRegister(&core->P, "dbc.h", &setup, &picoc_dbc_functions[0], defs);
 }
 
+static void c_dbc_close(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
+{
+    return_value->Val->Integer = (ALL_OK == dbc_close((uint32)param[0]->Val->Integer)) ? 1 : 0;
+}
+
 static void c_dbc_decode(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
 {
     uint64 data = 0;
@@ -44,11 +84,85 @@ static void c_dbc_decode(struct ParseState* parser, struct Value* return_value,
     }
 
     os_memcpy(&data, param[1]->Val->Pointer, sizeof(uint64));
-    data = os_swap_64(data);
 
     return_value->Val->Pointer = (void*)dbc_decode(param[0]->Val->Integer, data);
 }
 
+static void c_dbc_decode_values(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
+{
+    static dbc_value_t values[DBC_MAX_VALUES];
+    picoc_dbc_value_t* script_values = (picoc_dbc_value_t*)param[2]->Val->Pointer;
+    int                max_values    = param[3]->Val->Integer;
+    const message_t*   message       = dbc_find_message(param[0]->Val->Integer);
+    uint64             data          = 0;
+    int                count;
+    int                i;
+
+    return_value->Val->Integer = 0;
+
+    if ((NULL == message) || (NULL == param[1]->Val->Pointer) || (NULL == script_values))
+    {
+        return;
+    }
+
+    os_memcpy(&data, param[1]->Val->Pointer, sizeof(uint64));
+
+    if (max_values > DBC_MAX_VALUES)
+    {
+        max_values = DBC_MAX_VALUES;
+    }
+
+    count = dbc_decode_values(message, data, values, max_values);
+    for (i = 0; i < count; ++i)
+    {
+        const signal_t* signal = &message->signals[values[i].signal];
+
+        script_values[i].name  = signal->name;
+        script_values[i].unit  = signal->unit;
+        script_values[i].raw   = (unsigned long)values[i].raw;
+        script_values[i].value = values[i].value;
+        script_values[i].label = values[i].label;
+    }
+
+    return_value->Val->Integer = count;
+}
+
+static void c_dbc_encode(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
+{
+    static dbc_value_t values[DBC_MAX_VALUES];
+    picoc_dbc_value_t* script_values = (picoc_dbc_value_t*)param[1]->Val->Pointer;
+    int                num_values    = param[2]->Val->Integer;
+    const message_t*   message       = dbc_find_message(param[0]->Val->Integer);
+    uint64             data          = 0;
+    int                i;
+
+    return_value->Val->Integer = 0;
+
+    if ((NULL == message) || (NULL == script_values) || (NULL == param[3]->Val->Pointer))
+    {
+        return;
+    }
+
+    if ((num_values < 0) || (num_values > DBC_MAX_VALUES))
+    {
+        return;
+    }
+
+    for (i = 0; i < num_values; ++i)
+    {
+        values[i].signal = dbc_find_signal(message, script_values[i].name);
+        values[i].value  = script_values[i].value;
+    }
+
+    os_memcpy(&data, param[3]->Val->Pointer, sizeof(uint64));
+
+    if (ALL_OK == dbc_encode(message, values, num_values, &data))
+    {
+        os_memcpy(param[3]->Val->Pointer, &data, sizeof(uint64));
+        return_value->Val->Integer = 1;
+    }
+}
+
 static void c_dbc_find_id_by_name(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
 {
     status_t status;
@@ -65,6 +179,36 @@ static void c_dbc_find_id_by_name(struct ParseState* parser, struct Value* retur
     }
 }
 
+static void c_dbc_find_messages(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
+{
+    const message_t* messages[DBC_MAX_VALUES];
+    const char*      search  = (const char*)param[0]->Val->Pointer;
+    int*             can_ids = (int*)param[2]->Val->Pointer;
+    int              max_ids = param[3]->Val->Integer;
+    int              count;
+    int              i;
+
+    return_value->Val->Integer = 0;
+
+    if ((NULL == search) || (NULL == can_ids))
+    {
+        return;
+    }
+
+    if (max_ids > DBC_MAX_VALUES)
+    {
+        max_ids = DBC_MAX_VALUES;
+    }
+
+    count = dbc_find_messages(search, (dbc_match_t)param[1]->Val->Integer, messages, max_ids);
+    for (i = 0; (i < count) && (i < max_ids); ++i)
+    {
+        can_ids[i] = (int)messages[i]->id;
+    }
+
+    return_value->Val->Integer = count;
+}
+
 static void c_dbc_load(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
 {
     status_t status;
@@ -82,6 +226,32 @@ static void c_dbc_load(struct ParseState* parser, struct Value* return_value, st
     }
 }
 
+static void c_dbc_open(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
+{
+    const char* can_interface = (const char*)param[1]->Val->Pointer;
+    uint32      handle;
+
+    return_value->Val->Integer = 0;
+
+    if (ALL_OK != dbc_open(param[0]->Val->Pointer, &handle))
+    {
+        return;
+    }
+
+    if (ALL_OK != dbc_bind(handle, can_interface, (uint32)param[2]->Val->Integer, (uint32)param[3]->Val->Integer))
+    {
+        dbc_close(handle);
+        return;
+    }
+
+    return_value->Val->Integer = (int)handle;
+}
+
+static void c_dbc_select_interface(struct ParseState* parser, struct Value* return_value, struct Value** param, int args)
+{
+    return_value->Val->Integer = (ALL_OK == dbc_select_interface(param[0]->Val->Pointer)) ? 1 : 0;
+}
+
 static void setup(Picoc* P)
 {
     (void)P;
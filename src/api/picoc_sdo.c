@@ -10,13 +10,16 @@
 #include "can.h"
 #include "core.h"
 #include "dict.h"
+#include "eds.h"
 #include "interpreter.h"
 #include "os.h"
 #include "picoc_sdo.h"
 #include "sdo.h"
+#include "sdo_cache.h"
 
 static can_message_t sdo_response  = { 0 };
 static char          str_buffer[5] = { 0 };
+static uint8*        read_buffer;
 
 extern bool_t is_printable_string(const char *str, size_t length);
 
@@ -53,24 +56,87 @@ typedef enum {                                             \
     ABORT_DATA_CANNOT_TRANSFERRED_DEV_STATE  = 0x08000022, \
     ABORT_NO_OBJECT_DICTIONARY_PRESENT       = 0x08000023, \
     ABORT_NO_DATA_AVAILABLE                  = 0x08000024  \
-} sdo_abort_code_t;";
+} sdo_abort_code_t;                                        \
+typedef struct sdo_item {                                  \
+    int          node_id;                                  \
+    int          index;                                    \
+    int          sub_index;                                \
+    int          length;                                   \
+    unsigned int value;                                    \
+    int          ok;                                       \
+    unsigned int abort_code;                               \
+} sdo_item_t;                                              \
+typedef struct dict_meta {                                 \
+    char*        name;                                     \
+    char*        access;                                   \
+    int          data_type;                                \
+    unsigned int low_limit;                                \
+    unsigned int high_limit;                               \
+    unsigned int default_value;                            \
+    int          is_from_eds;                              \
+} dict_meta_t;";
+
+/* Mirrors sdo_item_t as declared for scripts above. */
+typedef struct picoc_sdo_item
+{
+    int          node_id;
+    int          index;
+    int          sub_index;
+    int          length;
+    unsigned int value;
+    int          ok;
+    unsigned int abort_code;
+
+} picoc_sdo_item_t;
+
+/* Mirrors dict_meta_t as declared for scripts above. */
+typedef struct picoc_dict_meta
+{
+    const char*  name;
+    const char*  access;
+    int          data_type;
+    unsigned int low_limit;
+    unsigned int high_limit;
+    unsigned int default_value;
+    int          is_from_eds;
+
+} picoc_dict_meta_t;
 
 static void c_sdo_lookup_abort_code(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
 static void c_sdo_read(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
+static void c_sdo_read_file(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
 static void c_sdo_write(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
 static void c_sdo_write_file(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
 static void c_sdo_write_string(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
+static void c_sdo_read_many(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
+static void c_sdo_write_many(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
+static void c_sdo_set_timeout(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
+static void c_sdo_set_retries(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
+static void c_sdo_cache_enable(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
+static void c_sdo_cache_mark(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
 static void c_dict_lookup(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
+static void c_dict_get_meta(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
+static void c_eds_load(struct ParseState *parser, struct Value *return_value, struct Value **param, int args);
+static void run_many(struct Value *return_value, struct Value **param, bool_t is_write);
 static void setup(Picoc* P);
 
 struct LibraryFunction picoc_sdo_functions[] =
 {
     { c_sdo_lookup_abort_code, "char* sdo_lookup_abort_code(sdo_abort_code_t abort_code);" },
     { c_sdo_read,              "char* sdo_read(unsigned int* result, int node_id, int index, int sub_index, int show_output, char* comment);"},
+    { c_sdo_read_file,         "int sdo_read_file(int node_id, int index, int sub_index, char* filename);"},
     { c_sdo_write,             "int sdo_write(int node_id, int index, int sub_index, int length, char* data, int show_output, char* comment);"},
     { c_sdo_write_file,        "int sdo_write_file(int node_id, int index, int sub_index, char* filename);"},
     { c_sdo_write_string,      "int sdo_write_string(int node_id, int index, int sub_index, char* data);"},
+    { c_sdo_read_many,         "int sdo_read_many(sdo_item_t* items, int num_items);"},
+    { c_sdo_write_many,        "int sdo_write_many(sdo_item_t* items, int num_items);"},
+    { c_sdo_set_timeout,       "int sdo_set_timeout(int timeout_ms);"},
+    { c_sdo_set_retries,       "int sdo_set_retries(int retries);"},
+    { c_sdo_cache_enable,      "int sdo_cache_enable(int is_enabled);"},
+    { c_sdo_cache_mark,        "void sdo_cache_mark(int node_id, int index, int sub_index, int is_cacheable);"},
     { c_dict_lookup,           "char* dict_lookup(int index, int sub_index);"},
+    { c_dict_get_meta,         "int dict_get_meta(int index, int sub_index, dict_meta_t* meta);"},
+    { c_eds_load,              "int eds_load(char* eds_file);"},
     { NULL, NULL }
 };
 
@@ -95,6 +161,8 @@ static void c_sdo_read(struct ParseState *parser, struct Value *return_value, st
     int           sub_index   = param[3]->Val->Integer;
     int           show_output = param[4]->Val->Integer;
     const char*   comment     = (const char *)param[5]->Val->Pointer;
+    uint32        length      = 0;
+    uint32        result      = 0;
 
     limit_node_id((uint8 *)&node_id);
 
@@ -103,22 +171,30 @@ static void c_sdo_read(struct ParseState *parser, struct Value *return_value, st
         disp_mode = SCRIPT_MODE;
     }
 
-    sdo_state = sdo_read(
-        &sdo_response,
+    /* The previous result stays valid until the next read. */
+    os_free(read_buffer);
+    read_buffer = NULL;
+
+    sdo_state = sdo_read_data(
         disp_mode,
         (uint8)node_id,
         (uint16)index,
-        (uint16)sub_index,
+        (uint8)sub_index,
+        &read_buffer,
+        &length,
         comment);
 
     switch (sdo_state)
     {
         case IS_READ_SEGMENTED:
-            return_value->Val->Pointer = (void *)sdo_response.data;
+        case IS_READ_BLOCK:
+            os_memcpy(param[0]->Val->Pointer, &length, sizeof(uint32));
+            return_value->Val->Pointer = (void *)read_buffer;
             break;
         case IS_READ_EXPEDITED:
-            os_memcpy(&str_buffer, &sdo_response.data, sizeof(uint32));
-            os_memcpy(param[0]->Val->Pointer, &sdo_response.data, sizeof(uint32));
+            os_memcpy(&result, read_buffer, (length < sizeof(uint32)) ? length : sizeof(uint32));
+            os_memcpy(&str_buffer, &result, sizeof(uint32));
+            os_memcpy(param[0]->Val->Pointer, &result, sizeof(uint32));
 
             if (is_printable_string(str_buffer, sizeof(uint32)))
             {
@@ -136,6 +212,40 @@ static void c_sdo_read(struct ParseState *parser, struct Value *return_value, st
     }
 }
 
+static void c_sdo_read_file(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
+{
+    disp_mode_t disp_mode = SILENT;
+    sdo_state_t sdo_state;
+    int         node_id   = param[0]->Val->Integer;
+    int         index     = param[1]->Val->Integer;
+    int         sub_index = param[2]->Val->Integer;
+    const char* filename  = (const char*)param[3]->Val->Pointer;
+
+    if (NULL == filename)
+    {
+        return_value->Val->Integer = 0;
+        return;
+    }
+
+    sdo_state = sdo_read_file(
+        disp_mode,
+        (uint8)node_id,
+        (uint16)index,
+        (uint8)sub_index,
+        filename,
+        NULL);
+
+    switch (sdo_state)
+    {
+        case ABORT_TRANSFER:
+            return_value->Val->Integer = 0;
+            break;
+        default:
+            return_value->Val->Integer = 1;
+            break;
+    }
+}
+
 static void c_sdo_write(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
 {
     disp_mode_t disp_mode   = SILENT;
@@ -191,7 +301,7 @@ static void c_sdo_write_file(struct ParseState *parser, struct Value *return_val
     int         node_id   = param[0]->Val->Integer;
     int         index     = param[1]->Val->Integer;
     int         sub_index = param[2]->Val->Integer;
-    const char* filename  = (const char*)param[0]->Val->Pointer;
+    const char* filename  = (const char*)param[3]->Val->Pointer;
 
     if (NULL == filename)
     {
@@ -268,14 +378,165 @@ static void c_sdo_write_string(struct ParseState *parser, struct Value *return_v
     }
 }
 
+static void c_sdo_read_many(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
+{
+    run_many(return_value, param, IS_FALSE);
+}
+
+static void c_sdo_write_many(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
+{
+    run_many(return_value, param, IS_TRUE);
+}
+
+static void c_sdo_set_timeout(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
+{
+    uint32 prev_timeout = sdo_get_timeout();
+
+    sdo_set_timeout((uint32)param[0]->Val->Integer);
+
+    return_value->Val->Integer = (int)prev_timeout;
+}
+
+static void c_sdo_set_retries(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
+{
+    uint32 prev_retries = sdo_get_retries();
+
+    sdo_set_retries((uint32)param[0]->Val->Integer);
+
+    return_value->Val->Integer = (int)prev_retries;
+}
+
+static void c_sdo_cache_enable(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
+{
+    bool_t was_enabled = sdo_cache_is_enabled();
+
+    sdo_cache_enable((0 != param[0]->Val->Integer) ? IS_TRUE : IS_FALSE);
+
+    return_value->Val->Integer = (int)was_enabled;
+}
+
+static void c_sdo_cache_mark(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
+{
+    int node_id      = param[0]->Val->Integer;
+    int index        = param[1]->Val->Integer;
+    int sub_index    = param[2]->Val->Integer;
+    int is_cacheable = param[3]->Val->Integer;
+
+    sdo_cache_mark((uint8)node_id, (uint16)index, (uint8)sub_index, (0 != is_cacheable) ? IS_TRUE : IS_FALSE);
+}
+
 static void c_dict_lookup(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
 {
     int index     = param[0]->Val->Integer;
-    int sub_index = param[0]->Val->Integer;
+    int sub_index = param[1]->Val->Integer;
 
     return_value->Val->Pointer = (void*)dict_lookup(index, sub_index);
 }
 
+static void c_dict_get_meta(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
+{
+    int                index       = param[0]->Val->Integer;
+    int                sub_index   = param[1]->Val->Integer;
+    picoc_dict_meta_t* script_meta = (picoc_dict_meta_t*)param[2]->Val->Pointer;
+    dict_meta_t        meta;
+
+    return_value->Val->Integer = 0;
+
+    if ((NULL == script_meta) || (IS_FALSE == dict_get_meta((uint16)index, (uint8)sub_index, &meta)))
+    {
+        return;
+    }
+
+    script_meta->name          = meta.name;
+    script_meta->access        = meta.access;
+    script_meta->data_type     = meta.data_type;
+    script_meta->low_limit     = meta.low_limit;
+    script_meta->high_limit    = meta.high_limit;
+    script_meta->default_value = meta.default_value;
+    script_meta->is_from_eds   = meta.is_from_eds;
+
+    return_value->Val->Integer = 1;
+}
+
+static void c_eds_load(struct ParseState *parser, struct Value *return_value, struct Value **param, int args)
+{
+    const char* eds_file = (const char*)param[0]->Val->Pointer;
+
+    return_value->Val->Integer = (ALL_OK == eds_load(eds_file)) ? 1 : 0;
+}
+
+static void run_many(struct Value *return_value, struct Value **param, bool_t is_write)
+{
+    picoc_sdo_item_t* script_items = (picoc_sdo_item_t*)param[0]->Val->Pointer;
+    int               num_items    = param[1]->Val->Integer;
+    sdo_item_t*       items;
+    int               index;
+
+    return_value->Val->Integer = 0;
+
+    if ((NULL == script_items) || (num_items <= 0))
+    {
+        return;
+    }
+
+    items = (sdo_item_t*)os_calloc((size_t)num_items, sizeof(sdo_item_t));
+    if (NULL == items)
+    {
+        return;
+    }
+
+    /* Scripts only get to see four bytes of an object, so writes are
+     * limited to that and reads report the full length next to the value.
+     */
+    for (index = 0; index < num_items; index += 1)
+    {
+        items[index].node_id   = (uint8)script_items[index].node_id;
+        items[index].index     = (uint16)script_items[index].index;
+        items[index].sub_index = (uint8)script_items[index].sub_index;
+
+        if (IS_TRUE == is_write)
+        {
+            items[index].data   = (uint8*)&script_items[index].value;
+            items[index].length = (uint32)script_items[index].length;
+
+            if (items[index].length > sizeof(uint32))
+            {
+                items[index].length = sizeof(uint32);
+            }
+        }
+    }
+
+    if (IS_TRUE == is_write)
+    {
+        return_value->Val->Integer = (int)sdo_write_many(items, (uint32)num_items);
+    }
+    else
+    {
+        return_value->Val->Integer = (int)sdo_read_many(items, (uint32)num_items);
+    }
+
+    for (index = 0; index < num_items; index += 1)
+    {
+        script_items[index].ok         = (ABORT_TRANSFER != items[index].sdo_state) ? 1 : 0;
+        script_items[index].abort_code = items[index].abort_code;
+
+        if (IS_FALSE == is_write)
+        {
+            uint32 value = 0;
+
+            if (NULL != items[index].data)
+            {
+                os_memcpy(&value, items[index].data, (items[index].length < sizeof(uint32)) ? items[index].length : sizeof(uint32));
+            }
+            script_items[index].value  = value;
+            script_items[index].length = (int)items[index].length;
+            os_free(items[index].data);
+        }
+    }
+
+    os_free(items);
+}
+
 static void setup(Picoc* P)
 {
     (void)P;
@@ -9,13 +9,21 @@
 
 #include "can.h"
 #include "core.h"
+#include "dispatch.h"
 #include "os.h"
 #include "pocketpy.h"
+#include "scripts.h"
 
 typedef bool (*py_CFunction)(int argc, py_Ref argv);
 
 bool py_can_write(int argc, py_Ref argv);
 bool py_can_read(int argc, py_Ref argv);
+bool py_can_read_batch(int argc, py_Ref argv);
+bool py_can_set_filter(int argc, py_Ref argv);
+bool py_can_add_filter(int argc, py_Ref argv);
+bool py_can_clear_filter(int argc, py_Ref argv);
+
+static void to_filter(py_i64 id, py_i64 mask, can_filter_t* filter);
 
 void python_can_init(core_t *core)
 {
@@ -24,6 +32,12 @@ void python_can_init(core_t *core)
     py_bind(mod, "can_write(can_id, data_length, data=0, is_extended=False, show_output=False, comment=\"\")", py_can_write);
 
     py_bindfunc(mod, "can_read", py_can_read);
+
+    py_bind(mod, "can_read_batch(max_messages=64)", py_can_read_batch);
+    py_bind(mod, "can_set_filter(can_id, mask=-1)", py_can_set_filter);
+    py_bind(mod, "can_add_filter(can_id, mask=-1)", py_can_add_filter);
+
+    py_bindfunc(mod, "can_clear_filter", py_can_clear_filter);
 }
 
 bool py_can_write(int argc, py_Ref argv)
@@ -117,14 +131,12 @@ bool py_can_write(int argc, py_Ref argv)
 bool py_can_read(int argc, py_Ref argv)
 {
     can_message_t message = { 0 };
-    status_t      status;
     uint32        length;
     uint64        data = 0;;
 
     PY_CHECK_ARGC(0);
 
-    status = can_read(&message);
-    if (ALL_OK == status)
+    if (1 == dispatch_read(scripts_get_subscriber(), &message, 1, SCRIPT_READ_TIMEOUT_MS))
     {
         length = message.length;
 
@@ -154,3 +166,116 @@ bool py_can_read(int argc, py_Ref argv)
 
     return IS_TRUE;
 }
+
+bool py_can_read_batch(int argc, py_Ref argv)
+{
+    can_message_t   messages[CAN_BATCH_SIZE];
+    dispatch_sub_t* sub = scripts_get_subscriber();
+    uint32          max_messages;
+    uint32          num_read;
+    uint32          length;
+    uint32          index;
+    uint64          data;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    max_messages = py_toint(py_arg(0));
+
+    if (NULL == sub)
+    {
+        py_newnone(py_retval());
+        return IS_TRUE;
+    }
+
+    if (max_messages > CAN_BATCH_SIZE)
+    {
+        max_messages = CAN_BATCH_SIZE;
+    }
+
+    num_read = dispatch_read(sub, messages, max_messages, SCRIPT_READ_TIMEOUT_MS);
+
+    py_newlist(py_retval());
+
+    for (index = 0; index < num_read; index += 1)
+    {
+        length = messages[index].length;
+        data   = 0;
+
+        if (length > 8)
+        {
+            length = 8;
+        }
+
+        os_memcpy(&data, &messages[index].data, sizeof(uint64));
+
+        py_newtuple(py_r0(), 4);
+
+        py_newint(py_r1(), messages[index].id);
+        py_tuple_setitem(py_r0(), 0, py_r1());
+        py_newint(py_r1(), length);
+        py_tuple_setitem(py_r0(), 1, py_r1());
+        py_newint(py_r1(), data);
+        py_tuple_setitem(py_r0(), 2, py_r1());
+        py_newint(py_r1(), messages[index].timestamp_us);
+        py_tuple_setitem(py_r0(), 3, py_r1());
+
+        py_list_append(py_retval(), py_r0());
+    }
+
+    return IS_TRUE;
+}
+
+bool py_can_set_filter(int argc, py_Ref argv)
+{
+    can_filter_t filter;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+
+    to_filter(py_toint(py_arg(0)), py_toint(py_arg(1)), &filter);
+
+    py_newbool(py_retval(), (ALL_OK == dispatch_set_filter(scripts_get_subscriber(), &filter, 1)) ? IS_TRUE : IS_FALSE);
+
+    return IS_TRUE;
+}
+
+bool py_can_add_filter(int argc, py_Ref argv)
+{
+    can_filter_t filter;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+
+    to_filter(py_toint(py_arg(0)), py_toint(py_arg(1)), &filter);
+
+    py_newbool(py_retval(), (ALL_OK == dispatch_add_filter(scripts_get_subscriber(), &filter)) ? IS_TRUE : IS_FALSE);
+
+    return IS_TRUE;
+}
+
+bool py_can_clear_filter(int argc, py_Ref argv)
+{
+    PY_CHECK_ARGC(0);
+
+    py_newbool(py_retval(), (ALL_OK == dispatch_set_filter(scripts_get_subscriber(), NULL, 0)) ? IS_TRUE : IS_FALSE);
+
+    return IS_TRUE;
+}
+
+static void to_filter(py_i64 id, py_i64 mask, can_filter_t* filter)
+{
+    filter->id          = (uint32)id & CAN_EFF_ID_MASK;
+    filter->is_extended = (filter->id > CAN_SFF_ID_MASK) ? IS_TRUE : IS_FALSE;
+
+    if (mask < 0)
+    {
+        filter->mask = (IS_TRUE == filter->is_extended) ? CAN_EFF_ID_MASK : CAN_SFF_ID_MASK;
+    }
+    else
+    {
+        filter->mask = (uint32)mask;
+    }
+}
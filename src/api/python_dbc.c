@@ -14,18 +14,51 @@
 
 typedef bool (*py_CFunction)(int argc, py_Ref argv);
 
+typedef struct encode_context
+{
+    const message_t* message;
+    dbc_value_t      values[DBC_MAX_VALUES];
+    int              count;
+    bool_t           is_valid;
+
+} encode_context_t;
+
+bool py_dbc_close(int argc, py_Ref argv);
 bool py_dbc_decode(int argc, py_Ref argv);
+bool py_dbc_decode_values(int argc, py_Ref argv);
+bool py_dbc_encode(int argc, py_Ref argv);
 bool py_dbc_find_id_by_name(int argc, py_Ref argv);
+bool py_dbc_find_messages(int argc, py_Ref argv);
 bool py_dbc_load(int argc, py_Ref argv);
+bool py_dbc_open(int argc, py_Ref argv);
+bool py_dbc_select_interface(int argc, py_Ref argv);
+
+static bool add_signal(py_Ref key, py_Ref value, void* context);
 
 void python_dbc_init(core_t *core)
 {
     py_GlobalRef mod = py_getmodule("__main__");
 
-    py_bind(mod, "dbc_decode(can_id, data=0)", py_dbc_decode);
+    py_bind(mod, "dbc_decode(can_id, data=0)",                     py_dbc_decode);
+    py_bind(mod, "dbc_decode_values(can_id, data=0, labels=None)", py_dbc_decode_values);
+    py_bind(mod, "dbc_encode(can_id, signals, data=0)",            py_dbc_encode);
+    py_bind(mod, "dbc_find_messages(search, match=\"substring\")", py_dbc_find_messages);
+    py_bind(mod, "dbc_open(filename, interface=\"\", first_id=0, last_id=0x1FFFFFFF)", py_dbc_open);
 
-    py_bindfunc(mod, "dbc_find_id_by_name", py_dbc_find_id_by_name);
-    py_bindfunc(mod, "dbc_load",            py_dbc_load);
+    py_bindfunc(mod, "dbc_close",            py_dbc_close);
+    py_bindfunc(mod, "dbc_find_id_by_name",  py_dbc_find_id_by_name);
+    py_bindfunc(mod, "dbc_load",             py_dbc_load);
+    py_bindfunc(mod, "dbc_select_interface", py_dbc_select_interface);
+}
+
+bool py_dbc_close(int argc, py_Ref argv)
+{
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    py_newbool(py_retval(), ALL_OK == dbc_close((uint32)py_toint(py_arg(0))));
+
+    return IS_TRUE;
 }
 
 bool py_dbc_decode(int argc, py_Ref argv)
@@ -47,6 +80,100 @@ bool py_dbc_decode(int argc, py_Ref argv)
     return IS_TRUE;
 }
 
+bool py_dbc_decode_values(int argc, py_Ref argv)
+{
+    static dbc_value_t values[DBC_MAX_VALUES];
+    const message_t*   message;
+    int                count;
+    int                i;
+
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+
+    if (IS_FALSE == py_isnone(py_arg(2)))
+    {
+        PY_CHECK_ARG_TYPE(2, tp_dict);
+    }
+
+    message = dbc_find_message(py_toint(py_arg(0)));
+    if (NULL == message)
+    {
+        py_newnone(py_retval());
+        return IS_TRUE;
+    }
+
+    py_newdict(py_retval());
+
+    count = dbc_decode_values(message, py_toint(py_arg(1)), values, DBC_MAX_VALUES);
+    for (i = 0; i < count; ++i)
+    {
+        py_newfloat(py_r0(), values[i].value);
+        py_dict_setitem_by_str(py_retval(), message->signals[values[i].signal].name, py_r0());
+    }
+
+    /* A dict passed in is refilled with the labels from value tables. */
+    if (IS_FALSE == py_isnone(py_arg(2)))
+    {
+        for (i = 0; i < message->signal_count; ++i)
+        {
+            if (py_dict_delitem_by_str(py_arg(2), message->signals[i].name) < 0)
+            {
+                return IS_FALSE;
+            }
+        }
+
+        for (i = 0; i < count; ++i)
+        {
+            if (NULL != values[i].label)
+            {
+                py_newstr(py_r0(), values[i].label);
+                py_dict_setitem_by_str(py_arg(2), message->signals[values[i].signal].name, py_r0());
+            }
+        }
+    }
+
+    return IS_TRUE;
+}
+
+bool py_dbc_encode(int argc, py_Ref argv)
+{
+    static encode_context_t context;
+    uint64                  data;
+
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_dict);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+
+    context.message  = dbc_find_message(py_toint(py_arg(0)));
+    context.count    = 0;
+    context.is_valid = IS_TRUE;
+
+    if (NULL == context.message)
+    {
+        py_newnone(py_retval());
+        return IS_TRUE;
+    }
+
+    if (IS_FALSE == py_dict_apply(py_arg(1), add_signal, &context))
+    {
+        return IS_FALSE;
+    }
+
+    data = os_swap_64((uint64)py_toint(py_arg(2)));
+
+    if ((IS_FALSE == context.is_valid) || (ALL_OK != dbc_encode(context.message, context.values, context.count, &data)))
+    {
+        py_newnone(py_retval());
+        return IS_TRUE;
+    }
+
+    /* First byte in the highest eight bits, as can_write() takes it. */
+    py_newint(py_retval(), (py_i64)os_swap_64(data));
+    return IS_TRUE;
+}
+
 bool py_dbc_find_id_by_name(int argc, py_Ref argv)
 {
     const char* search;
@@ -71,6 +198,61 @@ bool py_dbc_find_id_by_name(int argc, py_Ref argv)
     return IS_TRUE;
 }
 
+bool py_dbc_find_messages(int argc, py_Ref argv)
+{
+    const char*       search;
+    const char*       match_name;
+    dbc_match_t       match = DBC_MATCH_SUBSTRING;
+    const message_t** messages;
+    int               count;
+    int               i;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+    PY_CHECK_ARG_TYPE(1, tp_str);
+
+    search     = py_tostr(py_arg(0));
+    match_name = py_tostr(py_arg(1));
+
+    if (0 == os_strcmp(match_name, "exact"))
+    {
+        match = DBC_MATCH_EXACT;
+    }
+    else if (0 == os_strcmp(match_name, "prefix"))
+    {
+        match = DBC_MATCH_PREFIX;
+    }
+
+    py_newlist(py_retval());
+
+    count = dbc_find_messages(search, match, NULL, 0);
+    if (0 == count)
+    {
+        return IS_TRUE;
+    }
+
+    messages = os_calloc((size_t)count, sizeof(message_t*));
+    if (NULL == messages)
+    {
+        return IS_TRUE;
+    }
+
+    dbc_find_messages(search, match, messages, count);
+    for (i = 0; i < count; ++i)
+    {
+        py_newtuple(py_r0(), 2);
+        py_newint(py_r1(), messages[i]->id);
+        py_tuple_setitem(py_r0(), 0, py_r1());
+        py_newstr(py_r1(), messages[i]->name);
+        py_tuple_setitem(py_r0(), 1, py_r1());
+
+        py_list_append(py_retval(), py_r0());
+    }
+
+    os_free((void*)messages);
+    return IS_TRUE;
+}
+
 bool py_dbc_load(int argc, py_Ref argv)
 {
     const char* filename;
@@ -94,3 +276,69 @@ bool py_dbc_load(int argc, py_Ref argv)
 
     return IS_TRUE;
 }
+
+bool py_dbc_open(int argc, py_Ref argv)
+{
+    uint32 handle;
+
+    PY_CHECK_ARGC(4);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+    PY_CHECK_ARG_TYPE(1, tp_str);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(3, tp_int);
+
+    if (ALL_OK != dbc_open(py_tostr(py_arg(0)), &handle))
+    {
+        py_newnone(py_retval());
+        return IS_TRUE;
+    }
+
+    if (ALL_OK != dbc_bind(handle, py_tostr(py_arg(1)), (uint32)py_toint(py_arg(2)), (uint32)py_toint(py_arg(3))))
+    {
+        dbc_close(handle);
+        py_newnone(py_retval());
+        return IS_TRUE;
+    }
+
+    py_newint(py_retval(), handle);
+    return IS_TRUE;
+}
+
+bool py_dbc_select_interface(int argc, py_Ref argv)
+{
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+
+    py_newbool(py_retval(), ALL_OK == dbc_select_interface(py_tostr(py_arg(0))));
+
+    return IS_TRUE;
+}
+
+static bool add_signal(py_Ref key, py_Ref value, void* context)
+{
+    encode_context_t* encode = (encode_context_t*)context;
+    int               signal = -1;
+    py_f64            physical;
+
+    if (IS_FALSE == py_castfloat(value, &physical))
+    {
+        return IS_FALSE;
+    }
+
+    if (IS_TRUE == py_istype(key, tp_str))
+    {
+        signal = dbc_find_signal(encode->message, py_tostr(key));
+    }
+
+    if ((signal < 0) || (DBC_MAX_VALUES == encode->count))
+    {
+        encode->is_valid = IS_FALSE;
+        return IS_TRUE;
+    }
+
+    encode->values[encode->count].signal = signal;
+    encode->values[encode->count].value  = physical;
+    encode->count                       += 1;
+
+    return IS_TRUE;
+}
@@ -9,9 +9,11 @@
 
 #include "core.h"
 #include "dict.h"
+#include "eds.h"
 #include "os.h"
 #include "pocketpy.h"
 #include "sdo.h"
+#include "sdo_cache.h"
 
 typedef bool (*py_CFunction)(int argc, py_Ref argv);
 
@@ -19,10 +21,22 @@ extern bool_t is_printable_string(const char* str, size_t length);
 
 bool py_sdo_lookup_abort_code(int argc, py_Ref argv);
 bool py_sdo_read(int argc, py_Ref argv);
+bool py_sdo_read_file(int argc, py_Ref argv);
 bool py_sdo_write(int argc, py_Ref argv);
 bool py_sdo_write_file(int argc, py_Ref argv);
 bool py_sdo_write_string(int argc, py_Ref argv);
+bool py_sdo_read_many(int argc, py_Ref argv);
+bool py_sdo_write_many(int argc, py_Ref argv);
+bool py_sdo_set_timeout(int argc, py_Ref argv);
+bool py_sdo_set_retries(int argc, py_Ref argv);
+bool py_sdo_cache_enable(int argc, py_Ref argv);
+bool py_sdo_cache_mark(int argc, py_Ref argv);
 bool py_dict_lookup(int argc, py_Ref argv);
+bool py_dict_get_meta(int argc, py_Ref argv);
+bool py_eds_load(int argc, py_Ref argv);
+
+static void   to_item(py_Ref object, sdo_item_t* item, uint32* value);
+static py_Ref get_field(py_Ref object, int position);
 
 void python_sdo_init(core_t *core)
 {
@@ -33,8 +47,17 @@ void python_sdo_init(core_t *core)
     py_bind(mod, "sdo_write_string(node_id, index, sub_index, data=\"\", show_output=False, comment=\"\")", py_sdo_write_string);
 
     py_bindfunc(mod, "sdo_lookup_abort_code", py_sdo_lookup_abort_code);
+    py_bindfunc(mod, "sdo_read_file",         py_sdo_read_file);
     py_bindfunc(mod, "sdo_write_file",        py_sdo_write_file);
+    py_bindfunc(mod, "sdo_read_many",         py_sdo_read_many);
+    py_bindfunc(mod, "sdo_write_many",        py_sdo_write_many);
+    py_bindfunc(mod, "sdo_set_timeout",       py_sdo_set_timeout);
+    py_bindfunc(mod, "sdo_set_retries",       py_sdo_set_retries);
+    py_bindfunc(mod, "sdo_cache_enable",      py_sdo_cache_enable);
+    py_bindfunc(mod, "sdo_cache_mark",        py_sdo_cache_mark);
     py_bindfunc(mod, "dict_lookup",           py_dict_lookup);
+    py_bindfunc(mod, "dict_get_meta",         py_dict_get_meta);
+    py_bindfunc(mod, "eds_load",              py_eds_load);
 }
 
 bool py_sdo_lookup_abort_code(int argc, py_Ref argv)
@@ -55,7 +78,6 @@ bool py_sdo_lookup_abort_code(int argc, py_Ref argv)
 
 bool py_sdo_read(int argc, py_Ref argv)
 {
-    can_message_t sdo_response  = { 0 };
     disp_mode_t   disp_mode     = SILENT;
     sdo_state_t   sdo_state;
     int           node_id;
@@ -63,7 +85,9 @@ bool py_sdo_read(int argc, py_Ref argv)
     int           sub_index;
     bool_t        show_output;
     const char*   comment;
-    uint32        result;
+    uint8*        data          = NULL;
+    uint32        length        = 0;
+    uint32        result        = 0;
 
     PY_CHECK_ARGC(5);
     PY_CHECK_ARG_TYPE(0, tp_int);
@@ -85,21 +109,32 @@ bool py_sdo_read(int argc, py_Ref argv)
         disp_mode = SCRIPT_MODE;
     }
 
-    sdo_state = sdo_read(
-        &sdo_response,
+    sdo_state = sdo_read_data(
         disp_mode,
         (uint8)node_id,
         (uint16)index,
-        (uint16)sub_index,
+        (uint8)sub_index,
+        &data,
+        &length,
         comment);
 
     switch (sdo_state)
     {
         case IS_READ_SEGMENTED:
-            py_newstr(py_retval(), (const char*)sdo_response.data);
+        case IS_READ_BLOCK:
+            /* Text stays a str, anything else is handed over as bytes. */
+            if (IS_TRUE == is_printable_string((const char*)data, length))
+            {
+                py_newstrn(py_retval(), (const char*)data, (int)length);
+            }
+            else
+            {
+                unsigned char* bytes = py_newbytes(py_retval(), (int)length);
+                os_memcpy(bytes, data, length);
+            }
             break;
         case IS_READ_EXPEDITED:
-            os_memcpy(&result, &sdo_response.data, sizeof(uint32));
+            os_memcpy(&result, data, (length < sizeof(uint32)) ? length : sizeof(uint32));
             py_newint(py_retval(), result);
             break;
         default:
@@ -108,6 +143,7 @@ bool py_sdo_read(int argc, py_Ref argv)
             break;
     }
 
+    os_free(data);
     return IS_TRUE;
 }
 
@@ -171,6 +207,53 @@ bool py_sdo_write(int argc, py_Ref argv)
     return IS_TRUE;
 }
 
+bool py_sdo_read_file(int argc, py_Ref argv)
+{
+    disp_mode_t disp_mode = SILENT;
+    sdo_state_t sdo_state;
+    int         node_id;
+    int         index;
+    int         sub_index;
+    const char* filename;
+
+    PY_CHECK_ARGC(4);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(3, tp_str);
+
+    node_id   = py_toint(py_arg(0));
+    index     = py_toint(py_arg(1));
+    sub_index = py_toint(py_arg(2));
+    filename  = py_tostr(py_arg(3));
+
+    if (NULL == filename)
+    {
+        py_newbool(py_retval(), IS_FALSE);
+        return IS_TRUE;
+    }
+
+    sdo_state = sdo_read_file(
+        disp_mode,
+        (uint8)node_id,
+        (uint16)index,
+        (uint8)sub_index,
+        filename,
+        NULL);
+
+    switch (sdo_state)
+    {
+        case ABORT_TRANSFER:
+            py_newbool(py_retval(), IS_FALSE);
+            break;
+        default:
+            py_newbool(py_retval(), IS_TRUE);
+            break;
+    }
+
+    return IS_TRUE;
+}
+
 bool py_sdo_write_file(int argc, py_Ref argv)
 {
     can_message_t sdo_response = { 0 };
@@ -286,6 +369,199 @@ bool py_sdo_write_string(int argc, py_Ref argv)
     return IS_TRUE;
 }
 
+bool py_sdo_read_many(int argc, py_Ref argv)
+{
+    sdo_item_t* items;
+    uint32      num_items;
+    uint32      index;
+    uint32      result;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_list);
+
+    num_items = (uint32)py_list_len(py_arg(0));
+
+    items = (sdo_item_t*)os_calloc(num_items + 1, sizeof(sdo_item_t));
+    if (NULL == items)
+    {
+        py_newnone(py_retval());
+        return IS_TRUE;
+    }
+
+    for (index = 0; index < num_items; index += 1)
+    {
+        to_item(py_list_getitem(py_arg(0), (int)index), &items[index], NULL);
+    }
+
+    sdo_read_many(items, num_items);
+
+    py_newlist(py_retval());
+
+    for (index = 0; index < num_items; index += 1)
+    {
+        sdo_item_t* item = &items[index];
+
+        py_newtuple(py_r0(), 3);
+
+        py_newbool(py_r1(), ABORT_TRANSFER != item->sdo_state);
+        py_tuple_setitem(py_r0(), 0, py_r1());
+
+        switch (item->sdo_state)
+        {
+            case IS_READ_SEGMENTED:
+            case IS_READ_BLOCK:
+                if (IS_TRUE == is_printable_string((const char*)item->data, item->length))
+                {
+                    py_newstrn(py_r1(), (const char*)item->data, (int)item->length);
+                }
+                else
+                {
+                    unsigned char* bytes = py_newbytes(py_r1(), (int)item->length);
+                    os_memcpy(bytes, item->data, item->length);
+                }
+                break;
+            case IS_READ_EXPEDITED:
+                result = 0;
+                os_memcpy(&result, item->data, (item->length < sizeof(uint32)) ? item->length : sizeof(uint32));
+                py_newint(py_r1(), result);
+                break;
+            default:
+            case ABORT_TRANSFER:
+                py_newnone(py_r1());
+                break;
+        }
+        py_tuple_setitem(py_r0(), 1, py_r1());
+
+        py_newint(py_r1(), item->abort_code);
+        py_tuple_setitem(py_r0(), 2, py_r1());
+
+        py_list_append(py_retval(), py_r0());
+
+        os_free(item->data);
+    }
+
+    os_free(items);
+    return IS_TRUE;
+}
+
+bool py_sdo_write_many(int argc, py_Ref argv)
+{
+    sdo_item_t* items;
+    uint32*     values;
+    uint32      num_items;
+    uint32      index;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_list);
+
+    num_items = (uint32)py_list_len(py_arg(0));
+
+    items  = (sdo_item_t*)os_calloc(num_items + 1, sizeof(sdo_item_t));
+    values = (uint32*)os_calloc(num_items + 1, sizeof(uint32));
+    if ((NULL == items) || (NULL == values))
+    {
+        os_free(items);
+        os_free(values);
+        py_newnone(py_retval());
+        return IS_TRUE;
+    }
+
+    /* Strings and bytes stay referenced by the argument list. */
+    for (index = 0; index < num_items; index += 1)
+    {
+        to_item(py_list_getitem(py_arg(0), (int)index), &items[index], &values[index]);
+    }
+
+    sdo_write_many(items, num_items);
+
+    py_newlist(py_retval());
+
+    for (index = 0; index < num_items; index += 1)
+    {
+        py_newtuple(py_r0(), 2);
+
+        py_newbool(py_r1(), ABORT_TRANSFER != items[index].sdo_state);
+        py_tuple_setitem(py_r0(), 0, py_r1());
+        py_newint(py_r1(), items[index].abort_code);
+        py_tuple_setitem(py_r0(), 1, py_r1());
+
+        py_list_append(py_retval(), py_r0());
+    }
+
+    os_free(items);
+    os_free(values);
+    return IS_TRUE;
+}
+
+bool py_sdo_set_timeout(int argc, py_Ref argv)
+{
+    uint32 timeout_ms;
+    uint32 prev_timeout = sdo_get_timeout();
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    timeout_ms = (uint32)py_toint(py_arg(0));
+    sdo_set_timeout(timeout_ms);
+
+    py_newint(py_retval(), prev_timeout);
+
+    return IS_TRUE;
+}
+
+bool py_sdo_set_retries(int argc, py_Ref argv)
+{
+    uint32 retries;
+    uint32 prev_retries = sdo_get_retries();
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    retries = (uint32)py_toint(py_arg(0));
+    sdo_set_retries(retries);
+
+    py_newint(py_retval(), prev_retries);
+
+    return IS_TRUE;
+}
+
+bool py_sdo_cache_enable(int argc, py_Ref argv)
+{
+    bool_t was_enabled = sdo_cache_is_enabled();
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_bool);
+
+    sdo_cache_enable(py_tobool(py_arg(0)) ? IS_TRUE : IS_FALSE);
+
+    py_newbool(py_retval(), was_enabled);
+
+    return IS_TRUE;
+}
+
+bool py_sdo_cache_mark(int argc, py_Ref argv)
+{
+    int node_id;
+    int index;
+    int sub_index;
+
+    PY_CHECK_ARGC(4);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(3, tp_bool);
+
+    node_id   = py_toint(py_arg(0));
+    index     = py_toint(py_arg(1));
+    sub_index = py_toint(py_arg(2));
+
+    sdo_cache_mark((uint8)node_id, (uint16)index, (uint8)sub_index, py_tobool(py_arg(3)) ? IS_TRUE : IS_FALSE);
+
+    py_newnone(py_retval());
+
+    return IS_TRUE;
+}
+
 bool py_dict_lookup(int argc, py_Ref argv)
 {
     int         index;
@@ -311,3 +587,140 @@ bool py_dict_lookup(int argc, py_Ref argv)
 
     return IS_TRUE;
 }
+
+bool py_dict_get_meta(int argc, py_Ref argv)
+{
+    dict_meta_t meta;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+
+    if (IS_FALSE == dict_get_meta((uint16)py_toint(py_arg(0)), (uint8)py_toint(py_arg(1)), &meta))
+    {
+        py_newnone(py_retval());
+        return IS_TRUE;
+    }
+
+    py_newdict(py_retval());
+
+    if (NULL != meta.name)
+    {
+        py_newstr(py_r0(), meta.name);
+        py_dict_setitem_by_str(py_retval(), "name", py_r0());
+    }
+
+    if (NULL != meta.access)
+    {
+        py_newstr(py_r0(), meta.access);
+        py_dict_setitem_by_str(py_retval(), "access", py_r0());
+    }
+
+    if (IS_TRUE == meta.is_from_eds)
+    {
+        py_newint(py_r0(), meta.data_type);
+        py_dict_setitem_by_str(py_retval(), "data_type", py_r0());
+        py_newint(py_r0(), meta.low_limit);
+        py_dict_setitem_by_str(py_retval(), "low_limit", py_r0());
+        py_newint(py_r0(), meta.high_limit);
+        py_dict_setitem_by_str(py_retval(), "high_limit", py_r0());
+        py_newint(py_r0(), meta.default_value);
+        py_dict_setitem_by_str(py_retval(), "default_value", py_r0());
+    }
+
+    py_newbool(py_r0(), meta.is_from_eds);
+    py_dict_setitem_by_str(py_retval(), "from_eds", py_r0());
+
+    return IS_TRUE;
+}
+
+bool py_eds_load(int argc, py_Ref argv)
+{
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+
+    py_newbool(py_retval(), ALL_OK == eds_load(py_tostr(py_arg(0))));
+
+    return IS_TRUE;
+}
+
+static void to_item(py_Ref object, sdo_item_t* item, uint32* value)
+{
+    py_Ref field;
+    int    position;
+    int    numbers[3] = { 0 };
+
+    /* Anything that isn't (node_id, index, sub_index [, length, data])
+     * keeps node ID 0 and simply fails.
+     */
+    for (position = 0; position < 3; position += 1)
+    {
+        field = get_field(object, position);
+        if ((NULL == field) || (IS_FALSE == py_istype(field, tp_int)))
+        {
+            return;
+        }
+        numbers[position] = (int)py_toint(field);
+    }
+
+    item->node_id   = (uint8)numbers[0];
+    item->index     = (uint16)numbers[1];
+    item->sub_index = (uint8)numbers[2];
+
+    if (NULL == value)
+    {
+        return;
+    }
+
+    field = get_field(object, 4);
+    if (NULL == field)
+    {
+        return;
+    }
+
+    if (IS_TRUE == py_istype(field, tp_str))
+    {
+        int length;
+
+        item->data   = (uint8*)py_tostrn(field, &length);
+        item->length = (uint32)length;
+    }
+    else if (IS_TRUE == py_istype(field, tp_bytes))
+    {
+        int length;
+
+        item->data   = (uint8*)py_tobytes(field, &length);
+        item->length = (uint32)length;
+    }
+    else if (IS_TRUE == py_istype(field, tp_int))
+    {
+        *value       = (uint32)py_toint(field);
+        item->data   = (uint8*)value;
+        item->length = 0;
+
+        field = get_field(object, 3);
+        if ((NULL != field) && (IS_TRUE == py_istype(field, tp_int)))
+        {
+            item->length = (uint32)py_toint(field);
+        }
+
+        if (item->length > sizeof(uint32))
+        {
+            item->length = sizeof(uint32);
+        }
+    }
+}
+
+static py_Ref get_field(py_Ref object, int position)
+{
+    if (IS_TRUE == py_istype(object, tp_tuple))
+    {
+        return (position < py_tuple_len(object)) ? py_tuple_getitem(object, position) : NULL;
+    }
+    else if (IS_TRUE == py_istype(object, tp_list))
+    {
+        return (position < py_list_len(object)) ? py_list_getitem(object, position) : NULL;
+    }
+
+    return NULL;
+}
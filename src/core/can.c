@@ -11,6 +11,46 @@
 #include "core.h"
 #include "os.h"
 
+static can_tx_pacing_t tx_pacing = CAN_TX_PACING_BACKOFF;
+static uint32          tx_gap_us = 0;
+
+void can_set_tx_pacing(can_tx_pacing_t pacing, uint32 gap_us)
+{
+    tx_pacing = pacing;
+    tx_gap_us = gap_us;
+
+    if ((CAN_TX_PACING_FIXED_GAP == tx_pacing) && (0 == tx_gap_us))
+    {
+        tx_pacing = CAN_TX_PACING_NONE;
+    }
+}
+
+can_tx_pacing_t can_get_tx_pacing(uint32* gap_us)
+{
+    if (NULL != gap_us)
+    {
+        *gap_us = tx_gap_us;
+    }
+
+    return tx_pacing;
+}
+
+void can_tx_backoff(uint32* backoff_us)
+{
+    if (*backoff_us < CAN_BACKOFF_MIN_US)
+    {
+        *backoff_us = CAN_BACKOFF_MIN_US;
+    }
+
+    os_delay_us(*backoff_us);
+
+    *backoff_us *= 2;
+    if (*backoff_us > CAN_BACKOFF_MAX_US)
+    {
+        *backoff_us = CAN_BACKOFF_MAX_US;
+    }
+}
+
 void limit_node_id(uint8* node_id)
 {
     if (*node_id > 0x7f)
@@ -14,7 +14,22 @@
 #include "core.h"
 #include "os.h"
 
-#define CAN_BUF_SIZE 0xff
+#define CAN_BUF_SIZE            0xff
+#define CAN_BATCH_SIZE          64
+#define CAN_BACKOFF_MIN_US      50
+#define CAN_BACKOFF_MAX_US      5000
+#define CAN_BACKOFF_MAX_RETRIES 32
+#define CAN_MAX_FILTERS         32
+#define CAN_SFF_ID_MASK         0x000007ff
+#define CAN_EFF_ID_MASK         0x1fffffff
+
+typedef enum can_tx_pacing
+{
+    CAN_TX_PACING_NONE = 0,
+    CAN_TX_PACING_FIXED_GAP,
+    CAN_TX_PACING_BACKOFF
+
+} can_tx_pacing_t;
 
 typedef struct can_message
 {
@@ -26,18 +41,37 @@ typedef struct can_message
 
 } can_message_t;
 
-status_t    can_init(core_t* core);
-void        can_deinit(core_t* core);
-const char* can_get_error_message(uint32 can_status);
-void        can_quit(core_t* core);
-uint32      can_write(can_message_t* message, disp_mode_t disp_mode, const char* comment);
-uint32      can_read(can_message_t* message);
-status_t    can_print_baud_rate_help(core_t* core);
-status_t    can_print_channel_help(core_t* core);
-void        can_print_error(uint32 can_id, const char* reason, disp_mode_t disp_mode);
-void        can_set_baud_rate(uint8 baud_rate_index, core_t* core);
-void        can_set_channel(uint32 channel, core_t* core);
-void        limit_node_id(uint8* node_id);
-bool_t      is_can_initialised(core_t* core);
+typedef struct can_id_filter
+{
+    uint32 id;
+    uint32 mask;
+    bool_t is_extended;
+
+} can_filter_t;
+
+status_t        can_init(core_t* core);
+void            can_deinit(core_t* core);
+const char*     can_get_error_message(uint32 can_status);
+void            can_quit(core_t* core);
+uint32          can_write(can_message_t* message, disp_mode_t disp_mode, const char* comment);
+uint32          can_write_batch(can_message_t* messages, uint32 num_messages, uint32* num_written);
+uint32          can_read(can_message_t* message);
+uint32          can_read_batch(can_message_t* messages, uint32 max_messages, uint32* num_read);
+status_t        can_poll(uint32 timeout_ms);
+status_t        can_print_baud_rate_help(core_t* core);
+status_t        can_print_channel_help(core_t* core);
+void            can_print_error(uint32 can_id, const char* reason, disp_mode_t disp_mode);
+void            can_set_baud_rate(uint8 baud_rate_index, core_t* core);
+void            can_set_channel(uint32 channel, core_t* core);
+void            can_set_tx_pacing(can_tx_pacing_t pacing, uint32 gap_us);
+uint32          can_set_filter(const can_filter_t* filters, uint32 num_filters);
+uint32          can_add_filter(const can_filter_t* filter);
+uint32          can_clear_filter(void);
+uint32          can_get_filter(can_filter_t* filters, uint32 max_filters, uint32* num_filters);
+uint32          can_set_error_filter(uint32 error_mask);
+can_tx_pacing_t can_get_tx_pacing(uint32* gap_us);
+void            can_tx_backoff(uint32* backoff_us);
+void            limit_node_id(uint8* node_id);
+bool_t          is_can_initialised(core_t* core);
 
 #endif /* CAN_H */
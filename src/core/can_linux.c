@@ -7,6 +7,8 @@
  *
  **/
 
+#define _GNU_SOURCE
+
 #include <errno.h>
 #include <fcntl.h>
 #include <libsocketcan.h>
@@ -15,6 +17,7 @@
 #include <linux/rtnetlink.h>
 #include <linux/sockios.h>
 #include <net/if.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -28,9 +31,15 @@
 
 #define BUFFER_SIZE 8192
 
-static int can_socket;
+static int          can_socket;
+static can_filter_t rx_filters[CAN_MAX_FILTERS];
+static uint32       num_rx_filters = 0;
+static uint32       rx_error_mask  = 0;
 
 static int    can_monitor(void* core);
+static void   message_to_frame(can_message_t* message, struct can_frame* frame);
+static void   frame_to_message(struct can_frame* frame, struct msghdr* msg, can_message_t* message);
+static uint32 apply_filters(void);
 static void   parse_rtattr(struct rtattr* tb[], int max, struct rtattr* rta, int len);
 static char** get_can_interfaces(int* count);
 
@@ -174,6 +183,62 @@ void can_set_channel(uint32 channel, core_t* core)
     os_free(can_interfaces);
 }
 
+uint32 can_set_filter(const can_filter_t* filters, uint32 num_filters)
+{
+    if ((num_filters > CAN_MAX_FILTERS) || ((num_filters > 0) && (NULL == filters)))
+    {
+        return EINVAL;
+    }
+
+    if (num_filters > 0)
+    {
+        os_memcpy(rx_filters, filters, num_filters * sizeof(can_filter_t));
+    }
+    num_rx_filters = num_filters;
+
+    return apply_filters();
+}
+
+uint32 can_add_filter(const can_filter_t* filter)
+{
+    if ((NULL == filter) || (num_rx_filters >= CAN_MAX_FILTERS))
+    {
+        return EINVAL;
+    }
+
+    os_memcpy(&rx_filters[num_rx_filters], filter, sizeof(can_filter_t));
+    num_rx_filters += 1;
+
+    return apply_filters();
+}
+
+uint32 can_clear_filter(void)
+{
+    num_rx_filters = 0;
+
+    return apply_filters();
+}
+
+uint32 can_get_filter(can_filter_t* filters, uint32 max_filters, uint32* num_filters)
+{
+    if ((NULL == filters) || (NULL == num_filters) || (max_filters < num_rx_filters))
+    {
+        return EINVAL;
+    }
+
+    os_memcpy(filters, rx_filters, num_rx_filters * sizeof(can_filter_t));
+    *num_filters = num_rx_filters;
+
+    return 0;
+}
+
+uint32 can_set_error_filter(uint32 error_mask)
+{
+    rx_error_mask = error_mask & CAN_ERR_MASK;
+
+    return apply_filters();
+}
+
 void can_quit(core_t* core)
 {
     if (NULL == core)
@@ -191,42 +256,126 @@ void can_quit(core_t* core)
 
 uint32 can_write(can_message_t* message, disp_mode_t disp_mode, const char* comment)
 {
-    int              index;
     struct can_frame frame;
     long             num_bytes;
+    uint32           gap_us;
+    uint32           backoff_us = 0;
+    int              retries    = 0;
+    can_tx_pacing_t  pacing     = can_get_tx_pacing(&gap_us);
 
-    frame.can_id   = message->id;
-    frame.can_dlc  = message->length;
-    frame.can_id  |= message->is_extended ? CAN_EFF_FLAG : 0;
+    message_to_frame(message, &frame);
 
-    for (index = 0; index < 8; index += 1)
+    while (1)
     {
-        frame.data[index] = message->data[index];
-    }
+        num_bytes = write(can_socket, &frame, sizeof(frame));
 
-    num_bytes = write(can_socket, &frame, sizeof(frame));
+        /* The TX queue is full, give the controller time to drain it. */
+        if ((-1 == num_bytes) && (ENOBUFS == errno) && (CAN_TX_PACING_BACKOFF == pacing) && (retries < CAN_BACKOFF_MAX_RETRIES))
+        {
+            can_tx_backoff(&backoff_us);
+            retries += 1;
+            continue;
+        }
 
-    os_delay(1);
+        break;
+    }
 
     if (-1 == num_bytes)
     {
         return errno;
     }
-    else
+
+    if (CAN_TX_PACING_FIXED_GAP == pacing)
+    {
+        os_delay_us(gap_us);
+    }
+
+    return 0;
+}
+
+uint32 can_write_batch(can_message_t* messages, uint32 num_messages, uint32* num_written)
+{
+    struct can_frame frames[CAN_BATCH_SIZE];
+    struct mmsghdr   msgs[CAN_BATCH_SIZE];
+    struct iovec     iovs[CAN_BATCH_SIZE];
+    uint32           gap_us;
+    uint32           backoff_us = 0;
+    uint32           chunk;
+    uint32           index;
+    int              retries    = 0;
+    int              count;
+    can_tx_pacing_t  pacing     = can_get_tx_pacing(&gap_us);
+
+    if ((NULL == messages) || (NULL == num_written))
+    {
+        return EINVAL;
+    }
+
+    *num_written = 0;
+
+    /* A fixed inter-frame gap rules out handing whole bursts to the kernel. */
+    if (CAN_TX_PACING_FIXED_GAP == pacing)
     {
+        for (index = 0; index < num_messages; index += 1)
+        {
+            uint32 status = can_write(&messages[index], SILENT, NULL);
+            if (0 != status)
+            {
+                return status;
+            }
+            *num_written += 1;
+        }
         return 0;
     }
+
+    while (*num_written < num_messages)
+    {
+        chunk = num_messages - *num_written;
+        if (chunk > CAN_BATCH_SIZE)
+        {
+            chunk = CAN_BATCH_SIZE;
+        }
+
+        os_memset(msgs, 0, sizeof(msgs));
+
+        for (index = 0; index < chunk; index += 1)
+        {
+            message_to_frame(&messages[*num_written + index], &frames[index]);
+
+            iovs[index].iov_base = &frames[index];
+            iovs[index].iov_len  = sizeof(struct can_frame);
+
+            msgs[index].msg_hdr.msg_iov    = &iovs[index];
+            msgs[index].msg_hdr.msg_iovlen = 1;
+        }
+
+        count = sendmmsg(can_socket, msgs, chunk, 0);
+        if (count < 0)
+        {
+            if ((ENOBUFS == errno) && (CAN_TX_PACING_BACKOFF == pacing) && (retries < CAN_BACKOFF_MAX_RETRIES))
+            {
+                can_tx_backoff(&backoff_us);
+                retries += 1;
+                continue;
+            }
+
+            return errno;
+        }
+
+        *num_written += (uint32)count;
+        backoff_us    = 0;
+        retries       = 0;
+    }
+
+    return 0;
 }
 
 uint32 can_read(can_message_t* message)
 {
-    int              index;
     struct can_frame frame;
     struct msghdr    msg;
     struct iovec     iov;
     char             ctrlmsg[CMSG_SPACE(sizeof(struct timeval))];
-    struct cmsghdr*  cmsg;
-    struct timeval*  tv;
     int              nbytes;
 
     iov.iov_base = &frame;
@@ -246,28 +395,110 @@ uint32 can_read(can_message_t* message)
         return nbytes;
     }
 
-    message->id          = frame.can_id;
-    message->length      = frame.can_dlc;
-    message->is_extended = frame.can_id & CAN_EFF_FLAG;
+    frame_to_message(&frame, &msg, message);
 
-    for (index = 0; index < 8; index += 1)
+    return 0;
+}
+
+uint32 can_read_batch(can_message_t* messages, uint32 max_messages, uint32* num_read)
+{
+    struct can_frame frames[CAN_BATCH_SIZE];
+    struct mmsghdr   msgs[CAN_BATCH_SIZE];
+    struct iovec     iovs[CAN_BATCH_SIZE];
+    char             ctrlmsgs[CAN_BATCH_SIZE][CMSG_SPACE(sizeof(struct timeval))];
+    int              count;
+    int              index;
+
+    if ((NULL == messages) || (NULL == num_read))
     {
-        message->data[index] = frame.data[index];
+        return EINVAL;
     }
 
-    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    *num_read = 0;
+
+    if (0 == max_messages)
     {
-        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMP)
-        {
-            tv = (struct timeval*)CMSG_DATA(cmsg);
-            message->timestamp_us = tv->tv_sec * 1000000ULL + tv->tv_usec;
-            break;
-        }
+        return 0;
+    }
+    else if (max_messages > CAN_BATCH_SIZE)
+    {
+        max_messages = CAN_BATCH_SIZE;
     }
 
+    os_memset(msgs, 0, sizeof(msgs));
+
+    for (index = 0; index < (int)max_messages; index += 1)
+    {
+        iovs[index].iov_base = &frames[index];
+        iovs[index].iov_len  = sizeof(struct can_frame);
+
+        msgs[index].msg_hdr.msg_iov        = &iovs[index];
+        msgs[index].msg_hdr.msg_iovlen     = 1;
+        msgs[index].msg_hdr.msg_control    = ctrlmsgs[index];
+        msgs[index].msg_hdr.msg_controllen = sizeof(ctrlmsgs[index]);
+    }
+
+    /* Block until at least one frame is available, then drain whatever
+     * else is already queued without waiting any further.
+     */
+    count = recvmmsg(can_socket, msgs, max_messages, MSG_WAITFORONE, NULL);
+    if (count < 0)
+    {
+        return errno;
+    }
+
+    for (index = 0; index < count; index += 1)
+    {
+        frame_to_message(&frames[index], &msgs[index].msg_hdr, &messages[index]);
+    }
+
+    *num_read = (uint32)count;
+
     return 0;
 }
 
+status_t can_poll(uint32 timeout_ms)
+{
+    struct pollfd pfd;
+    uint64        deadline = os_get_ticks() + timeout_ms;
+    uint64        now;
+    int           result;
+
+    pfd.fd     = can_socket;
+    pfd.events = POLLIN;
+
+    while (1)
+    {
+        pfd.revents = 0;
+        result      = poll(&pfd, 1, (int)timeout_ms);
+
+        if (result > 0)
+        {
+            if (0 != (pfd.revents & POLLIN))
+            {
+                return ALL_OK;
+            }
+            return CAN_READ_ERROR;
+        }
+        else if (0 == result)
+        {
+            return NOTHING_TO_DO;
+        }
+        else if (EINTR != errno)
+        {
+            return CAN_READ_ERROR;
+        }
+
+        /* Interrupted by a signal, wait for the remaining time only. */
+        now = os_get_ticks();
+        if (now >= deadline)
+        {
+            return NOTHING_TO_DO;
+        }
+        timeout_ms = (uint32)(deadline - now);
+    }
+}
+
 const char* can_get_error_message(uint32 can_status)
 {
     /* Handle libsocketcan error messages if needed. */
@@ -321,6 +552,8 @@ static int can_monitor(void* core_pt)
                 return 1;
             }
 
+            apply_filters();
+
             core->is_can_initialised = IS_TRUE;
 
             if (IS_FALSE == core->is_plain_mode)
@@ -340,6 +573,93 @@ static int can_monitor(void* core_pt)
     return 0;
 }
 
+static void message_to_frame(can_message_t* message, struct can_frame* frame)
+{
+    int index;
+
+    frame->can_id   = message->id;
+    frame->can_dlc  = message->length;
+    frame->can_id  |= message->is_extended ? CAN_EFF_FLAG : 0;
+
+    for (index = 0; index < 8; index += 1)
+    {
+        frame->data[index] = message->data[index];
+    }
+}
+
+static void frame_to_message(struct can_frame* frame, struct msghdr* msg, can_message_t* message)
+{
+    int             index;
+    struct cmsghdr* cmsg;
+    struct timeval* tv;
+
+    message->id           = frame->can_id;
+    message->length       = frame->can_dlc;
+    message->is_extended  = (frame->can_id & CAN_EFF_FLAG) ? IS_TRUE : IS_FALSE;
+    message->timestamp_us = 0;
+
+    for (index = 0; index < 8; index += 1)
+    {
+        message->data[index] = frame->data[index];
+    }
+
+    for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMP)
+        {
+            tv = (struct timeval*)CMSG_DATA(cmsg);
+            message->timestamp_us = tv->tv_sec * 1000000ULL + tv->tv_usec;
+            break;
+        }
+    }
+}
+
+static uint32 apply_filters(void)
+{
+    struct can_filter kernel_filters[CAN_MAX_FILTERS];
+    can_err_mask_t    error_mask  = rx_error_mask;
+    uint32            num_filters = num_rx_filters;
+    uint32            index;
+
+    /* An empty set would block all traffic, the kernel default is a
+     * single filter that matches every frame.
+     */
+    if (0 == num_filters)
+    {
+        kernel_filters[0].can_id   = 0;
+        kernel_filters[0].can_mask = 0;
+        num_filters                = 1;
+    }
+    else
+    {
+        for (index = 0; index < num_filters; index += 1)
+        {
+            if (IS_TRUE == rx_filters[index].is_extended)
+            {
+                kernel_filters[index].can_id   = (rx_filters[index].id & CAN_EFF_MASK) | CAN_EFF_FLAG;
+                kernel_filters[index].can_mask = (rx_filters[index].mask & CAN_EFF_MASK) | CAN_EFF_FLAG;
+            }
+            else
+            {
+                kernel_filters[index].can_id   = rx_filters[index].id & CAN_SFF_MASK;
+                kernel_filters[index].can_mask = (rx_filters[index].mask & CAN_SFF_MASK) | CAN_EFF_FLAG;
+            }
+        }
+    }
+
+    if (setsockopt(can_socket, SOL_CAN_RAW, CAN_RAW_FILTER, kernel_filters, num_filters * sizeof(struct can_filter)) < 0)
+    {
+        return errno;
+    }
+
+    if (setsockopt(can_socket, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &error_mask, sizeof(error_mask)) < 0)
+    {
+        return errno;
+    }
+
+    return 0;
+}
+
 void parse_rtattr(struct rtattr* tb[], int max, struct rtattr* rta, int len)
 {
     os_memset(tb, 0, sizeof(struct rtattr*) * (max + 1));
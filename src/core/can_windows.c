@@ -51,8 +51,16 @@ static TPCANHandle              peak_can_channel;
 static TPCANChannelInformation* pcan_channel_information = NULL;
 static uint32                   pcan_channel_count;
 static char                     err_message[100] = { 0 };
+static HANDLE                   rx_event         = NULL;
+static can_message_t            rx_pending;
+static bool_t                   has_rx_pending   = IS_FALSE;
+static can_filter_t             rx_filters[CAN_MAX_FILTERS];
+static uint32                   num_rx_filters   = 0;
+static uint32                   rx_error_mask    = 0;
 
 static int      can_monitor(void* core);
+static uint32   pcan_read(can_message_t* message);
+static bool_t   filter_match(const can_message_t* message);
 static status_t search_can_channels(void);
 static void     search_free_can_configuration(core_t* core, bool_t search_baud_rate, bool_t search_channel);
 
@@ -202,6 +210,62 @@ status_t can_print_channel_help(core_t* core)
     return status;
 }
 
+uint32 can_set_filter(const can_filter_t* filters, uint32 num_filters)
+{
+    if ((num_filters > CAN_MAX_FILTERS) || ((num_filters > 0) && (NULL == filters)))
+    {
+        return PCAN_ERROR_ILLPARAMVAL;
+    }
+
+    if (num_filters > 0)
+    {
+        os_memcpy(rx_filters, filters, num_filters * sizeof(can_filter_t));
+    }
+    num_rx_filters = num_filters;
+
+    return PCAN_ERROR_OK;
+}
+
+uint32 can_add_filter(const can_filter_t* filter)
+{
+    if ((NULL == filter) || (num_rx_filters >= CAN_MAX_FILTERS))
+    {
+        return PCAN_ERROR_ILLPARAMVAL;
+    }
+
+    os_memcpy(&rx_filters[num_rx_filters], filter, sizeof(can_filter_t));
+    num_rx_filters += 1;
+
+    return PCAN_ERROR_OK;
+}
+
+uint32 can_clear_filter(void)
+{
+    num_rx_filters = 0;
+
+    return PCAN_ERROR_OK;
+}
+
+uint32 can_get_filter(can_filter_t* filters, uint32 max_filters, uint32* num_filters)
+{
+    if ((NULL == filters) || (NULL == num_filters) || (max_filters < num_rx_filters))
+    {
+        return PCAN_ERROR_ILLPARAMVAL;
+    }
+
+    os_memcpy(filters, rx_filters, num_rx_filters * sizeof(can_filter_t));
+    *num_filters = num_rx_filters;
+
+    return PCAN_ERROR_OK;
+}
+
+uint32 can_set_error_filter(uint32 error_mask)
+{
+    rx_error_mask = error_mask;
+
+    return PCAN_ERROR_OK;
+}
+
 void can_quit(core_t* core)
 {
     if (NULL == core)
@@ -224,8 +288,13 @@ void can_quit(core_t* core)
 
 uint32 can_write(can_message_t* message, disp_mode_t disp_mode, const char* comment)
 {
-    int      index;
-    TPCANMsg pcan_message = { 0 };
+    int             index;
+    uint32          can_status;
+    uint32          gap_us;
+    uint32          backoff_us   = 0;
+    int             retries      = 0;
+    can_tx_pacing_t pacing       = can_get_tx_pacing(&gap_us);
+    TPCANMsg        pcan_message = { 0 };
 
     /* Not yet implemented. */
     (void)disp_mode;
@@ -248,29 +317,145 @@ uint32 can_write(can_message_t* message, disp_mode_t disp_mode, const char* comm
         pcan_message.DATA[index] = message->data[index];
     }
 
-    return (uint32)CAN_Write(peak_can_channel, &pcan_message);
+    while (1)
+    {
+        can_status = (uint32)CAN_Write(peak_can_channel, &pcan_message);
+
+        /* The transmit queue is full, give the controller time to drain it. */
+        if ((PCAN_ERROR_QXMTFULL == can_status) && (CAN_TX_PACING_BACKOFF == pacing) && (retries < CAN_BACKOFF_MAX_RETRIES))
+        {
+            can_tx_backoff(&backoff_us);
+            retries += 1;
+            continue;
+        }
+
+        break;
+    }
+
+    if ((PCAN_ERROR_OK == can_status) && (CAN_TX_PACING_FIXED_GAP == pacing))
+    {
+        os_delay_us(gap_us);
+    }
+
+    return can_status;
+}
+
+uint32 can_write_batch(can_message_t* messages, uint32 num_messages, uint32* num_written)
+{
+    uint32 can_status;
+    uint32 index;
+
+    if ((NULL == messages) || (NULL == num_written))
+    {
+        return PCAN_ERROR_ILLPARAMVAL;
+    }
+
+    *num_written = 0;
+
+    for (index = 0; index < num_messages; index += 1)
+    {
+        can_status = can_write(&messages[index], SILENT, NULL);
+        if (PCAN_ERROR_OK != can_status)
+        {
+            return can_status;
+        }
+
+        *num_written += 1;
+    }
+
+    return PCAN_ERROR_OK;
 }
 
 uint32 can_read(can_message_t* message)
 {
-    int            index;
-    uint32         can_status;
-    TPCANMsg       pcan_message   = { 0 };
-    TPCANTimestamp pcan_timestamp = { 0 };
+    if (IS_TRUE == has_rx_pending)
+    {
+        os_memcpy(message, &rx_pending, sizeof(can_message_t));
+        has_rx_pending = IS_FALSE;
+        return PCAN_ERROR_OK;
+    }
 
-    can_status = CAN_Read(peak_can_channel, &pcan_message, &pcan_timestamp);
+    return pcan_read(message);
+}
 
-    message->id           = pcan_message.ID;
-    message->length       = pcan_message.LEN;
-    message->is_extended  = (PCAN_MESSAGE_EXTENDED == pcan_message.MSGTYPE) ? IS_TRUE : IS_FALSE;
-    message->timestamp_us =
-        pcan_timestamp.micros
-        + (1000ULL * pcan_timestamp.millis)
-        + (0x100000000ULL * 1000ULL * pcan_timestamp.millis_overflow);
+status_t can_poll(uint32 timeout_ms)
+{
+    uint32 can_status;
+    uint64 deadline = os_get_ticks() + timeout_ms;
+    uint64 now;
 
-    for (index = 0; index < 8; index += 1)
+    if (IS_TRUE == has_rx_pending)
     {
-        message->data[index] = pcan_message.DATA[index];
+        return ALL_OK;
+    }
+
+    /* PCAN has no way to peek into the receive queue, so the first frame
+     * is fetched ahead of time and handed out by the next can_read().
+     */
+    while (1)
+    {
+        can_status = pcan_read(&rx_pending);
+        if (PCAN_ERROR_OK == can_status)
+        {
+            has_rx_pending = IS_TRUE;
+            return ALL_OK;
+        }
+        else if (PCAN_ERROR_QRCVEMPTY != can_status)
+        {
+            return CAN_READ_ERROR;
+        }
+
+        now = os_get_ticks();
+        if (now >= deadline)
+        {
+            return NOTHING_TO_DO;
+        }
+
+        if (NULL != rx_event)
+        {
+            WaitForSingleObject(rx_event, (DWORD)(deadline - now));
+        }
+        else
+        {
+            os_delay(1);
+        }
+    }
+}
+
+uint32 can_read_batch(can_message_t* messages, uint32 max_messages, uint32* num_read)
+{
+    uint32 can_status = PCAN_ERROR_OK;
+    uint32 index;
+
+    if ((NULL == messages) || (NULL == num_read))
+    {
+        return PCAN_ERROR_ILLPARAMVAL;
+    }
+
+    *num_read = 0;
+
+    if (max_messages > CAN_BATCH_SIZE)
+    {
+        max_messages = CAN_BATCH_SIZE;
+    }
+
+    /* CAN_Read() is non-blocking, drain the receive queue until it runs
+     * empty or the caller's buffer is full.
+     */
+    for (index = 0; index < max_messages; index += 1)
+    {
+        can_status = can_read(&messages[index]);
+        if (PCAN_ERROR_OK != can_status)
+        {
+            break;
+        }
+
+        *num_read += 1;
+    }
+
+    if ((*num_read > 0) || (PCAN_ERROR_QRCVEMPTY == can_status))
+    {
+        return PCAN_ERROR_OK;
     }
 
     return can_status;
@@ -337,6 +522,72 @@ const char* can_get_error_message(uint32 can_status)
     }
 }
 
+static uint32 pcan_read(can_message_t* message)
+{
+    int            index;
+    uint32         can_status;
+    TPCANMsg       pcan_message   = { 0 };
+    TPCANTimestamp pcan_timestamp = { 0 };
+
+    /* PCAN offers a single acceptance range per channel only, so the
+     * filter set is applied here while draining the receive queue.
+     */
+    while (1)
+    {
+        can_status = CAN_Read(peak_can_channel, &pcan_message, &pcan_timestamp);
+        if (PCAN_ERROR_OK != can_status)
+        {
+            return can_status;
+        }
+
+        message->id           = pcan_message.ID;
+        message->length       = pcan_message.LEN;
+        message->is_extended  = (PCAN_MESSAGE_EXTENDED == pcan_message.MSGTYPE) ? IS_TRUE : IS_FALSE;
+        message->timestamp_us =
+            pcan_timestamp.micros
+            + (1000ULL * pcan_timestamp.millis)
+            + (0x100000000ULL * 1000ULL * pcan_timestamp.millis_overflow);
+
+        for (index = 0; index < 8; index += 1)
+        {
+            message->data[index] = pcan_message.DATA[index];
+        }
+
+        if (0 != (pcan_message.MSGTYPE & PCAN_MESSAGE_STATUS))
+        {
+            if (0 != rx_error_mask)
+            {
+                return can_status;
+            }
+        }
+        else if (IS_TRUE == filter_match(message))
+        {
+            return can_status;
+        }
+    }
+}
+
+static bool_t filter_match(const can_message_t* message)
+{
+    uint32 index;
+
+    if (0 == num_rx_filters)
+    {
+        return IS_TRUE;
+    }
+
+    for (index = 0; index < num_rx_filters; index += 1)
+    {
+        if ((rx_filters[index].is_extended == message->is_extended) &&
+            ((message->id & rx_filters[index].mask) == (rx_filters[index].id & rx_filters[index].mask)))
+        {
+            return IS_TRUE;
+        }
+    }
+
+    return IS_FALSE;
+}
+
 static int can_monitor(void* core_pt)
 {
     core_t* core = core_pt;
@@ -448,6 +699,16 @@ static void search_free_can_configuration(core_t* core, bool_t search_baud_rate,
             {
                 core->is_can_initialised = IS_TRUE;
 
+                if (NULL == rx_event)
+                {
+                    rx_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+                }
+
+                if (NULL != rx_event)
+                {
+                    CAN_SetValue(peak_can_channel, PCAN_RECEIVE_EVENT, &rx_event, sizeof(rx_event));
+                }
+
                 if (IS_TRUE == search_baud_rate)
                 {
                     core->baud_rate = rate_i;
@@ -11,6 +11,9 @@
 #include "command.h"
 #include "core.h"
 #include "dbc.h"
+#include "dict.h"
+#include "dispatch.h"
+#include "eds.h"
 #include "junit.h"
 #include "lua_can.h"
 #include "lua_dbc.h"
@@ -20,7 +23,10 @@
 #include "lua_sdo.h"
 #include "nmt.h"
 #include "os.h"
+#include "pdo.h"
 #include "scripts.h"
+#include "sdo_cache.h"
+#include "sdo_client.h"
 #include "version.h"
 
 status_t core_init(core_t **core, bool_t is_plain_mode)
@@ -72,6 +78,18 @@ status_t core_init(core_t **core, bool_t is_plain_mode)
     /* Initialise CAN. */
     can_init((*core));
 
+    status = dispatch_init((*core));
+    if (status != ALL_OK)
+    {
+        return status;
+    }
+
+    status = pdo_init();
+    if (status != ALL_OK)
+    {
+        return status;
+    }
+
     (*core)->is_running = IS_TRUE;
     return status;
 }
@@ -103,6 +121,12 @@ void core_deinit(core_t *core)
 
     junit_clear_results();
     dbc_unload();
+    eds_unload();
+    dict_deinit();
+    sdo_cache_deinit();
+    sdo_client_deinit();
+    pdo_deinit();
+    dispatch_deinit(core);
     can_quit(core);
     scripts_deinit(core);
     os_quit();
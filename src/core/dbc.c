@@ -11,456 +11,1730 @@
 #include "dbc.h"
 #include "os.h"
 
-static dbc_t* dbc;
+#define DBC_CHUNK_SIZE    0x10000
+#define DBC_NUMBER_SIZE   64
+#define J1939_PDU2_MIN_PF 240
 
-static uint64 extract_raw_signal(uint64 can_frame, uint8 start_bit, uint8 length, endian_t endianness);
-static void   parse_message_line(char *line, message_t *message);
-static void   parse_signal_line(char *line, signal_t *signal);
-static bool_t starts_with(const char *str, const char *prefix);
-static char*  str_tolower(const char* str);
-static char*  trim_whitespace(char *str);
+/* As in the DBC file: extended IDs carry the top bit, and Vector's
+ * VECTOR__INDEPENDENT_SIG_MSG holds signals not sent in any frame.
+ */
+#define DBC_EXTENDED_FLAG  0x80000000
+#define DBC_INDEPENDENT_ID 0xC0000000
+
+typedef struct dbc_span
+{
+    const char* start;
+    size_t      length;
+
+} dbc_span_t;
+
+/* A value table, resolved to its signal once all messages are known. */
+typedef struct dbc_group
+{
+    uint32 id; /* Keyed like the index. */
+    char*  signal;
+    int    first;
+    int    count;
+
+} dbc_group_t;
+
+/* Only needed while parsing, the strings themselves live in the arena. */
+typedef struct dbc_loader
+{
+    dbc_t*       db;
+    char**       strings;
+    uint32       num_strings;
+    uint32       size;
+    int          messages_capacity;
+    int          signals_capacity;
+    int          labels_capacity;
+    dbc_group_t* groups;
+    int          num_groups;
+    int          groups_capacity;
+    bool_t       is_skipping; /* Signals of a message that was left out. */
+
+} dbc_loader_t;
+
+/* Databases by handle minus one.  The merged index covers those active on
+ * the selected interface, in the order they are looked up.
+ */
+typedef struct dbc_registry
+{
+    dbc_t*      databases[DBC_MAX_DATABASES];
+    dbc_t*      active[DBC_MAX_DATABASES];
+    int         num_active;
+    char        can_interface[DBC_INTERFACE_SIZE];
+    dbc_slot_t* id_slots;
+    dbc_slot_t* pgn_slots;
+    uint32      num_slots;
+
+} dbc_registry_t;
+
+static dbc_registry_t registry;
+
+static char*            arena_alloc(dbc_t* db, size_t size);
+static status_t         build_dispatch(dbc_t* db);
+static status_t         build_index(dbc_t* db);
+static status_t         build_names(dbc_t* db);
+static int              compare_labels(const void* a, const void* b);
+static int              compare_names(const void* a, const void* b);
+static status_t         compile_plans(dbc_t* db);
+static double           decode_signal(const dbc_plan_t* plan, int signal, uint64 data, uint64* raw_value);
+static uint64           encode_signal(const message_t* message, int signal, double value);
+static message_t*       find_message(uint32 can_id);
+static int              find_messages(const dbc_t* db, const char* search, dbc_match_t match, const message_t** messages, int max_messages, int count);
+static const dbc_mux_t* find_mux(const message_t* message, uint64 data);
+static int              find_name(const dbc_t* db, const char* name);
+static message_t*       find_slot(const dbc_slot_t* slots, uint32 num_slots, uint32 key);
+static void             free_database(dbc_t* db);
+static uint32           get_key(uint32 can_id, bool_t is_extended);
+static uint32           get_pgn(uint32 can_id);
+static status_t         grow(void** array, int* capacity, size_t element_size);
+static uint32           hash_key(uint32 key);
+static uint32           hash_text(const char* text, size_t length);
+static uint64           insert_signal(const dbc_plan_t* plan, int signal, uint64 raw_value, uint64 data);
+static void             insert_slot(dbc_slot_t* slots, uint32 num_slots, uint32 key, message_t* message);
+static char*            intern(dbc_loader_t* loader, dbc_span_t text);
+static bool_t           is_in_range(const dbc_t* db, uint32 can_id);
+static status_t         load_database(dbc_t* db, const char* filename);
+static status_t         merge_index(void);
+static dbc_span_t       next_field(const char** pos, const char* end, char delimiter);
+static dbc_span_t       next_quoted(const char** pos, const char* end);
+static double           parse_double(dbc_span_t text, double default_value);
+static status_t         parse_line(dbc_loader_t* loader, const char* line, const char* end);
+static status_t         parse_message(dbc_loader_t* loader, const char* pos, const char* end);
+static status_t         parse_signal(dbc_loader_t* loader, const char* pos, const char* end);
+static unsigned long    parse_uint(dbc_span_t text);
+static status_t         parse_values(dbc_loader_t* loader, const char* pos, const char* end);
+static void             resolve_labels(dbc_loader_t* loader);
+static dbc_span_t       rest_of_line(const char* pos, const char* end);
+static const char*      skip_spaces(const char* pos, const char* end);
+static bool_t           starts_with(const char* str, const char* end, const char* prefix);
+static uint64           swap_bytes(uint64 data);
+static uint32           table_size(int count);
+static bool_t           to_lower(char* dest, const char* src, size_t size);
+
+status_t dbc_bind(uint32 handle, const char* can_interface, uint32 first_id, uint32 last_id)
+{
+    dbc_t* db;
+
+    if ((0 == handle) || (handle > DBC_MAX_DATABASES) || (NULL == registry.databases[handle - 1]))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    db = registry.databases[handle - 1];
+    os_strlcpy(db->can_interface, (NULL != can_interface) ? can_interface : "", sizeof(db->can_interface));
+    db->first_id = first_id & 0x1FFFFFFF;
+    db->last_id  = last_id & 0x1FFFFFFF;
+
+    /* Only the merged index changes, nothing is parsed again. */
+    return merge_index();
+}
+
+status_t dbc_close(uint32 handle)
+{
+    if ((0 == handle) || (handle > DBC_MAX_DATABASES) || (NULL == registry.databases[handle - 1]))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    free_database(registry.databases[handle - 1]);
+    os_free(registry.databases[handle - 1]);
+    registry.databases[handle - 1] = NULL;
+
+    return merge_index();
+}
 
 const char* dbc_decode(uint32 can_id, uint64 data)
 {
-    static char result[4096] = { 0 };
-    int         pos          = 0;
-    int         i;
+    static char        result[4096] = { 0 };
+    static dbc_value_t values[DBC_MAX_VALUES];
+    int                pos          = 0;
+    const message_t*   msg          = dbc_find_message(can_id);
+    int                count;
+    int                n;
+    int                j;
+
+    if (NULL == msg)
+    {
+        return "";
+    }
+
+    n = os_snprintf(result, sizeof(result), "%s (%Xh)\n", msg->name, msg->id);
+    if (n > 0)
+    {
+        pos += n;
+    }
+
+    count = dbc_decode_values(msg, data, values, DBC_MAX_VALUES);
+    for (j = 0; (j < count) && (pos < (int)sizeof(result)); ++j)
+    {
+        const signal_t* signal = &msg->signals[values[j].signal];
+
+        if (NULL != values[j].label)
+        {
+            n = os_snprintf(result + pos, sizeof(result) - pos, "  %-36s: %s\n", signal->name, values[j].label);
+        }
+        else
+        {
+            n = os_snprintf(result + pos, sizeof(result) - pos, "  %-36s: %f %s\n", signal->name, values[j].value, signal->unit);
+        }
+
+        if (n > 0)
+        {
+            pos += n;
+        }
+    }
+    result[sizeof(result) - 1] = '\0';
+
+    return result;
+}
+
+void dbc_decode_batch(const message_t* message, const uint64* frames, uint32 num_frames, double* values)
+{
+    int signal;
+
+    if ((NULL == message) || (NULL == frames) || (NULL == values))
+    {
+        return;
+    }
+
+    /* Signal by signal, so each inner loop is branch-free over frames and
+     * writes one contiguous row of values.
+     */
+    for (signal = 0; signal < message->signal_count; ++signal)
+    {
+        const dbc_plan_t* plan   = &message->plan;
+        uint64            mask   = plan->masks[signal];
+        uint64            sign   = plan->sign_bits[signal];
+        double            scale  = plan->scales[signal];
+        double            offset = plan->offsets[signal];
+        uint8             shift  = plan->shifts[signal];
+        double*           row    = &values[(uint32)signal * num_frames];
+        uint32            frame;
+
+        if (IS_TRUE == plan->is_swapped[signal])
+        {
+            for (frame = 0; frame < num_frames; ++frame)
+            {
+                uint64 raw = (swap_bytes(frames[frame]) >> shift) & mask;
+
+                row[frame] = ((double)(sint64)((raw ^ sign) - sign) * scale) + offset;
+            }
+        }
+        else
+        {
+            for (frame = 0; frame < num_frames; ++frame)
+            {
+                uint64 raw = (frames[frame] >> shift) & mask;
+
+                row[frame] = ((double)(sint64)((raw ^ sign) - sign) * scale) + offset;
+            }
+        }
+    }
+}
+
+int dbc_decode_values(const message_t* message, uint64 data, dbc_value_t* values, int max_values)
+{
+    const dbc_mux_t* mux;
+    int              total;
+    int              count = 0;
+
+    if ((NULL == message) || (NULL == values))
+    {
+        return 0;
+    }
+
+    /* Always active signals, then those selected by the multiplexer. */
+    mux   = find_mux(message, data);
+    total = message->plain_count + ((NULL != mux) ? mux->count : 0);
+
+    while ((count < total) && (count < max_values))
+    {
+        int             signal = (count < message->plain_count) ? message->dispatch[count] : message->dispatch[mux->first + count - message->plain_count];
+        const signal_t* sig    = &message->signals[signal];
+        uint64          sign   = message->plan.sign_bits[signal];
+
+        values[count].signal = signal;
+        values[count].value  = decode_signal(&message->plan, signal, data, &values[count].raw);
+        values[count].label  = NULL;
+
+        if (sig->label_count > 0)
+        {
+            values[count].label = dbc_find_label(sig, (sint64)((values[count].raw ^ sign) - sign));
+        }
+
+        count += 1;
+    }
+
+    return count;
+}
+
+status_t dbc_encode(const message_t* message, const dbc_value_t* values, int num_values, uint64* data)
+{
+    uint64 frame;
+    int    i;
+
+    if ((NULL == message) || (NULL == data) || ((num_values > 0) && (NULL == values)))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    frame = *data;
+
+    /* Multiplexed signals select their group first, so that a value given
+     * for the multiplexer itself still wins.
+     */
+    for (i = 0; i < num_values; ++i)
+    {
+        int signal = values[i].signal;
+
+        if ((signal < 0) || (signal >= message->signal_count))
+        {
+            return OS_INVALID_ARGUMENT;
+        }
+
+        if ((message->mux_signal >= 0) && (message->signals[signal].mux_value >= 0))
+        {
+            frame = insert_signal(&message->plan, message->mux_signal, (uint64)message->signals[signal].mux_value, frame);
+        }
+    }
+
+    for (i = 0; i < num_values; ++i)
+    {
+        int signal = values[i].signal;
+
+        frame = insert_signal(&message->plan, signal, encode_signal(message, signal, values[i].value), frame);
+    }
+
+    *data = frame;
+    return ALL_OK;
+}
+
+const char* dbc_find_label(const signal_t* signal, sint64 value)
+{
+    int low  = 0;
+    int high;
+
+    if (NULL == signal)
+    {
+        return NULL;
+    }
+
+    high = signal->label_count;
+    while (low < high)
+    {
+        int middle = low + ((high - low) / 2);
+
+        if (signal->labels[middle].value < value)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if ((low < signal->label_count) && (value == signal->labels[low].value))
+    {
+        return signal->labels[low].label;
+    }
+
+    return NULL;
+}
+
+const message_t* dbc_find_message(uint32 can_id)
+{
+    return find_message(can_id);
+}
+
+int dbc_find_messages(const char* search, dbc_match_t match, const message_t** messages, int max_messages)
+{
+    char lower_search[DBC_NAME_SIZE];
+    int  count = 0;
+    int  i;
+
+    if ((NULL == search) || (IS_FALSE == to_lower(lower_search, search, sizeof(lower_search))))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < registry.num_active; ++i)
+    {
+        count = find_messages(registry.active[i], lower_search, match, messages, max_messages, count);
+    }
+
+    return count;
+}
+
+status_t dbc_find_id_by_name(uint32* id, const char* search)
+{
+    char lower_search[DBC_NAME_SIZE];
+    int  i, j;
+
+    if ((NULL == search) || (NULL == id))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (IS_FALSE == to_lower(lower_search, search, sizeof(lower_search)))
+    {
+        return ITEM_NOT_FOUND;
+    }
+
+    for (i = 0; i < registry.num_active; ++i)
+    {
+        const dbc_t* db    = registry.active[i];
+        int          first = -1;
+
+        /* The first match in file order, as before the index existed. */
+        for (j = 0; j < db->message_count; ++j)
+        {
+            const message_t* message = &db->messages[db->names[j].message];
+
+            if (((db->names[j].message < first) || (first < 0)) && (IS_TRUE == is_in_range(db, message->id)))
+            {
+                if (NULL != os_strstr(db->names[j].name, lower_search))
+                {
+                    first = db->names[j].message;
+                }
+            }
+        }
+
+        if (first >= 0)
+        {
+            *id = db->messages[first].id;
+            return ALL_OK;
+        }
+    }
+
+    return ITEM_NOT_FOUND;
+}
+
+int dbc_find_signal(const message_t* message, const char* name)
+{
+    int i;
+
+    if ((NULL == message) || (NULL == name))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < message->signal_count; ++i)
+    {
+        if (0 == os_strcmp(message->signals[i].name, name))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+status_t dbc_load(const char* filename)
+{
+    uint32 handle;
+
+    dbc_unload();
+
+    return dbc_open(filename, &handle);
+}
+
+status_t dbc_open(const char* filename, uint32* handle)
+{
+    dbc_t*   db;
+    status_t status;
+    int      i;
+
+    if ((NULL == filename) || (NULL == handle))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < DBC_MAX_DATABASES; ++i)
+    {
+        if (NULL == registry.databases[i])
+        {
+            break;
+        }
+    }
+
+    if (DBC_MAX_DATABASES == i)
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    db = os_calloc(1, sizeof(dbc_t));
+    if (NULL == db)
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    status = load_database(db, filename);
+    if (ALL_OK != status)
+    {
+        free_database(db);
+        os_free(db);
+        return status;
+    }
+
+    /* Bound to no interface and all IDs until told otherwise. */
+    db->last_id           = 0x1FFFFFFF;
+    registry.databases[i] = db;
+
+    status = merge_index();
+    if (ALL_OK != status)
+    {
+        dbc_close((uint32)i + 1);
+        return status;
+    }
+
+    *handle = (uint32)i + 1;
+    return ALL_OK;
+}
+
+void dbc_print(void)
+{
+    int d, i, j;
+
+    for (d = 0; d < DBC_MAX_DATABASES; ++d)
+    {
+        const dbc_t* db = registry.databases[d];
+
+        if (NULL == db)
+        {
+            continue;
+        }
+
+        os_printf("DBC File contains %d messages\n", db->message_count);
+        for (i = 0; i < db->message_count; ++i)
+        {
+            const message_t *msg = &db->messages[i];
+            os_printf("Message %d: ID=%u, Name=%s, DLC=%u, Transmitter=%s\n",
+                i + 1, msg->id, msg->name, msg->dlc, msg->transmitter);
+            os_printf("  Contains %d signals\n", msg->signal_count);
+            for (j = 0; j < msg->signal_count; ++j)
+            {
+                const signal_t *sig = &msg->signals[j];
+                os_printf("  Signal %d: Name=%s, StartBit=%d, Length=%d, Endianness=%d, Scale=%.6f, Offset=%.2f, Min=%.2f, Max=%.2f, Unit=%s, Receiver=%s\n",
+                    j + 1, sig->name, sig->start_bit, sig->length, sig->endianness, sig->scale, sig->offset, sig->min_value, sig->max_value, sig->unit, sig->receiver);
+            }
+        }
+    }
+}
+
+status_t dbc_select_interface(const char* can_interface)
+{
+    os_strlcpy(registry.can_interface, (NULL != can_interface) ? can_interface : "", sizeof(registry.can_interface));
+
+    return merge_index();
+}
+
+void dbc_unload(void)
+{
+    int i;
+
+    for (i = 0; i < DBC_MAX_DATABASES; ++i)
+    {
+        if (NULL != registry.databases[i])
+        {
+            free_database(registry.databases[i]);
+            os_free(registry.databases[i]);
+            registry.databases[i] = NULL;
+        }
+    }
+
+    /* The selected interface stays, for the next database to be bound. */
+    merge_index();
+}
+
+static char* arena_alloc(dbc_t* db, size_t size)
+{
+    dbc_chunk_t* chunk = db->strings;
+    char*        data;
+
+    if ((NULL == chunk) || ((chunk->size - chunk->used) < size))
+    {
+        size_t chunk_size = (size > DBC_CHUNK_SIZE) ? size : DBC_CHUNK_SIZE;
+
+        chunk = os_calloc(1, sizeof(dbc_chunk_t) + chunk_size);
+        if (NULL == chunk)
+        {
+            return NULL;
+        }
+
+        chunk->size  = chunk_size;
+        chunk->next  = db->strings;
+        db->strings = chunk;
+    }
+
+    data         = (char*)(chunk + 1) + chunk->used;
+    chunk->used += size;
+
+    return data;
+}
+
+static status_t build_dispatch(dbc_t* db)
+{
+    int used      = 0;
+    int num_muxes = 0;
+    int i, j, k;
+
+    if (0 == db->signal_count)
+    {
+        return ALL_OK;
+    }
+
+    db->dispatch = os_calloc((size_t)db->signal_count, sizeof(int));
+    db->muxes    = os_calloc((size_t)db->signal_count, sizeof(dbc_mux_t));
+    if ((NULL == db->dispatch) || (NULL == db->muxes))
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    for (i = 0; i < db->message_count; ++i)
+    {
+        message_t* msg   = &db->messages[i];
+        int        count = 0;
+
+        msg->dispatch   = &db->dispatch[used];
+        msg->muxes      = &db->muxes[num_muxes];
+        msg->mux_signal = -1;
+
+        for (j = 0; j < msg->signal_count; ++j)
+        {
+            if ((IS_TRUE == msg->signals[j].is_multiplexer) && (msg->mux_signal < 0))
+            {
+                msg->mux_signal = j;
+            }
+        }
+
+        /* Without a multiplexer every signal is always active. */
+        for (j = 0; j < msg->signal_count; ++j)
+        {
+            if ((msg->mux_signal < 0) || (msg->signals[j].mux_value < 0))
+            {
+                msg->dispatch[count++] = j;
+            }
+        }
+        msg->plain_count = count;
+
+        if (msg->mux_signal >= 0)
+        {
+            /* Insertion sort by value keeps each group in file order. */
+            for (j = 0; j < msg->signal_count; ++j)
+            {
+                if (msg->signals[j].mux_value >= 0)
+                {
+                    for (k = count; (k > msg->plain_count) && (msg->signals[msg->dispatch[k - 1]].mux_value > msg->signals[j].mux_value); --k)
+                    {
+                        msg->dispatch[k] = msg->dispatch[k - 1];
+                    }
+                    msg->dispatch[k] = j;
+                    count           += 1;
+                }
+            }
+
+            for (k = msg->plain_count; k < count; ++k)
+            {
+                uint32 value = (uint32)msg->signals[msg->dispatch[k]].mux_value;
+
+                if ((0 == msg->mux_count) || (value != msg->muxes[msg->mux_count - 1].value))
+                {
+                    msg->muxes[msg->mux_count].value = value;
+                    msg->muxes[msg->mux_count].first = k;
+                    msg->muxes[msg->mux_count].count = 0;
+                    msg->mux_count                  += 1;
+                }
+                msg->muxes[msg->mux_count - 1].count += 1;
+            }
+        }
+
+        used      += msg->signal_count;
+        num_muxes += msg->mux_count;
+    }
+
+    return ALL_OK;
+}
+
+static status_t build_index(dbc_t* db)
+{
+    int i;
+
+    db->num_slots = table_size(db->message_count);
+    db->id_slots  = os_calloc(db->num_slots, sizeof(dbc_slot_t));
+    if (NULL == db->id_slots)
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    for (i = 0; i < db->message_count; ++i)
+    {
+        insert_slot(db->id_slots, db->num_slots, get_key(db->messages[i].id, db->messages[i].is_extended), &db->messages[i]);
+    }
+
+    return ALL_OK;
+}
+
+static status_t build_names(dbc_t* db)
+{
+    int i;
+
+    if (0 == db->message_count)
+    {
+        return ALL_OK;
+    }
+
+    db->names = os_calloc((size_t)db->message_count, sizeof(dbc_name_t));
+    if (NULL == db->names)
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    for (i = 0; i < db->message_count; ++i)
+    {
+        size_t size = os_strlen(db->messages[i].name) + 1;
+        char*  name = arena_alloc(db, size);
+
+        if (NULL == name)
+        {
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+
+        to_lower(name, db->messages[i].name, size);
+        db->names[i].name    = name;
+        db->names[i].message = i;
+    }
+
+    os_qsort(db->names, (size_t)db->message_count, sizeof(dbc_name_t), compare_names);
+
+    return ALL_OK;
+}
+
+static int compare_labels(const void* a, const void* b)
+{
+    const dbc_label_t* label_a = (const dbc_label_t*)a;
+    const dbc_label_t* label_b = (const dbc_label_t*)b;
+
+    if (label_a->value < label_b->value)
+    {
+        return -1;
+    }
+
+    return (label_a->value > label_b->value) ? 1 : 0;
+}
+
+static int compare_names(const void* a, const void* b)
+{
+    const dbc_name_t* name_a = (const dbc_name_t*)a;
+    const dbc_name_t* name_b = (const dbc_name_t*)b;
+    int               result = os_strcmp(name_a->name, name_b->name);
+
+    /* Keep file order among equal names. */
+    if (0 == result)
+    {
+        result = name_a->message - name_b->message;
+    }
+
+    return result;
+}
+
+static status_t compile_plans(dbc_t* db)
+{
+    size_t count = (size_t)db->signal_count;
+    int    first = 0;
+    int    i, j;
+
+    if (0 == count)
+    {
+        return ALL_OK;
+    }
+
+    /* One block for the whole database, widest elements first. */
+    db->plans.masks = os_calloc(count, (sizeof(uint64) * 2) + (sizeof(double) * 2) + (sizeof(uint8) * 2));
+    if (NULL == db->plans.masks)
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    db->plans.sign_bits  = db->plans.masks + count;
+    db->plans.scales     = (double*)(db->plans.sign_bits + count);
+    db->plans.offsets    = db->plans.scales + count;
+    db->plans.shifts     = (uint8*)(db->plans.offsets + count);
+    db->plans.is_swapped = db->plans.shifts + count;
+
+    for (i = 0; i < db->message_count; ++i)
+    {
+        message_t*  msg  = &db->messages[i];
+        dbc_plan_t* plan = &msg->plan;
+
+        msg->signals     = &db->signals[first];
+        plan->masks      = &db->plans.masks[first];
+        plan->sign_bits  = &db->plans.sign_bits[first];
+        plan->scales     = &db->plans.scales[first];
+        plan->offsets    = &db->plans.offsets[first];
+        plan->shifts     = &db->plans.shifts[first];
+        plan->is_swapped = &db->plans.is_swapped[first];
+        first           += msg->signal_count;
+
+        for (j = 0; j < msg->signal_count; ++j)
+        {
+            const signal_t* sig    = &msg->signals[j];
+            int             length = sig->length;
+            int             shift;
+
+            if (ENDIANNESS_MOTOROLA == sig->endianness)
+            {
+                /* The start bit is the MSB in sawtooth numbering.  Once the
+                 * frame is byte-swapped, that's bit (7 - byte) * 8 + bit.
+                 */
+                shift = ((7 - (sig->start_bit / 8)) * 8) + (sig->start_bit % 8) - length + 1;
+                plan->is_swapped[j] = IS_TRUE;
+            }
+            else
+            {
+                shift = sig->start_bit;
+                plan->is_swapped[j] = IS_FALSE;
+            }
+
+            if ((length <= 0) || (length > 64) || (shift < 0) || ((shift + length) > 64))
+            {
+                length = 0;
+                shift  = 0;
+            }
+
+            plan->masks[j]     = (64 == length) ? ~0ULL : ((1ULL << length) - 1);
+            plan->sign_bits[j] = ((IS_TRUE == sig->is_signed) && (length > 0)) ? (1ULL << (length - 1)) : 0;
+            plan->scales[j]    = sig->scale;
+            plan->offsets[j]   = sig->offset;
+            plan->shifts[j]    = (uint8)shift;
+        }
+    }
+
+    return ALL_OK;
+}
+
+static double decode_signal(const dbc_plan_t* plan, int signal, uint64 data, uint64* raw_value)
+{
+    uint64 sign = plan->sign_bits[signal];
+
+    if (IS_TRUE == plan->is_swapped[signal])
+    {
+        data = swap_bytes(data);
+    }
+
+    *raw_value = (data >> plan->shifts[signal]) & plan->masks[signal];
+
+    return ((double)(sint64)((*raw_value ^ sign) - sign) * plan->scales[signal]) + plan->offsets[signal];
+}
+
+static uint64 encode_signal(const message_t* message, int signal, double value)
+{
+    const signal_t*   sig     = &message->signals[signal];
+    const dbc_plan_t* plan    = &message->plan;
+    uint64            sign    = plan->sign_bits[signal];
+    double            lowest  = (0 != sign) ? -(double)sign : 0.0;
+    double            highest = (0 != sign) ? (double)(sign - 1) : (double)plan->masks[signal];
+    double            raw;
+
+    if ((sig->min_value < sig->max_value) && (value < sig->min_value))
+    {
+        value = sig->min_value;
+    }
+    else if ((sig->min_value < sig->max_value) && (value > sig->max_value))
+    {
+        value = sig->max_value;
+    }
+
+    raw = value - plan->offsets[signal];
+    if (0.0 != plan->scales[signal])
+    {
+        raw /= plan->scales[signal];
+    }
+
+    /* Rounded to nearest and saturated, so the cast below stays defined. */
+    if (raw <= lowest)
+    {
+        return (0 != sign) ? (uint64)0 - sign : 0;
+    }
+    else if (raw >= highest)
+    {
+        return (0 != sign) ? sign - 1 : plan->masks[signal];
+    }
+    else if (raw < 0.0)
+    {
+        return (uint64)(sint64)(raw - 0.5);
+    }
+
+    return (uint64)(raw + 0.5);
+}
+
+static message_t* find_message(uint32 can_id)
+{
+    message_t* message;
+    bool_t     is_extended;
+
+    if (NULL == registry.id_slots)
+    {
+        return NULL;
+    }
+
+    /* Anything past eleven bits is extended, as is an ID with the flag. */
+    is_extended = ((can_id & DBC_EXTENDED_FLAG) || ((can_id & 0x1FFFFFFF) > 0x7FF)) ? IS_TRUE : IS_FALSE;
+    can_id     &= 0x1FFFFFFF;
+    message     = find_slot(registry.id_slots, registry.num_slots, get_key(can_id, is_extended));
+
+    /* J1939 frames are sent with any priority and source address (and for
+     * PDU1, destination), so fall back to the parameter group number.
+     */
+    if ((NULL == message) && (IS_TRUE == is_extended))
+    {
+        message = find_slot(registry.pgn_slots, registry.num_slots, get_pgn(can_id));
+    }
+
+    return message;
+}
+
+static int find_messages(const dbc_t* db, const char* search, dbc_match_t match, const message_t** messages, int max_messages, int count)
+{
+    size_t length = os_strlen(search);
+    int    i;
+
+    if (NULL == db->names)
+    {
+        return count;
+    }
+
+    /* Exact and prefix matches form one run in the sorted names. */
+    for (i = (DBC_MATCH_SUBSTRING == match) ? 0 : find_name(db, search); i < db->message_count; ++i)
+    {
+        const char*      name    = db->names[i].name;
+        const message_t* message = &db->messages[db->names[i].message];
+
+        if (DBC_MATCH_SUBSTRING == match)
+        {
+            if (NULL == os_strstr(name, search))
+            {
+                continue;
+            }
+        }
+        else if (0 != os_strncmp(name, search, length))
+        {
+            break;
+        }
+        else if ((DBC_MATCH_EXACT == match) && ('\0' != name[length]))
+        {
+            break;
+        }
+
+        if (IS_FALSE == is_in_range(db, message->id))
+        {
+            continue;
+        }
+
+        if ((count < max_messages) && (NULL != messages))
+        {
+            messages[count] = message;
+        }
+        count += 1;
+    }
+
+    return count;
+}
+
+static const dbc_mux_t* find_mux(const message_t* message, uint64 data)
+{
+    uint64 raw_value;
+    int    low  = 0;
+    int    high = message->mux_count;
+
+    if (message->mux_signal < 0)
+    {
+        return NULL;
+    }
+
+    decode_signal(&message->plan, message->mux_signal, data, &raw_value);
+
+    while (low < high)
+    {
+        int middle = low + ((high - low) / 2);
+
+        if (message->muxes[middle].value < raw_value)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if ((low < message->mux_count) && (raw_value == message->muxes[low].value))
+    {
+        return &message->muxes[low];
+    }
+
+    return NULL;
+}
+
+static int find_name(const dbc_t* db, const char* name)
+{
+    int low  = 0;
+    int high = db->message_count;
+
+    while (low < high)
+    {
+        int middle = low + ((high - low) / 2);
+
+        if (os_strcmp(db->names[middle].name, name) < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+static message_t* find_slot(const dbc_slot_t* slots, uint32 num_slots, uint32 key)
+{
+    uint32 mask = num_slots - 1;
+    uint32 slot = hash_key(key) & mask;
+
+    while (NULL != slots[slot].message)
+    {
+        if (key == slots[slot].key)
+        {
+            return slots[slot].message;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return NULL;
+}
+
+static void free_database(dbc_t* db)
+{
+    /* Strings share a few large chunks, everything else is one block. */
+    while (NULL != db->strings)
+    {
+        dbc_chunk_t* chunk = db->strings;
+
+        db->strings = chunk->next;
+        os_free(chunk);
+    }
+
+    os_free(db->messages);
+    os_free(db->signals);
+    os_free(db->plans.masks);
+    os_free(db->dispatch);
+    os_free(db->muxes);
+    os_free(db->labels);
+    os_free(db->id_slots);
+    os_free(db->names);
+    os_memset(db, 0, sizeof(dbc_t));
+}
+
+static uint32 get_key(uint32 can_id, bool_t is_extended)
+{
+    /* Keeps 11-bit frames from ever hitting a 29-bit message. */
+    return (can_id & 0x1FFFFFFF) | ((IS_TRUE == is_extended) ? DBC_EXTENDED_FLAG : 0);
+}
+
+static uint32 get_pgn(uint32 can_id)
+{
+    uint32 pgn = (can_id >> 8) & 0x3FFFF;
 
-    if (NULL == dbc)
+    if (((pgn >> 8) & 0xFF) < J1939_PDU2_MIN_PF)
     {
-        return "";
+        pgn &= 0x3FF00;
     }
 
-    for (i = 0; i <= dbc->message_count; ++i)
-    {
-        if (dbc->messages[i].id == can_id)
-        {
-            message_t* msg = &dbc->messages[i];
-            int        n   = os_snprintf(result + pos, sizeof(result) - pos, "%s (%Xh)\n", msg->name, msg->id);
-            int        j;
+    return pgn;
+}
 
-            if (n > 0)
-            {
-                pos += n;
-            }
+static status_t grow(void** array, int* capacity, size_t element_size)
+{
+    int   new_capacity = (0 == *capacity) ? 64 : (*capacity * 2);
+    void* new_array    = os_realloc(*array, (size_t)new_capacity * element_size);
 
-            for (j = 0; j < msg->signal_count; ++j)
-            {
-                signal_t* signal    = &msg->signals[j];
-                uint64    raw_value = extract_raw_signal(data, signal->start_bit, signal->length, signal->endianness);
-                double    value     = (raw_value * signal->scale) + signal->offset;
-                int       k;
+    if (NULL == new_array)
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
 
-                n = os_snprintf(result + pos, sizeof(result) - pos, "  %s", signal->name);
-                if (n > 0)
-                {
-                    pos += n;
-                }
+    *array    = new_array;
+    *capacity = new_capacity;
 
-                for (k = 0; k <= 35 - os_strlen(signal->name); ++k)
-                {
-                    n = os_snprintf(result + pos, sizeof(result) - pos, " ");
-                    if (n > 0)
-                    {
-                        pos += n;
-                    }
-                }
+    return ALL_OK;
+}
 
-                n = os_snprintf(result + pos, sizeof(result) - pos, ": %f %s\n", value, signal->unit);
-                if (n > 0)
-                {
-                    pos += n;
-                }
-            }
-            result[sizeof(result) - 1] = '\0';
-            break;
-        }
-    }
+static uint32 hash_key(uint32 key)
+{
+    return (key * 0x9E3779B1u) ^ (key >> 16);
+}
+
+static uint32 hash_text(const char* text, size_t length)
+{
+    uint32 hash = 2166136261u;
+    size_t i;
 
-    if (0 == pos)
+    for (i = 0; i < length; ++i)
     {
-        return "";
+        hash ^= (uint8)text[i];
+        hash *= 16777619u;
     }
 
-    return result;
+    return hash;
 }
 
-status_t dbc_find_id_by_name(uint32* id, const char* search)
+static uint64 insert_signal(const dbc_plan_t* plan, int signal, uint64 raw_value, uint64 data)
 {
-    int i;
+    uint64 mask       = plan->masks[signal] << plan->shifts[signal];
+    bool_t is_swapped = plan->is_swapped[signal];
 
-    if ((NULL == dbc) || (NULL == search) || (NULL == id))
+    if (IS_TRUE == is_swapped)
     {
-        return OS_INVALID_ARGUMENT;
+        data = swap_bytes(data);
     }
 
-    char* lower_search = str_tolower(search);
-    if (NULL == lower_search)
+    data = (data & ~mask) | ((raw_value << plan->shifts[signal]) & mask);
+
+    if (IS_TRUE == is_swapped)
     {
-        return OS_MEMORY_ALLOCATION_ERROR;
+        data = swap_bytes(data);
     }
 
-    for (i = 0; i < dbc->message_count; ++i)
+    return data;
+}
+
+static void insert_slot(dbc_slot_t* slots, uint32 num_slots, uint32 key, message_t* message)
+{
+    uint32 mask = num_slots - 1;
+    uint32 slot = hash_key(key) & mask;
+
+    while (NULL != slots[slot].message)
     {
-        char* lower_name = str_tolower(dbc->messages[i].name);
-        if (NULL == lower_name)
+        /* The first definition wins, as with the former linear scan. */
+        if (key == slots[slot].key)
         {
-            os_free(lower_search);
-            return OS_MEMORY_ALLOCATION_ERROR;
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    slots[slot].key     = key;
+    slots[slot].message = message;
+}
+
+static char* intern(dbc_loader_t* loader, dbc_span_t text)
+{
+    uint32 mask;
+    uint32 slot;
+    char*  copy;
+
+    if (((loader->num_strings + 1) * 2) > loader->size)
+    {
+        uint32 size    = (0 == loader->size) ? 1024 : (loader->size * 2);
+        char** strings = os_calloc(size, sizeof(char*));
+        uint32 i;
+
+        if (NULL == strings)
+        {
+            return NULL;
         }
 
-        if (os_strstr(lower_name, lower_search) != NULL)
+        for (i = 0; i < loader->size; ++i)
         {
-            *id = dbc->messages[i].id;
-            os_free(lower_name);
-            os_free(lower_search);
-            return ALL_OK;
+            if (NULL != loader->strings[i])
+            {
+                slot = hash_text(loader->strings[i], os_strlen(loader->strings[i])) & (size - 1);
+                while (NULL != strings[slot])
+                {
+                    slot = (slot + 1) & (size - 1);
+                }
+                strings[slot] = loader->strings[i];
+            }
         }
 
-        os_free(lower_name);
+        os_free(loader->strings);
+        loader->strings = strings;
+        loader->size    = size;
     }
 
-    os_free(lower_search);
-    return ITEM_NOT_FOUND;
+    mask = loader->size - 1;
+    slot = hash_text(text.start, text.length) & mask;
+
+    while (NULL != loader->strings[slot])
+    {
+        copy = loader->strings[slot];
+        if ((0 == os_strncmp(copy, text.start, text.length)) && ('\0' == copy[text.length]))
+        {
+            return copy;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    copy = arena_alloc(loader->db, text.length + 1);
+    if (NULL == copy)
+    {
+        return NULL;
+    }
+
+    os_memcpy(copy, text.start, text.length);
+    copy[text.length] = '\0';
+
+    loader->strings[slot] = copy;
+    loader->num_strings  += 1;
+
+    return copy;
 }
 
-status_t dbc_load(const char* filename)
+static bool_t is_in_range(const dbc_t* db, uint32 can_id)
 {
-    FILE_t*    file;
-    char       line[1024]      = { 0 };
-    message_t* current_message = NULL;
+    return ((can_id >= db->first_id) && (can_id <= db->last_id)) ? IS_TRUE : IS_FALSE;
+}
 
-    dbc_unload();
+static status_t load_database(dbc_t* db, const char* filename)
+{
+    dbc_loader_t loader = { 0 };
+    const char*  data;
+    const char*  line;
+    const char*  end;
+    uint32       size;
+    status_t     status = ALL_OK;
+
+    data = (const char*)os_map_file(filename, &size);
+    if (NULL == data)
+    {
+        return OS_FILE_NOT_FOUND;
+    }
+
+    loader.db = db;
 
-    if (NULL == dbc)
+    line = data;
+    end  = data + size;
+    while ((line < end) && (ALL_OK == status))
     {
-        dbc = os_calloc(1, sizeof(dbc_t));
-        if (NULL == dbc)
+        const char* line_end = line;
+
+        while ((line_end < end) && ('\n' != *line_end))
         {
-            return OS_MEMORY_ALLOCATION_ERROR;
+            line_end++;
         }
+
+        status = parse_line(&loader, line, line_end);
+        line   = (line_end < end) ? (line_end + 1) : end;
     }
-    else
+
+    os_unmap_file(data, size);
+
+    if (ALL_OK == status)
     {
-        dbc->message_count = 0;
-        dbc->messages = NULL;
+        status = compile_plans(db);
     }
 
-    file = os_fopen(filename, "r");
+    if (ALL_OK == status)
+    {
+        status = build_index(db);
+    }
 
-    if (NULL == file)
+    if (ALL_OK == status)
     {
-        return OS_FILE_NOT_FOUND;
+        status = build_names(db);
     }
 
-    while (os_fgets(line, sizeof(line), file) != NULL)
+    if (ALL_OK == status)
     {
-        char* trimmed_line = trim_whitespace(line);
+        status = build_dispatch(db);
+    }
+
+    if (ALL_OK == status)
+    {
+        resolve_labels(&loader);
+    }
+
+    os_free(loader.strings);
+    os_free(loader.groups);
+
+    return status;
+}
 
-        if (starts_with(trimmed_line, "BO_ "))
+static status_t merge_index(void)
+{
+    int count = 0;
+    int pass, i, j;
+
+    os_free(registry.id_slots);
+    os_free(registry.pgn_slots);
+    registry.id_slots   = NULL;
+    registry.pgn_slots  = NULL;
+    registry.num_slots  = 0;
+    registry.num_active = 0;
+
+    /* Those bound to the selected interface first, then the unbound. */
+    for (pass = 0; pass < 2; ++pass)
+    {
+        for (i = 0; i < DBC_MAX_DATABASES; ++i)
         {
-            message_t* temp = os_realloc(dbc->messages, sizeof(message_t) * (dbc->message_count + 1));
-            if (NULL == temp)
+            dbc_t* db = registry.databases[i];
+
+            if (NULL == db)
             {
-                os_fclose(file);
-                dbc_unload();
-                return OS_MEMORY_ALLOCATION_ERROR;
+                continue;
             }
 
-            dbc->messages   = temp;
-            current_message = &dbc->messages[dbc->message_count];
-            os_memset(current_message, 0, sizeof(message_t));
-
-            dbc->message_count += 1;
-            parse_message_line(trimmed_line, current_message);
+            if (((0 == pass) && ('\0' != db->can_interface[0]) && (0 == os_strcmp(db->can_interface, registry.can_interface))) ||
+                ((1 == pass) && ('\0' == db->can_interface[0])))
+            {
+                registry.active[registry.num_active] = db;
+                registry.num_active                 += 1;
+                count                               += db->message_count;
+            }
         }
-        else if (starts_with(trimmed_line, "SG_ ") && current_message != NULL)
+    }
+
+    if (0 == registry.num_active)
+    {
+        return ALL_OK;
+    }
+
+    registry.num_slots = table_size(count);
+    registry.id_slots  = os_calloc(registry.num_slots, sizeof(dbc_slot_t));
+    registry.pgn_slots = os_calloc(registry.num_slots, sizeof(dbc_slot_t));
+    if ((NULL == registry.id_slots) || (NULL == registry.pgn_slots))
+    {
+        os_free(registry.id_slots);
+        os_free(registry.pgn_slots);
+        registry.id_slots  = NULL;
+        registry.pgn_slots = NULL;
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    for (i = 0; i < registry.num_active; ++i)
+    {
+        dbc_t* db = registry.active[i];
+
+        for (j = 0; j < db->message_count; ++j)
         {
-            signal_t* temp = os_realloc(current_message->signals, sizeof(signal_t) * (current_message->signal_count + 1));
-            if (NULL == temp)
+            message_t* message = &db->messages[j];
+
+            if (IS_FALSE == is_in_range(db, message->id))
             {
-                os_fclose(file);
-                dbc_unload();
-                return OS_MEMORY_ALLOCATION_ERROR;
+                continue;
             }
 
-            current_message->signals = temp;
-            signal_t* current_signal = &current_message->signals[current_message->signal_count];
-            os_memset(current_signal, 0, sizeof(signal_t));
+            insert_slot(registry.id_slots, registry.num_slots, get_key(message->id, message->is_extended), message);
 
-            current_message->signal_count += 1;
-            parse_signal_line(trimmed_line, current_signal);
+            if (IS_TRUE == message->is_extended)
+            {
+                insert_slot(registry.pgn_slots, registry.num_slots, get_pgn(message->id), message);
+            }
         }
     }
 
-    os_fclose(file);
     return ALL_OK;
 }
 
-void dbc_print(void)
+static dbc_span_t next_field(const char** pos, const char* end, char delimiter)
 {
-    int i, j;
+    dbc_span_t  field;
+    const char* cursor = skip_spaces(*pos, end);
 
-    if (NULL == dbc)
+    /* A space delimiter ends the field at any whitespace. */
+    field.start = cursor;
+    while ((cursor < end) && (delimiter != *cursor) && ((' ' != delimiter) || (! os_isspace((unsigned char)*cursor))))
     {
-        return;
+        cursor++;
     }
 
-    os_printf("DBC File contains %d messages\n", dbc->message_count);
-    for (i = 0; i < dbc->message_count; ++i)
+    field.length = (size_t)(cursor - field.start);
+    while ((field.length > 0) && os_isspace((unsigned char)field.start[field.length - 1]))
     {
-        const message_t *msg = &dbc->messages[i];
-        os_printf("Message %d: ID=%u, Name=%s, DLC=%u, Transmitter=%s\n",
-            i + 1, msg->id, msg->name, msg->dlc, msg->transmitter);
-        os_printf("  Contains %d signals\n", msg->signal_count);
-        for (j = 0; j < msg->signal_count; ++j)
-        {
-            const signal_t *sig = &msg->signals[j];
-            os_printf("  Signal %d: Name=%s, StartBit=%d, Length=%d, Endianness=%d, Scale=%.6f, Offset=%.2f, Min=%.2f, Max=%.2f, Unit=%s, Receiver=%s\n",
-                j + 1, sig->name, sig->start_bit, sig->length, sig->endianness, sig->scale, sig->offset, sig->min_value, sig->max_value, sig->unit, sig->receiver);
-        }
+        field.length--;
     }
+
+    *pos = (cursor < end) ? (cursor + 1) : end;
+
+    return field;
 }
 
-void dbc_unload(void)
+static dbc_span_t next_quoted(const char** pos, const char* end)
 {
-    int i, j;
+    dbc_span_t  text;
+    const char* cursor;
 
-    if (NULL == dbc)
+    /* Taken as is, spaces included. */
+    next_field(pos, end, '"');
+
+    cursor     = *pos;
+    text.start = cursor;
+    while ((cursor < end) && ('"' != *cursor))
     {
-        return;
+        cursor++;
     }
 
-    for (i = 0; i < dbc->message_count; ++i)
+    text.length = (size_t)(cursor - text.start);
+    *pos        = (cursor < end) ? (cursor + 1) : end;
+
+    return text;
+}
+
+static double parse_double(dbc_span_t text, double default_value)
+{
+    char number[DBC_NUMBER_SIZE];
+
+    if ((0 == text.length) || (text.length >= sizeof(number)))
     {
-        message_t* msg = &dbc->messages[i];
+        return default_value;
+    }
 
-        os_free(msg->name);
-        os_free(msg->transmitter);
+    os_memcpy(number, text.start, text.length);
+    number[text.length] = '\0';
 
-        for (j = 0; j < msg->signal_count; ++j)
-        {
-            signal_t* sig = &msg->signals[j];
-            os_free(sig->name);
-            os_free(sig->unit);
-            os_free(sig->receiver);
-        }
+    return os_atof(number);
+}
+
+static status_t parse_line(dbc_loader_t* loader, const char* line, const char* end)
+{
+    line = skip_spaces(line, end);
 
-        os_free(msg->signals);
+    if (IS_TRUE == starts_with(line, end, "BO_ "))
+    {
+        return parse_message(loader, line + 4, end);
+    }
+    else if ((IS_TRUE == starts_with(line, end, "SG_ ")) && (loader->db->message_count > 0) && (IS_FALSE == loader->is_skipping))
+    {
+        return parse_signal(loader, line + 4, end);
+    }
+    else if (IS_TRUE == starts_with(line, end, "VAL_ "))
+    {
+        return parse_values(loader, line + 5, end);
     }
 
-    os_free(dbc->messages);
-    dbc->message_count = 0;
-    dbc->messages      = NULL;
+    return ALL_OK;
 }
 
-static uint64 extract_raw_signal(uint64 can_frame, uint8 start_bit, uint8 length, endian_t endianness)
+static status_t parse_message(dbc_loader_t* loader, const char* pos, const char* end)
 {
-    uint64 mask = (1ULL << length) - 1;
-    uint64 raw_value;
+    dbc_t*     db = loader->db;
+    message_t* message;
+    dbc_span_t id;
+    dbc_span_t name;
+    dbc_span_t dlc;
+    uint32     raw_id;
+
+    id   = next_field(&pos, end, ' ');
+    name = next_field(&pos, end, ':');
+    dlc  = next_field(&pos, end, ' ');
+
+    /* The placeholder would otherwise shadow ID 0 and PGN 0. */
+    raw_id              = (uint32)parse_uint(id);
+    loader->is_skipping = (DBC_INDEPENDENT_ID == raw_id) ? IS_TRUE : IS_FALSE;
+    if (IS_TRUE == loader->is_skipping)
+    {
+        return ALL_OK;
+    }
 
-    if (ENDIANNESS_MOTOROLA == endianness)
+    if (db->message_count == loader->messages_capacity)
     {
-        int bit_pos = 64 - (start_bit + length);
-        raw_value = (can_frame >> bit_pos) & mask;
+        if (ALL_OK != grow((void**)&db->messages, &loader->messages_capacity, sizeof(message_t)))
+        {
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
     }
-    else
+
+    message = &db->messages[db->message_count];
+    os_memset(message, 0, sizeof(message_t));
+
+    message->id          = (unsigned int)(raw_id & 0x1FFFFFFF);
+    message->is_extended = (raw_id & DBC_EXTENDED_FLAG) ? IS_TRUE : IS_FALSE;
+    message->dlc         = (unsigned int)parse_uint(dlc);
+    message->name        = intern(loader, name);
+    message->transmitter = intern(loader, rest_of_line(pos, end));
+
+    if ((NULL == message->name) || (NULL == message->transmitter))
     {
-        raw_value = (can_frame >> start_bit) & mask;
+        return OS_MEMORY_ALLOCATION_ERROR;
     }
 
-    return raw_value;
+    db->message_count += 1;
+
+    return ALL_OK;
 }
 
-static void parse_message_line(char *line, message_t *message)
+static status_t parse_signal(dbc_loader_t* loader, const char* pos, const char* end)
 {
-    char* token;
-    char* rest = line;
+    dbc_t*     db = loader->db;
+    signal_t*  signal;
+    dbc_span_t name;
+    dbc_span_t mux;
+    dbc_span_t unit;
+
+    if (db->signal_count == loader->signals_capacity)
+    {
+        if (ALL_OK != grow((void**)&db->signals, &loader->signals_capacity, sizeof(signal_t)))
+        {
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+
+    signal = &db->signals[db->signal_count];
+    os_memset(signal, 0, sizeof(signal_t));
+
+    /* name [multiplexer] : start|length@endianness sign (scale,offset)
+     * [min|max] "unit" receivers
+     */
+    name = next_field(&pos, end, ' ');
+    mux  = next_field(&pos, end, ':');
+
+    /* M marks the multiplexer, m<n> a signal present for value n only. */
+    signal->mux_value = -1;
+    if ((1 == mux.length) && ('M' == mux.start[0]))
+    {
+        signal->is_multiplexer = IS_TRUE;
+    }
+    else if ((mux.length > 1) && ('m' == mux.start[0]))
+    {
+        mux.start        += 1;
+        mux.length       -= 1;
+        signal->mux_value = (int)parse_uint(mux);
+    }
+
+    signal->start_bit = (int)parse_uint(next_field(&pos, end, '|'));
+    signal->length    = (int)parse_uint(next_field(&pos, end, '@'));
+
+    if ((pos + 1) < end)
+    {
+        signal->endianness = ('0' == pos[0]) ? ENDIANNESS_MOTOROLA : ENDIANNESS_INTEL;
+        signal->is_signed  = ('-' == pos[1]) ? IS_TRUE : IS_FALSE;
+        pos += 2;
+    }
+
+    next_field(&pos, end, '(');
+    signal->scale  = (float)parse_double(next_field(&pos, end, ','), 1.0);
+    signal->offset = (float)parse_double(next_field(&pos, end, ')'), 0.0);
 
-    os_strtokr(rest, " ", &rest);
+    next_field(&pos, end, '[');
+    signal->min_value = (float)parse_double(next_field(&pos, end, '|'), 0.0);
+    signal->max_value = (float)parse_double(next_field(&pos, end, ']'), 0.0);
 
-    token                = os_strtokr(rest, " ", &rest);
-    message->id          = os_strtoul(token, NULL, 10) & 0x7FFFFFFF;
-    token                = os_strtokr(rest, ":", &rest);
-    message->name        = os_strdup(token);
-    token                = os_strtokr(rest, " ", &rest);
-    message->dlc         = os_atoi(token);
-    message->transmitter = os_strdup(trim_whitespace(rest));
+    unit = next_quoted(&pos, end);
+
+    signal->name     = intern(loader, name);
+    signal->unit     = intern(loader, unit);
+    signal->receiver = intern(loader, rest_of_line(pos, end));
+
+    if ((NULL == signal->name) || (NULL == signal->unit) || (NULL == signal->receiver))
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    db->signal_count                                  += 1;
+    db->messages[db->message_count - 1].signal_count += 1;
+
+    return ALL_OK;
 }
 
-static void parse_signal_line(char *line, signal_t *signal)
+static unsigned long parse_uint(dbc_span_t text)
 {
-    char* token;
-    char* rest = line;
+    char number[DBC_NUMBER_SIZE];
 
-    signal->name      = NULL;
-    signal->unit      = NULL;
-    signal->receiver  = NULL;
-    signal->start_bit = 0;
-    signal->length    = 0;
-    signal->scale     = 1.0;
-    signal->offset    = 0.0;
-    signal->min_value = 0.0;
-    signal->max_value = 0.0;
-    signal->endianness = 0;
+    if ((0 == text.length) || (text.length >= sizeof(number)))
+    {
+        return 0;
+    }
 
-    os_strtokr(rest, " ", &rest);
+    os_memcpy(number, text.start, text.length);
+    number[text.length] = '\0';
+
+    return os_strtoul(number, NULL, 10);
+}
 
-    token = os_strtokr(rest, " ", &rest);
-    if (token != NULL)
+static status_t parse_values(dbc_loader_t* loader, const char* pos, const char* end)
+{
+    dbc_t*       db   = loader->db;
+    dbc_group_t* group;
+    dbc_span_t   id   = next_field(&pos, end, ' ');
+    dbc_span_t   name = next_field(&pos, end, ' ');
+    uint32       raw_id;
+
+    /* Those of environment variables have no message ID. */
+    if ((0 == id.length) || (id.start[0] < '0') || (id.start[0] > '9'))
     {
-        signal->name = os_strdup(token);
+        return ALL_OK;
     }
 
-    token = os_strtokr(rest, "|", &rest);
-    if (token != NULL)
+    raw_id = (uint32)parse_uint(id);
+    if (DBC_INDEPENDENT_ID == raw_id)
     {
-        signal->start_bit = os_atoi(token);
-        token = os_strtokr(rest, "@", &rest);
-        if (token != NULL)
-        {
-            signal->length = os_atoi(token);
-            if (*rest != '\0')
-            {
-                signal->endianness = os_atoi(rest);
-                rest++;
-            }
-        }
+        return ALL_OK;
     }
 
-    token = os_strtokr(rest, "(", &rest);
-    if (token != NULL)
+    if (loader->num_groups == loader->groups_capacity)
     {
-        token = os_strtokr(rest, ",", &rest);
-        if (token != NULL)
+        if (ALL_OK != grow((void**)&loader->groups, &loader->groups_capacity, sizeof(dbc_group_t)))
         {
-            signal->scale = os_atof(token);
-            token         = os_strtokr(rest, ")", &rest);
-            if (token != NULL)
-            {
-                signal->offset = os_atof(token);
-            }
+            return OS_MEMORY_ALLOCATION_ERROR;
         }
     }
 
-    token = os_strtokr(rest, "[", &rest);
-    if (token != NULL)
+    group         = &loader->groups[loader->num_groups];
+    group->id     = get_key(raw_id, (raw_id & DBC_EXTENDED_FLAG) ? IS_TRUE : IS_FALSE);
+    group->signal = intern(loader, name);
+    group->first  = db->label_count;
+    group->count  = 0;
+
+    if (NULL == group->signal)
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    for (pos = skip_spaces(pos, end); (pos < end) && (';' != *pos); pos = skip_spaces(pos, end))
     {
-        token = os_strtokr(rest, "|", &rest);
-        if (token != NULL)
+        dbc_label_t* label;
+        dbc_span_t   value = next_field(&pos, end, ' ');
+
+        if (db->label_count == loader->labels_capacity)
         {
-            signal->min_value = os_atof(token);
-            token             = os_strtokr(rest, "]", &rest);
-            if (token != NULL)
+            if (ALL_OK != grow((void**)&db->labels, &loader->labels_capacity, sizeof(dbc_label_t)))
             {
-                signal->max_value = os_atof(token);
+                return OS_MEMORY_ALLOCATION_ERROR;
             }
         }
-    }
 
-    os_strtokr(rest, "\"", &rest);
-    if (rest[0] == '\"')
-    {
-        signal->unit = os_strdup("");
-        rest++;
-    }
-    else
-    {
-        char* end = os_strtokr(rest, "\"", &rest);
-        if (end != NULL)
+        label        = &db->labels[db->label_count];
+        label->label = intern(loader, next_quoted(&pos, end));
+
+        if ((value.length > 1) && ('-' == value.start[0]))
         {
-            signal->unit = os_strdup(end);
+            value.start  += 1;
+            value.length -= 1;
+            label->value  = -(sint64)parse_uint(value);
         }
         else
         {
-            signal->unit = os_strdup("");
+            label->value = (sint64)parse_uint(value);
         }
-    }
 
-    while (*rest == ' ')
-    {
-        rest++;
-    }
+        if (NULL == label->label)
+        {
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
 
-    token = os_strtokr(rest, " ", &rest);
-    if (token != NULL)
-    {
-        signal->receiver = os_strdup(token);
+        db->label_count += 1;
+        group->count     += 1;
     }
-    else
+
+    loader->num_groups += 1;
+
+    return ALL_OK;
+}
+
+static void resolve_labels(dbc_loader_t* loader)
+{
+    dbc_t* db = loader->db;
+    int    i, j;
+
+    for (i = 0; i < loader->num_groups; ++i)
     {
-        signal->receiver = os_strdup("");
+        const dbc_group_t* group   = &loader->groups[i];
+        message_t*         message = find_slot(db->id_slots, db->num_slots, group->id);
+
+        if ((NULL == message) || (0 == group->count))
+        {
+            continue;
+        }
+
+        /* Names are interned, so comparing pointers is enough. */
+        for (j = 0; j < message->signal_count; ++j)
+        {
+            if (message->signals[j].name == group->signal)
+            {
+                os_qsort(&db->labels[group->first], (size_t)group->count, sizeof(dbc_label_t), compare_labels);
+                message->signals[j].labels      = &db->labels[group->first];
+                message->signals[j].label_count = group->count;
+                break;
+            }
+        }
     }
 }
 
-static bool_t starts_with(const char *str, const char *prefix)
+static dbc_span_t rest_of_line(const char* pos, const char* end)
 {
-    bool_t status;
-    size_t len_prefix = os_strlen(prefix);
-    size_t len_str    = os_strlen(str);
+    dbc_span_t rest;
+
+    rest.start  = skip_spaces(pos, end);
+    rest.length = (size_t)(end - rest.start);
 
-    if (len_str < len_prefix)
+    while ((rest.length > 0) && os_isspace((unsigned char)rest.start[rest.length - 1]))
     {
-        status = IS_FALSE;
+        rest.length--;
     }
-    else
+
+    return rest;
+}
+
+static const char* skip_spaces(const char* pos, const char* end)
+{
+    while ((pos < end) && os_isspace((unsigned char)*pos))
     {
-        status = (bool_t)(os_strncmp(prefix, str, len_prefix) == 0);
+        pos++;
     }
 
-    return status;
+    return pos;
 }
 
-static char* str_tolower(const char* str)
+static bool_t starts_with(const char* str, const char* end, const char* prefix)
 {
-    int   i;
-    char* lower_str;
+    size_t len_prefix = os_strlen(prefix);
 
-    if (NULL == str)
+    if ((size_t)(end - str) < len_prefix)
     {
-        return NULL;
+        return IS_FALSE;
     }
 
-    lower_str = os_strdup(str);
-    if (NULL == lower_str)
-    {
-        return NULL;
-    }
+    return (0 == os_strncmp(prefix, str, len_prefix)) ? IS_TRUE : IS_FALSE;
+}
 
-    for (i = 0; lower_str[i]; i++)
-    {
-        lower_str[i] = os_tolower((unsigned char)lower_str[i]);
-    }
+static uint64 swap_bytes(uint64 data)
+{
+    data = ((data & 0x00FF00FF00FF00FFULL) << 8)  | ((data >> 8)  & 0x00FF00FF00FF00FFULL);
+    data = ((data & 0x0000FFFF0000FFFFULL) << 16) | ((data >> 16) & 0x0000FFFF0000FFFFULL);
 
-    return lower_str;
+    return (data << 32) | (data >> 32);
 }
 
-static char* trim_whitespace(char *str)
+static uint32 table_size(int count)
 {
-    char *end;
+    uint32 size = 16;
 
-    if (NULL == str)
+    /* At most half full, so probe sequences stay short. */
+    while (size < ((uint32)count * 2))
     {
-        return "";
+        size *= 2;
     }
 
-    while (os_isspace((unsigned char)*str))
-    {
-        str++;
-    }
+    return size;
+}
 
-    if (0  == *str)
-    {
-        return str;
-    }
+static bool_t to_lower(char* dest, const char* src, size_t size)
+{
+    size_t i;
 
-    end = str + os_strlen(str) - 1;
-    while ((end > str) && (os_isspace((unsigned char)*end)))
+    for (i = 0; i < size; ++i)
     {
-        end--;
+        dest[i] = (char)os_tolower((unsigned char)src[i]);
+        if ('\0' == src[i])
+        {
+            return IS_TRUE;
+        }
     }
 
-    *(end + 1) = 0;
-
-    return str;
+    return IS_FALSE;
 }
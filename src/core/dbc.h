@@ -13,6 +13,11 @@
 #include "core.h"
 #include "os.h"
 
+#define DBC_INTERFACE_SIZE 32
+#define DBC_MAX_DATABASES  8
+#define DBC_MAX_VALUES     64
+#define DBC_NAME_SIZE      256
+
 typedef enum
 {
     ENDIANNESS_MOTOROLA = 0,
@@ -22,19 +27,54 @@ typedef enum
 
 typedef struct
 {
-    char*    name;
-    int      start_bit;
-    int      length;
-    endian_t endianness;
-    float    scale;
-    float    offset;
-    float    min_value;
-    float    max_value;
-    char*    unit;
-    char*    receiver;
+    sint64      value;
+    const char* label;
+
+} dbc_label_t;
+
+typedef struct
+{
+    char*        name;
+    int          start_bit;
+    int          length;
+    endian_t     endianness;
+    float        scale;
+    float        offset;
+    float        min_value;
+    float        max_value;
+    char*        unit;
+    char*        receiver;
+    bool_t       is_signed;
+    bool_t       is_multiplexer;
+    int          mux_value;   /* Active only for this multiplexer value, -1 for always. */
+    int          label_count;
+    dbc_label_t* labels;      /* Sorted by value. */
 
 } signal_t;
 
+/* Compiled by dbc_load(), one element per signal in each array.  Frames are
+ * byte-swapped first where is_swapped is set, then shifted right and
+ * masked; sign_bits holds the sign bit of signed signals.
+ */
+typedef struct
+{
+    uint64* masks;
+    uint64* sign_bits;
+    double* scales;
+    double* offsets;
+    uint8*  shifts;
+    uint8*  is_swapped;
+
+} dbc_plan_t;
+
+typedef struct
+{
+    uint32 value;
+    int    first; /* Index into the message's dispatch list. */
+    int    count;
+
+} dbc_mux_t;
+
 typedef struct
 {
     char*        name;
@@ -43,20 +83,107 @@ typedef struct
     char*        transmitter;
     int          signal_count;
     signal_t*    signals;
+    bool_t       is_extended;
+    dbc_plan_t   plan;
+    int          mux_signal;  /* Index of the multiplexer, -1 if there's none. */
+    int*         dispatch;    /* Always active signals, then each mux group. */
+    int          plain_count;
+    int          mux_count;
+    dbc_mux_t*   muxes;       /* Sorted by value. */
 
 } message_t;
 
 typedef struct
 {
-    int        message_count;
-    message_t* messages;
+    uint32     key;
+    message_t* message; /* NULL if the slot is free. */
+
+} dbc_slot_t;
+
+typedef enum
+{
+    DBC_MATCH_EXACT = 0,
+    DBC_MATCH_PREFIX,
+    DBC_MATCH_SUBSTRING
+
+} dbc_match_t;
+
+typedef struct
+{
+    const char* name;    /* Lower-cased message name. */
+    int         message; /* Index into messages. */
+
+} dbc_name_t;
+
+typedef struct dbc_chunk
+{
+    struct dbc_chunk* next;
+    size_t            used;
+    size_t            size;
+
+} dbc_chunk_t;
+
+typedef struct
+{
+    int          message_count;
+    message_t*   messages;
+    int          signal_count;
+    signal_t*    signals;  /* Of all messages, in order. */
+    dbc_plan_t   plans;    /* Of all signals, each message's plan points into it. */
+    int*         dispatch; /* Of all messages, likewise. */
+    dbc_mux_t*   muxes;
+    int          label_count;
+    dbc_label_t* labels;
+    dbc_chunk_t* strings;  /* Interned names, units and receivers. */
+    dbc_slot_t*  id_slots;
+    uint32       num_slots;
+    dbc_name_t*  names;    /* Sorted by name. */
+    char         can_interface[DBC_INTERFACE_SIZE]; /* Bound to, empty for any. */
+    uint32       first_id;
+    uint32       last_id;
 
 } dbc_t;
 
-const char* dbc_decode(uint32 can_id, uint64 data);
-status_t    dbc_find_id_by_name(uint32* id, const char* search);
-status_t    dbc_load(const char *filename);
-void        dbc_print(void);
-void        dbc_unload(void);
+typedef struct
+{
+    int         signal; /* Index into the message's signals. */
+    uint64      raw;
+    double      value;
+    const char* label;  /* From the value table, or NULL. */
+
+} dbc_value_t;
+
+/* Frame data is passed with the first byte in the lowest eight bits, as
+ * returned by can_read().  dbc_decode_batch() fills one row per signal,
+ * multiplexed ones included regardless of the multiplexer value.
+ *
+ * dbc_encode() updates data in place from the signal and value of each
+ * element, leaving all other bits as they are.  Values are clamped to the
+ * signal's range, and multiplexed signals also set the multiplexer.
+ *
+ * Several databases can be open at once, each bound to an interface and
+ * a range of CAN-IDs.  Lookups go through those bound to the selected
+ * interface first, then through those bound to none; the first database
+ * defining an ID wins.  dbc_load() replaces all of them with one.
+ *
+ * A CAN-ID above 0x7FF, or one with bit 31 set as in the DBC file, is
+ * looked up among extended messages only, any other among standard ones.
+ */
+status_t         dbc_bind(uint32 handle, const char* can_interface, uint32 first_id, uint32 last_id);
+status_t         dbc_close(uint32 handle);
+const char*      dbc_decode(uint32 can_id, uint64 data);
+void             dbc_decode_batch(const message_t* message, const uint64* frames, uint32 num_frames, double* values);
+int              dbc_decode_values(const message_t* message, uint64 data, dbc_value_t* values, int max_values);
+status_t         dbc_encode(const message_t* message, const dbc_value_t* values, int num_values, uint64* data);
+const char*      dbc_find_label(const signal_t* signal, sint64 value);
+const message_t* dbc_find_message(uint32 can_id);
+int              dbc_find_messages(const char* search, dbc_match_t match, const message_t** messages, int max_messages);
+status_t         dbc_find_id_by_name(uint32* id, const char* search);
+int              dbc_find_signal(const message_t* message, const char* name);
+status_t         dbc_load(const char *filename);
+status_t         dbc_open(const char* filename, uint32* handle);
+void             dbc_print(void);
+status_t         dbc_select_interface(const char* can_interface);
+void             dbc_unload(void);
 
 #endif /* DBC_H */
@@ -10,6 +10,45 @@
 #include "os.h"
 #include "core.h"
 #include "dict.h"
+#include "eds.h"
+
+typedef struct dict_span
+{
+    uint16 index_start;
+    uint16 index_end;
+    uint32 first_sub;
+    uint32 num_subs;
+
+} dict_span_t;
+
+typedef struct dict_sub_span
+{
+    uint8       sub_index_start;
+    uint8       sub_index_end;
+    const char* description;
+
+} dict_sub_span_t;
+
+static const eds_entry_t* find_eds_entry(uint16 index, uint8 sub_index);
+static const char*        lookup_builtin(uint16 index, uint8 sub_index);
+static void               build_index(void);
+static void               add_span(uint16 index_start, uint16 index_end);
+static void               get_bounds(const dict_entry_t* entry, uint16* index_start, uint16* index_end, uint8* sub_index_start, uint8* sub_index_end);
+static int                compare_bounds(const void* a, const void* b);
+
+static dict_span_t*       spans;
+static uint32             num_spans;
+static uint32             spans_capacity;
+static dict_sub_span_t*   sub_spans;
+static uint32             num_sub_spans;
+static uint32             sub_spans_capacity;
+static bool_t             is_indexed;
+static const eds_entry_t* eds_entries;
+static uint16             num_eds_entries;
+static const char*        eds_strings;
+
+/* Indexed by access_type_t. */
+static const char* const access_names[] = { "ro", "wo", "rw", "rwr", "rww", "const" };
 
 static const dict_entry_t dictionary[] =
 {
@@ -203,31 +242,333 @@ static const dict_entry_t dictionary[] =
 
 const char* dict_lookup(uint16 index, uint8 sub_index)
 {
-    size_t i;
+    const eds_entry_t* entry = find_eds_entry(index, sub_index);
 
-    for (i = 0; i < sizeof(dictionary) / sizeof(dict_entry_t); ++i)
+    if ((NULL != entry) && ('\0' != eds_strings[entry->ParameterName]))
     {
-        uint16 index_start     = dictionary[i].index_start;
-        uint16 index_end       = dictionary[i].index_end;
-        uint8  sub_index_start = dictionary[i].sub_index_start;
-        uint8  sub_index_end   = dictionary[i].sub_index_end;
+        return eds_strings + entry->ParameterName;
+    }
+
+    return lookup_builtin(index, sub_index);
+}
+
+bool_t dict_get_meta(uint16 index, uint8 sub_index, dict_meta_t* meta)
+{
+    const eds_entry_t* entry = find_eds_entry(index, sub_index);
+
+    if (NULL == meta)
+    {
+        return IS_FALSE;
+    }
+
+    os_memset(meta, 0, sizeof(dict_meta_t));
+    meta->name = dict_lookup(index, sub_index);
 
-        if (sub_index_end < sub_index_start)
+    if (NULL != entry)
+    {
+        if (entry->AccessType < (sizeof(access_names) / sizeof(access_names[0])))
         {
-            sub_index_end = sub_index_start;
+            meta->access = access_names[entry->AccessType];
         }
 
-        if (index_end < index_start)
+        meta->data_type     = entry->DataType;
+        meta->low_limit     = entry->LowLimit;
+        meta->high_limit    = entry->HighLimit;
+        meta->default_value = entry->DefaultValue;
+        meta->is_from_eds   = IS_TRUE;
+    }
+
+    return ((NULL != meta->name) || (NULL != entry)) ? IS_TRUE : IS_FALSE;
+}
+
+void dict_set_eds(const eds_entry_t* entries, uint16 num_entries, const char* strings)
+{
+    /* Sorted by index and sub-index, see eds.c. */
+    eds_entries     = (NULL != strings) ? entries : NULL;
+    num_eds_entries = (NULL != eds_entries) ? num_entries : 0;
+    eds_strings     = strings;
+}
+
+void dict_deinit(void)
+{
+    os_free(spans);
+    os_free(sub_spans);
+
+    spans              = NULL;
+    sub_spans          = NULL;
+    num_spans          = 0;
+    spans_capacity     = 0;
+    num_sub_spans      = 0;
+    sub_spans_capacity = 0;
+    is_indexed         = IS_FALSE;
+
+    dict_set_eds(NULL, 0, NULL);
+}
+
+static const eds_entry_t* find_eds_entry(uint16 index, uint8 sub_index)
+{
+    uint32 key  = ((uint32)index << 8) | sub_index;
+    uint32 low  = 0;
+    uint32 high = num_eds_entries;
+
+    while (low < high)
+    {
+        uint32 middle = low + ((high - low) / 2);
+        uint32 middle_key = ((uint32)eds_entries[middle].Index << 8) | eds_entries[middle].SubIndex;
+
+        if (middle_key < key)
         {
-            index_end = index_start;
+            low = middle + 1;
         }
-
-        if (index >= index_start && index <= index_end &&
-            sub_index >= sub_index_start && sub_index <= sub_index_end)
+        else
         {
-            return dictionary[i].description;
+            high = middle;
         }
     }
 
+    if ((low < num_eds_entries) && (index == eds_entries[low].Index) && (sub_index == eds_entries[low].SubIndex))
+    {
+        return &eds_entries[low];
+    }
+
     return NULL;
 }
+
+static const char* lookup_builtin(uint16 index, uint8 sub_index)
+{
+    const dict_span_t*     span;
+    const dict_sub_span_t* subs;
+    uint32                 low  = 0;
+    uint32                 high;
+
+    if (IS_FALSE == is_indexed)
+    {
+        build_index();
+    }
+
+    high = num_spans;
+    while (low < high)
+    {
+        uint32 middle = low + ((high - low) / 2);
+
+        if (spans[middle].index_end < index)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if ((low == num_spans) || (index < spans[low].index_start))
+    {
+        return NULL;
+    }
+
+    span = &spans[low];
+    subs = &sub_spans[span->first_sub];
+    low  = 0;
+    high = span->num_subs;
+
+    while (low < high)
+    {
+        uint32 middle = low + ((high - low) / 2);
+
+        if (subs[middle].sub_index_end < sub_index)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if ((low == span->num_subs) || (sub_index < subs[low].sub_index_start))
+    {
+        return NULL;
+    }
+
+    return subs[low].description;
+}
+
+/* Flattens the overlapping ranges above into disjoint index spans, each
+ * with disjoint sub-index spans, keeping the first match of the table
+ * for every object.  Built once on the first lookup.
+ */
+static void build_index(void)
+{
+    uint32  num_rows = sizeof(dictionary) / sizeof(dict_entry_t);
+    uint32* bounds;
+    uint32  num_bounds = 0;
+    uint32  i;
+
+    is_indexed = IS_TRUE;
+
+    bounds = (uint32*)os_calloc((num_rows * 2) + 1, sizeof(uint32));
+    if (NULL == bounds)
+    {
+        return;
+    }
+
+    for (i = 0; i < num_rows; i += 1)
+    {
+        uint16 index_start;
+        uint16 index_end;
+        uint8  sub_index_start;
+        uint8  sub_index_end;
+
+        get_bounds(&dictionary[i], &index_start, &index_end, &sub_index_start, &sub_index_end);
+        bounds[num_bounds++] = index_start;
+        bounds[num_bounds++] = (uint32)index_end + 1;
+    }
+
+    os_qsort(bounds, num_bounds, sizeof(uint32), compare_bounds);
+
+    for (i = 0; (i + 1) < num_bounds; i += 1)
+    {
+        if (bounds[i] != bounds[i + 1])
+        {
+            add_span((uint16)bounds[i], (uint16)(bounds[i + 1] - 1));
+        }
+    }
+
+    os_free(bounds);
+}
+
+static void add_span(uint16 index_start, uint16 index_end)
+{
+    static uint32 rows[sizeof(dictionary) / sizeof(dict_entry_t)];
+    uint32        num_rows = 0;
+    uint32        first    = num_sub_spans;
+    uint32        sub_index;
+    uint32        i;
+
+    /* Rows covering the span, still in table order. */
+    for (i = 0; i < (sizeof(dictionary) / sizeof(dict_entry_t)); i += 1)
+    {
+        uint16 row_index_start;
+        uint16 row_index_end;
+        uint8  row_sub_start;
+        uint8  row_sub_end;
+
+        get_bounds(&dictionary[i], &row_index_start, &row_index_end, &row_sub_start, &row_sub_end);
+
+        if ((index_start >= row_index_start) && (index_start <= row_index_end))
+        {
+            rows[num_rows] = i;
+            num_rows += 1;
+        }
+    }
+
+    for (sub_index = 0; sub_index <= 0xff; sub_index += 1)
+    {
+        const char* description = NULL;
+
+        for (i = 0; i < num_rows; i += 1)
+        {
+            uint16 row_index_start;
+            uint16 row_index_end;
+            uint8  row_sub_start;
+            uint8  row_sub_end;
+
+            get_bounds(&dictionary[rows[i]], &row_index_start, &row_index_end, &row_sub_start, &row_sub_end);
+
+            if ((sub_index >= row_sub_start) && (sub_index <= row_sub_end))
+            {
+                description = dictionary[rows[i]].description;
+                break;
+            }
+        }
+
+        if (NULL == description)
+        {
+            continue;
+        }
+
+        if ((num_sub_spans > first) &&
+            (description == sub_spans[num_sub_spans - 1].description) &&
+            ((sub_index - 1) == sub_spans[num_sub_spans - 1].sub_index_end))
+        {
+            sub_spans[num_sub_spans - 1].sub_index_end = (uint8)sub_index;
+            continue;
+        }
+
+        if (num_sub_spans == sub_spans_capacity)
+        {
+            uint32           capacity = (0 == sub_spans_capacity) ? 256 : (sub_spans_capacity * 2);
+            dict_sub_span_t* grown    = (dict_sub_span_t*)os_realloc(sub_spans, capacity * sizeof(dict_sub_span_t));
+
+            if (NULL == grown)
+            {
+                return;
+            }
+
+            sub_spans          = grown;
+            sub_spans_capacity = capacity;
+        }
+
+        sub_spans[num_sub_spans].sub_index_start = (uint8)sub_index;
+        sub_spans[num_sub_spans].sub_index_end   = (uint8)sub_index;
+        sub_spans[num_sub_spans].description     = description;
+        num_sub_spans += 1;
+    }
+
+    if (num_sub_spans == first)
+    {
+        return;
+    }
+
+    if (num_spans == spans_capacity)
+    {
+        uint32       capacity = (0 == spans_capacity) ? 128 : (spans_capacity * 2);
+        dict_span_t* grown    = (dict_span_t*)os_realloc(spans, capacity * sizeof(dict_span_t));
+
+        if (NULL == grown)
+        {
+            num_sub_spans = first;
+            return;
+        }
+
+        spans          = grown;
+        spans_capacity = capacity;
+    }
+
+    spans[num_spans].index_start = index_start;
+    spans[num_spans].index_end   = index_end;
+    spans[num_spans].first_sub   = first;
+    spans[num_spans].num_subs    = num_sub_spans - first;
+    num_spans += 1;
+}
+
+static void get_bounds(const dict_entry_t* entry, uint16* index_start, uint16* index_end, uint8* sub_index_start, uint8* sub_index_end)
+{
+    *index_start     = entry->index_start;
+    *index_end       = entry->index_end;
+    *sub_index_start = entry->sub_index_start;
+    *sub_index_end   = entry->sub_index_end;
+
+    if (*sub_index_end < *sub_index_start)
+    {
+        *sub_index_end = *sub_index_start;
+    }
+
+    if (*index_end < *index_start)
+    {
+        *index_end = *index_start;
+    }
+}
+
+static int compare_bounds(const void* a, const void* b)
+{
+    uint32 bound_a = *(const uint32*)a;
+    uint32 bound_b = *(const uint32*)b;
+
+    if (bound_a < bound_b)
+    {
+        return -1;
+    }
+
+    return (bound_a > bound_b) ? 1 : 0;
+}
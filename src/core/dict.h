@@ -12,6 +12,7 @@
 
 #include "os.h"
 #include "core.h"
+#include "eds.h"
 
 typedef struct dict_entry
 {
@@ -23,6 +24,24 @@ typedef struct dict_entry
 
 } dict_entry_t;
 
+/* What is known about an object, from the loaded EDS where available
+ * and the built-in CiA 301 ranges otherwise.
+ */
+typedef struct dict_meta
+{
+    const char* name;
+    const char* access;        /* "ro", "rw", "const"... or NULL. */
+    uint16      data_type;     /* 0 if unknown. */
+    uint32      low_limit;
+    uint32      high_limit;
+    uint32      default_value;
+    bool_t      is_from_eds;
+
+} dict_meta_t;
+
 const char* dict_lookup(uint16 index, uint8 sub_index);
+bool_t      dict_get_meta(uint16 index, uint8 sub_index, dict_meta_t* meta);
+void        dict_set_eds(const eds_entry_t* entries, uint16 num_entries, const char* strings);
+void        dict_deinit(void);
 
 #endif /* DICT_H */
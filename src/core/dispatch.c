@@ -0,0 +1,460 @@
+/** @file dispatch.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "can.h"
+#include "core.h"
+#include "dispatch.h"
+#include "os.h"
+
+static int    dispatch_thread(void* core_pt);
+static bool_t filter_match(const dispatch_sub_t* sub, const can_message_t* message);
+static void   push_message(dispatch_sub_t* sub, const can_message_t* message);
+static void   update_kernel_filter(void);
+
+static os_thread*      rx_thread;
+static os_mutex*       list_lock;
+static dispatch_sub_t* subscribers;
+static os_atomic_t     is_dispatching;
+static can_message_t   rx_batch[CAN_BATCH_SIZE];
+
+status_t dispatch_init(core_t* core)
+{
+    if (NULL == core)
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (NULL != rx_thread)
+    {
+        return ALL_OK;
+    }
+
+    list_lock = os_create_mutex();
+    if (NULL == list_lock)
+    {
+        return OS_INIT_ERROR;
+    }
+
+    os_atomic_set(&is_dispatching, IS_TRUE);
+
+    rx_thread = os_create_thread(dispatch_thread, "CAN dispatch thread", (void*)core);
+    if (NULL == rx_thread)
+    {
+        os_atomic_set(&is_dispatching, IS_FALSE);
+        os_destroy_mutex(list_lock);
+        list_lock = NULL;
+        return OS_INIT_ERROR;
+    }
+
+    return ALL_OK;
+}
+
+void dispatch_deinit(core_t* core)
+{
+    (void)core;
+
+    if (NULL == rx_thread)
+    {
+        return;
+    }
+
+    os_atomic_set(&is_dispatching, IS_FALSE);
+    os_wait_thread(rx_thread);
+    rx_thread = NULL;
+
+    while (NULL != subscribers)
+    {
+        dispatch_unsubscribe(subscribers);
+    }
+
+    os_destroy_mutex(list_lock);
+    list_lock = NULL;
+}
+
+dispatch_sub_t* dispatch_subscribe(const can_filter_t* filters, uint32 num_filters, uint32 capacity)
+{
+    dispatch_sub_t* sub;
+    uint32          size = DISPATCH_MIN_CAPACITY;
+
+    if ((NULL == list_lock) || (num_filters > CAN_MAX_FILTERS) || ((num_filters > 0) && (NULL == filters)))
+    {
+        return NULL;
+    }
+
+    /* Round up to a power of two so the ring index is a simple mask. */
+    while ((size < capacity) && (size < DISPATCH_MAX_CAPACITY))
+    {
+        size <<= 1;
+    }
+
+    sub = (dispatch_sub_t*)os_calloc(1, sizeof(dispatch_sub_t));
+    if (NULL == sub)
+    {
+        return NULL;
+    }
+
+    sub->ring = (can_message_t*)os_calloc(size, sizeof(can_message_t));
+    if (NULL == sub->ring)
+    {
+        os_free(sub);
+        return NULL;
+    }
+
+    sub->doorbell = os_create_semaphore(0);
+    if (NULL == sub->doorbell)
+    {
+        os_free(sub->ring);
+        os_free(sub);
+        return NULL;
+    }
+
+    sub->capacity = size;
+    if (num_filters > 0)
+    {
+        os_memcpy(sub->filters, filters, num_filters * sizeof(can_filter_t));
+    }
+    sub->num_filters = num_filters;
+
+    os_lock_mutex(list_lock);
+    sub->next   = subscribers;
+    subscribers = sub;
+    update_kernel_filter();
+    os_unlock_mutex(list_lock);
+
+    return sub;
+}
+
+void dispatch_unsubscribe(dispatch_sub_t* sub)
+{
+    dispatch_sub_t** link;
+
+    if ((NULL == sub) || (NULL == list_lock))
+    {
+        return;
+    }
+
+    os_lock_mutex(list_lock);
+    for (link = &subscribers; NULL != *link; link = &(*link)->next)
+    {
+        if (sub == *link)
+        {
+            *link = sub->next;
+            break;
+        }
+    }
+    update_kernel_filter();
+    os_unlock_mutex(list_lock);
+
+    os_destroy_semaphore(sub->doorbell);
+    os_free(sub->ring);
+    os_free(sub);
+}
+
+status_t dispatch_set_filter(dispatch_sub_t* sub, const can_filter_t* filters, uint32 num_filters)
+{
+    if ((NULL == sub) || (num_filters > CAN_MAX_FILTERS) || ((num_filters > 0) && (NULL == filters)))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    os_lock_mutex(list_lock);
+    if (num_filters > 0)
+    {
+        os_memcpy(sub->filters, filters, num_filters * sizeof(can_filter_t));
+    }
+    sub->num_filters = num_filters;
+
+    /* A paused subscriber doesn't contribute to the kernel filter. */
+    if (IS_FALSE == sub->is_paused)
+    {
+        update_kernel_filter();
+    }
+    os_unlock_mutex(list_lock);
+
+    return ALL_OK;
+}
+
+status_t dispatch_add_filter(dispatch_sub_t* sub, const can_filter_t* filter)
+{
+    status_t status = ALL_OK;
+
+    if ((NULL == sub) || (NULL == filter))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    os_lock_mutex(list_lock);
+    if (sub->num_filters < CAN_MAX_FILTERS)
+    {
+        os_memcpy(&sub->filters[sub->num_filters], filter, sizeof(can_filter_t));
+        sub->num_filters += 1;
+
+        if (IS_FALSE == sub->is_paused)
+        {
+            update_kernel_filter();
+        }
+    }
+    else
+    {
+        status = OS_INVALID_ARGUMENT;
+    }
+    os_unlock_mutex(list_lock);
+
+    return status;
+}
+
+void dispatch_pause(dispatch_sub_t* sub, bool_t is_paused)
+{
+    if (NULL == sub)
+    {
+        return;
+    }
+
+    os_lock_mutex(list_lock);
+    if (is_paused != sub->is_paused)
+    {
+        sub->is_paused = is_paused;
+        update_kernel_filter();
+    }
+    os_unlock_mutex(list_lock);
+}
+
+void dispatch_flush(dispatch_sub_t* sub)
+{
+    if (NULL == sub)
+    {
+        return;
+    }
+
+    /* Only the consumer moves the tail, so this needs no lock. */
+    os_atomic_set(&sub->tail, os_atomic_get(&sub->head));
+
+    while (IS_TRUE == os_sem_wait_timeout(sub->doorbell, 0)) {}
+}
+
+uint32 dispatch_read(dispatch_sub_t* sub, can_message_t* messages, uint32 max_messages, uint32 timeout_ms)
+{
+    uint64 deadline;
+    uint64 now;
+    uint32 num_read = 0;
+
+    if ((NULL == sub) || (NULL == messages) || (0 == max_messages))
+    {
+        return 0;
+    }
+
+    deadline = os_get_ticks() + timeout_ms;
+
+    while (1)
+    {
+        uint32 tail  = (uint32)os_atomic_get(&sub->tail);
+        uint32 head  = (uint32)os_atomic_get(&sub->head);
+        uint32 count = head - tail;
+
+        if (count > 0)
+        {
+            if (count > max_messages)
+            {
+                count = max_messages;
+            }
+
+            for (num_read = 0; num_read < count; num_read += 1)
+            {
+                os_memcpy(&messages[num_read], &sub->ring[(tail + num_read) & (sub->capacity - 1)], sizeof(can_message_t));
+            }
+
+            os_atomic_set(&sub->tail, (int)(tail + count));
+            return num_read;
+        }
+
+        now = os_get_ticks();
+        if (now >= deadline)
+        {
+            break;
+        }
+
+        /* The doorbell may be stale, the ring is the only source of truth. */
+        os_sem_wait_timeout(sub->doorbell, (uint32)(deadline - now));
+    }
+
+    return 0;
+}
+
+uint32 dispatch_get_overruns(dispatch_sub_t* sub)
+{
+    if (NULL == sub)
+    {
+        return 0;
+    }
+
+    return (uint32)os_atomic_get(&sub->overruns);
+}
+
+void dispatch_deliver(const can_message_t* messages, uint32 num_messages)
+{
+    dispatch_sub_t* sub;
+    uint32          index;
+
+    if ((NULL == messages) || (NULL == list_lock))
+    {
+        return;
+    }
+
+    os_lock_mutex(list_lock);
+    for (sub = subscribers; NULL != sub; sub = sub->next)
+    {
+        bool_t has_pushed = IS_FALSE;
+
+        if (IS_TRUE == sub->is_paused)
+        {
+            continue;
+        }
+
+        for (index = 0; index < num_messages; index += 1)
+        {
+            if (IS_TRUE == filter_match(sub, &messages[index]))
+            {
+                push_message(sub, &messages[index]);
+                has_pushed = IS_TRUE;
+            }
+        }
+
+        /* Ring the doorbell once per batch, and only if nobody has yet. */
+        if ((IS_TRUE == has_pushed) && (0 == os_sem_value(sub->doorbell)))
+        {
+            os_sem_post(sub->doorbell);
+        }
+    }
+    os_unlock_mutex(list_lock);
+}
+
+static int dispatch_thread(void* core_pt)
+{
+    core_t*  core = core_pt;
+    status_t status;
+    uint32   num_read;
+
+    while (IS_TRUE == os_atomic_get(&is_dispatching))
+    {
+        if (IS_FALSE == is_can_initialised(core))
+        {
+            os_delay(1);
+            continue;
+        }
+
+        status = can_poll(DISPATCH_POLL_INTERVAL_MS);
+        if (NOTHING_TO_DO == status)
+        {
+            continue;
+        }
+        else if (ALL_OK != status)
+        {
+            os_delay(1);
+            continue;
+        }
+
+        if (0 != can_read_batch(rx_batch, CAN_BATCH_SIZE, &num_read))
+        {
+            os_delay(1);
+            continue;
+        }
+
+        dispatch_deliver(rx_batch, num_read);
+    }
+
+    return 0;
+}
+
+static bool_t filter_match(const dispatch_sub_t* sub, const can_message_t* message)
+{
+    uint32 index;
+
+    if (0 == sub->num_filters)
+    {
+        return IS_TRUE;
+    }
+
+    for (index = 0; index < sub->num_filters; index += 1)
+    {
+        const can_filter_t* filter = &sub->filters[index];
+
+        if (IS_TRUE == filter->is_extended)
+        {
+            if ((IS_TRUE == message->is_extended) &&
+                (((message->id & CAN_EFF_ID_MASK) & filter->mask) == (filter->id & filter->mask)))
+            {
+                return IS_TRUE;
+            }
+        }
+        else if ((IS_FALSE == message->is_extended) &&
+                 (0 == (message->id & ~(uint32)CAN_SFF_ID_MASK)) &&
+                 ((message->id & filter->mask) == (filter->id & filter->mask)))
+        {
+            return IS_TRUE;
+        }
+    }
+
+    return IS_FALSE;
+}
+
+static void push_message(dispatch_sub_t* sub, const can_message_t* message)
+{
+    uint32 head = (uint32)os_atomic_get(&sub->head);
+    uint32 tail = (uint32)os_atomic_get(&sub->tail);
+
+    /* Never overwrite unread frames, drop the newest one instead. */
+    if ((head - tail) >= sub->capacity)
+    {
+        os_atomic_set(&sub->overruns, os_atomic_get(&sub->overruns) + 1);
+        return;
+    }
+
+    os_memcpy(&sub->ring[head & (sub->capacity - 1)], message, sizeof(can_message_t));
+    os_atomic_set(&sub->head, (int)(head + 1));
+}
+
+static void update_kernel_filter(void)
+{
+    can_filter_t    filters[CAN_MAX_FILTERS];
+    dispatch_sub_t* sub;
+    uint32          num_filters   = 0;
+    bool_t          is_accept_all = IS_FALSE;
+    bool_t          is_any_active = IS_FALSE;
+
+    /* The kernel filter is the union of all active subscribers, anything
+     * narrower is left to the per-subscriber match in user space.
+     */
+    for (sub = subscribers; NULL != sub; sub = sub->next)
+    {
+        if (IS_TRUE == sub->is_paused)
+        {
+            continue;
+        }
+
+        is_any_active = IS_TRUE;
+
+        if ((0 == sub->num_filters) || ((num_filters + sub->num_filters) > CAN_MAX_FILTERS))
+        {
+            is_accept_all = IS_TRUE;
+            break;
+        }
+
+        os_memcpy(&filters[num_filters], sub->filters, sub->num_filters * sizeof(can_filter_t));
+        num_filters += sub->num_filters;
+    }
+
+    if ((IS_FALSE == is_any_active) || (IS_TRUE == is_accept_all))
+    {
+        can_clear_filter();
+    }
+    else
+    {
+        can_set_filter(filters, num_filters);
+    }
+}
@@ -0,0 +1,48 @@
+/** @file dispatch.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+#define DISPATCH_POLL_INTERVAL_MS 10
+#define DISPATCH_MIN_CAPACITY     16
+#define DISPATCH_MAX_CAPACITY     65536
+
+typedef struct dispatch_sub
+{
+    can_message_t*       ring;
+    uint32               capacity;
+    os_atomic_t          head;
+    os_atomic_t          tail;
+    os_sem*              doorbell;
+    can_filter_t         filters[CAN_MAX_FILTERS];
+    uint32               num_filters;
+    bool_t               is_paused;
+    os_atomic_t          overruns;
+    struct dispatch_sub* next;
+
+} dispatch_sub_t;
+
+status_t        dispatch_init(core_t* core);
+void            dispatch_deinit(core_t* core);
+dispatch_sub_t* dispatch_subscribe(const can_filter_t* filters, uint32 num_filters, uint32 capacity);
+void            dispatch_unsubscribe(dispatch_sub_t* sub);
+status_t        dispatch_set_filter(dispatch_sub_t* sub, const can_filter_t* filters, uint32 num_filters);
+status_t        dispatch_add_filter(dispatch_sub_t* sub, const can_filter_t* filter);
+void            dispatch_pause(dispatch_sub_t* sub, bool_t is_paused);
+void            dispatch_flush(dispatch_sub_t* sub);
+uint32          dispatch_read(dispatch_sub_t* sub, can_message_t* messages, uint32 max_messages, uint32 timeout_ms);
+uint32          dispatch_get_overruns(dispatch_sub_t* sub);
+void            dispatch_deliver(const can_message_t* messages, uint32 num_messages);
+
+#endif /* DISPATCH_H */
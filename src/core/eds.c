@@ -11,14 +11,71 @@
 #include <dirent.h>
 #include "can.h"
 #include "core.h"
+#include "dict.h"
 #include "eds.h"
 #include "ini.h"
 #include "sdo.h"
+#include "sdo_cache.h"
+#include "sdo_client.h"
 #include "table.h"
 
-static eds_t eds;
+#define EDS_CACHE_MAGIC          0x43534445 /* "EDSC" */
+#define EDS_CACHE_VERSION        1
+#define EDS_STRINGS_INITIAL_SIZE 4096
+#define EDS_OBJECT_ARRAY         0x8
+#define EDS_OBJECT_RECORD        0x9
 
-static int parse_eds(void* user, const char* section, const char* name, const char* value);
+typedef struct eds_result
+{
+    sdo_state_t sdo_state;
+    uint32      elapsed_ms;
+    bool_t      is_skipped;
+
+} eds_result_t;
+
+/* Compiled image written next to the EDS, entries and strings follow. */
+typedef struct eds_cache_header
+{
+    uint32 magic;
+    uint32 version;
+    uint32 hash;
+    uint32 num_entries;
+    uint64 mtime;
+    uint64 size;
+    uint32 strings_size;
+    uint32 reserved;
+
+} eds_cache_header_t;
+
+typedef struct eds_builder
+{
+    char    section[50];
+    bool_t  is_object;
+    uint32  entries_capacity;
+    char*   strings;
+    uint32  strings_size;
+    uint32  strings_capacity;
+    uint32* slots;       /* Interned string offsets + 1, 0 if free. */
+    uint32  num_slots;
+    uint32  num_strings;
+
+} eds_builder_t;
+
+static eds_t         eds;
+static eds_builder_t builder;
+
+static status_t    report_node(const eds_result_t* results);
+static void        append_range(char* buffer, size_t size, int range_start, int last_sub_index, const char* separator);
+static bool_t      is_eds_file(const char* name);
+static status_t    map_cache(const char* cache_path, uint32 hash, uint64 mtime, uint64 size);
+static void        write_cache(const char* cache_path, uint32 hash, uint64 mtime, uint64 size);
+static uint32      hash_file(const char* path);
+static uint32      hash_data(const uint8* data, uint32 size);
+static bool_t      add_entry(const char* section);
+static uint32      intern_string(const char* value);
+static void        finish_entries(void);
+static int         compare_entries(const void* a, const void* b);
+static int         parse_eds(void* user, const char* section, const char* name, const char* value);
 
 void list_eds(void)
 {
@@ -42,7 +99,7 @@ void list_eds(void)
 
         while ((dir = os_readdir(d)) != NULL)
         {
-            if (os_strstr(dir->d_name, ".eds") != NULL)
+            if (IS_TRUE == is_eds_file(dir->d_name))
             {
                 char file_no_str[4] = { 0 };
 
@@ -63,110 +120,113 @@ void list_eds(void)
     table_flush(&table);
 }
 
-status_t run_conformance_test(const char* eds_path, uint32 node_id)
+status_t run_conformance_test(const char* eds_path, const uint8* node_ids, uint32 num_nodes)
 {
-    status_t status = ALL_OK;
-    char     unavailable_subs[256] = { 0 };
-    int      err_count = 0;
-    int      error;
-    int      i;
-    int      last_sub_index = -1;
-    int      range_start = -1;
-    uint16   current_index = 0xFFFF;
+    status_t      status = ALL_OK;
+    eds_result_t* results;
+    uint64        started_at;
+    uint32        n;
+    int           i;
+
+    if ((NULL == node_ids) || (0 == num_nodes))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
 
     os_log(LOG_INFO, "Running conformance test for %s...", eds_path);
 
-    /* Parse EDS file. */
-    error = ini_parse(eds_path, parse_eds, &eds_path);
-    if (error < 0)
+    status = eds_load(eds_path);
+    if (ALL_OK != status)
     {
-        os_log(LOG_ERROR, "Can't load '%s' (%d).", eds_path, error);
-        status = EDS_PARSE_ERROR;
+        return status;
     }
 
     os_log(LOG_INFO, "Number of objects: %u", eds.num_entries);
     os_log(LOG_INFO, "Testing object availability...");
 
+    results = (eds_result_t*)os_calloc((size_t)num_nodes * eds.num_entries + 1, sizeof(eds_result_t));
+    if (NULL == results)
+    {
+        os_log(LOG_ERROR, "Memory allocation error.");
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    /* Queue every read up front: each node works through its own queue
+     * while the others are busy, instead of one read at a time.
+     */
+    started_at = os_get_ticks();
+
     for (i = 0; i < eds.num_entries; i++)
     {
-        if (WO != eds.entries[i].AccessType)
+        for (n = 0; n < num_nodes; n++)
         {
-            can_message_t sdo_response;
-            sdo_state_t   state = sdo_read(&sdo_response, SILENT, (uint8)node_id, eds.entries[i].Index, eds.entries[i].SubIndex, NULL);
-            if (ABORT_TRANSFER == state)
-            {
-                if (eds.entries[i].Index != current_index)
-                {
-                    if (current_index != 0xFFFF)
-                    {
-                        if (range_start != -1)
-                        {
-                            if (last_sub_index == range_start)
-                            {
-                                os_snprintf(unavailable_subs + os_strlen(unavailable_subs), sizeof(unavailable_subs) - os_strlen(unavailable_subs), "%d", range_start);
-                            }
-                            else
-                            {
-                                os_snprintf(unavailable_subs + os_strlen(unavailable_subs), sizeof(unavailable_subs) - os_strlen(unavailable_subs), "%d-%d", range_start, last_sub_index);
-                            }
-                        }
-                        os_log(LOG_INFO, "  0x%04X sub %s not available.", current_index, unavailable_subs);
-                    }
-                    current_index = eds.entries[i].Index;
-                    os_strlcpy(unavailable_subs, "", sizeof(unavailable_subs));
-                    range_start = -1;
-                }
+            eds_result_t* result = &results[(n * eds.num_entries) + i];
+            sdo_request_t request;
 
-                if (range_start == -1)
-                {
-                    range_start = eds.entries[i].SubIndex;
-                }
-                else if (eds.entries[i].SubIndex != last_sub_index + 1)
-                {
-                    if (last_sub_index == range_start)
-                    {
-                        os_snprintf(unavailable_subs + os_strlen(unavailable_subs), sizeof(unavailable_subs) - os_strlen(unavailable_subs), "%d, ", range_start);
-                    }
-                    else
-                    {
-                        os_snprintf(unavailable_subs + os_strlen(unavailable_subs), sizeof(unavailable_subs) - os_strlen(unavailable_subs), "%d-%d, ", range_start, last_sub_index);
-                    }
-                    range_start = eds.entries[i].SubIndex;
-                }
+            /* Constant objects never change until the node resets. */
+            if (RO_CONST == eds.entries[i].AccessType)
+            {
+                sdo_cache_mark(node_ids[n], eds.entries[i].Index, eds.entries[i].SubIndex, IS_TRUE);
+            }
 
-                last_sub_index = eds.entries[i].SubIndex;
-                err_count++;
-                status = EDS_OBJECT_NOT_AVAILABLE;
+            if (WO == eds.entries[i].AccessType)
+            {
+                result->is_skipped = IS_TRUE;
+                continue;
             }
+
+            os_memset(&request, 0, sizeof(sdo_request_t));
+            request.type      = SDO_REQUEST_READ;
+            request.node_id   = node_ids[n];
+            request.index     = eds.entries[i].Index;
+            request.sub_index = eds.entries[i].SubIndex;
+            request.user_data = result;
+
+            /* Stays aborted if the request can't even be queued. */
+            result->sdo_state = ABORT_TRANSFER;
+            sdo_client_submit(&request);
         }
     }
 
-    if (current_index != 0xFFFF)
+    while (sdo_client_get_pending() > 0)
     {
-        if (range_start != -1)
+        sdo_completion_t completion;
+
+        sdo_client_process(sdo_get_timeout());
+
+        while (IS_TRUE == sdo_client_get_completion(&completion))
         {
-            if (last_sub_index == range_start)
-            {
-                os_snprintf(unavailable_subs + os_strlen(unavailable_subs), sizeof(unavailable_subs) - os_strlen(unavailable_subs), "%d", range_start);
-            }
-            else
+            eds_result_t* result = (eds_result_t*)completion.request.user_data;
+
+            /* Reads were submitted with no buffer, so one was allocated. */
+            os_free(completion.request.data);
+
+            if (NULL != result)
             {
-                os_snprintf(unavailable_subs + os_strlen(unavailable_subs), sizeof(unavailable_subs) - os_strlen(unavailable_subs), "%d-%d", range_start, last_sub_index);
+                result->sdo_state  = completion.sdo_state;
+                result->elapsed_ms = completion.elapsed_ms;
             }
         }
-        os_log(LOG_INFO, "  0x%04X sub %s not available.", current_index, unavailable_subs);
     }
 
-    os_log(LOG_INFO, "Conformity: %.2f%%", 100.f - (100.f / (float)eds.num_entries * (float)err_count));
-    os_log(LOG_INFO, "%d of %d objects not available.", err_count, eds.num_entries);
-
-    if (eds.entries != NULL)
+    for (n = 0; n < num_nodes; n++)
     {
-        os_free(eds.entries);
-        eds.entries = NULL;
-        eds.num_entries = 0;
+        if (num_nodes > 1)
+        {
+            os_log(LOG_INFO, "Node 0x%02X:", node_ids[n]);
+        }
+
+        if (ALL_OK != report_node(&results[n * eds.num_entries]))
+        {
+            status = EDS_OBJECT_NOT_AVAILABLE;
+        }
     }
 
+    os_log(LOG_INFO, "Total time: %u ms", (uint32)(os_get_ticks() - started_at));
+
+    /* Stays loaded, so SDO output and scripts see its object names. */
+    os_free(results);
+
     return status;
 }
 
@@ -182,14 +242,17 @@ status_t validate_eds(uint32 file_no, uint32 node_id)
 
         while ((dir = os_readdir(d)) != NULL)
         {
-            if (os_strstr(dir->d_name, ".eds") != NULL)
+            if (IS_TRUE == is_eds_file(dir->d_name))
             {
                 if (file_no == found_file_no)
                 {
-                    char eds_path[50];
+                    char  eds_path[50];
+                    uint8 id;
+
                     os_snprintf(eds_path, 50, "eds/%s", dir->d_name);
+                    id = (uint8)node_id;
 
-                    status = run_conformance_test(eds_path, node_id);
+                    status = run_conformance_test(eds_path, &id, 1);
                     break;
                 }
                 found_file_no++;
@@ -205,112 +268,616 @@ status_t validate_eds(uint32 file_no, uint32 node_id)
     return status;
 }
 
-static int parse_eds(void* user, const char* section, const char* name, const char* value)
+status_t eds_load(const char* eds_path)
+{
+    char   cache_path[512];
+    uint64 mtime;
+    uint64 size;
+    uint32 hash;
+    int    error;
+
+    eds_unload();
+
+    if (ALL_OK != os_get_file_info(eds_path, &mtime, &size))
+    {
+        os_log(LOG_ERROR, "Can't load '%s'.", eds_path);
+        return OS_FILE_NOT_FOUND;
+    }
+
+    /* A hit skips parsing entirely; the file hash catches edits that
+     * kept the modification time.
+     */
+    hash = hash_file(eds_path);
+    os_snprintf(cache_path, sizeof(cache_path), "%s.cache", eds_path);
+
+    if (ALL_OK == map_cache(cache_path, hash, mtime, size))
+    {
+        dict_set_eds(eds.entries, eds.num_entries, eds.strings);
+        return ALL_OK;
+    }
+
+    builder.strings = (char*)os_calloc(1, EDS_STRINGS_INITIAL_SIZE);
+    if (NULL == builder.strings)
+    {
+        os_log(LOG_ERROR, "Memory allocation error.");
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    /* Offset 0 is the empty string. */
+    builder.strings_size     = 1;
+    builder.strings_capacity = EDS_STRINGS_INITIAL_SIZE;
+    builder.section[0]       = '\0';
+    builder.is_object        = IS_FALSE;
+
+    error = ini_parse(eds_path, parse_eds, NULL);
+    if (error < 0)
+    {
+        os_log(LOG_ERROR, "Can't load '%s' (%d).", eds_path, error);
+        eds_unload();
+        return EDS_PARSE_ERROR;
+    }
+
+    finish_entries();
+    write_cache(cache_path, hash, mtime, size);
+
+    dict_set_eds(eds.entries, eds.num_entries, eds.strings);
+
+    return ALL_OK;
+}
+
+void eds_unload(void)
 {
-    size_t len = os_strlen(section);
-
-    if (len > 7 &&
-        os_isxdigit(section[0]) &&
-        os_isxdigit(section[1]) &&
-        os_isxdigit(section[2]) &&
-        os_isxdigit(section[3]) &&
-        section[4] == 's'       &&
-        section[5] == 'u'       &&
-        section[6] == 'b'       &&
-        os_isxdigit(section[7]) &&
-        (len == 8 || (len == 9 && os_isxdigit(section[8]))) )
-    {
-        static char prev_section[50] = "";
-
-        if (0 != os_strcmp(section, prev_section))
+    dict_set_eds(NULL, 0, NULL);
+
+    if (NULL != eds.mapping)
+    {
+        os_unmap_file(eds.mapping, eds.mapping_size);
+    }
+    else
+    {
+        os_free(eds.entries);
+        os_free(builder.strings);
+    }
+
+    os_free(builder.slots);
+    os_memset(&builder, 0, sizeof(eds_builder_t));
+    os_memset(&eds, 0, sizeof(eds_t));
+}
+
+static status_t report_node(const eds_result_t* results)
+{
+    status_t status = ALL_OK;
+    table_t  table  = { DARK_CYAN, DARK_WHITE, 7, 30, 9 };
+    char     unavailable_subs[256] = { 0 };
+    int      err_count = 0;
+    int      i;
+    int      last_sub_index = -1;
+    int      range_start = -1;
+    uint16   current_index = 0xFFFF;
+    uint32   total_ms = 0;
+    uint32   max_ms = 0;
+    int      num_read = 0;
+
+    for (i = 0; i < eds.num_entries; i++)
+    {
+        if (IS_TRUE == results[i].is_skipped)
         {
-            char index[5]     = { 0 };
-            char sub_index[3] = { 0 };
+            continue;
+        }
 
-            os_strlcpy(index, section, 5);
-            os_strlcpy(sub_index, section + 7, 3);
-            os_strlcpy(prev_section, section, sizeof(prev_section));
+        if (ABORT_TRANSFER != results[i].sdo_state)
+        {
+            total_ms += results[i].elapsed_ms;
+            num_read += 1;
 
-            prev_section[sizeof(prev_section) - 1] = '\0';
+            if (results[i].elapsed_ms > max_ms)
+            {
+                max_ms = results[i].elapsed_ms;
+            }
+            continue;
+        }
 
-            eds.entries = os_realloc(eds.entries, (eds.num_entries + 1) * sizeof(eds_entry_t));
-            if (NULL == eds.entries)
+        if (eds.entries[i].Index != current_index)
+        {
+            if (current_index != 0xFFFF)
             {
-                os_log(LOG_ERROR, "Memory allocation error.");
-                return 0;
+                append_range(unavailable_subs, sizeof(unavailable_subs), range_start, last_sub_index, "");
+                os_log(LOG_INFO, "  0x%04X sub %s not available.", current_index, unavailable_subs);
             }
+            current_index = eds.entries[i].Index;
+            os_strlcpy(unavailable_subs, "", sizeof(unavailable_subs));
+            range_start = -1;
+        }
 
-            eds.entries[eds.num_entries].Index    = (uint16)os_strtoul(index, NULL, 16);
-            eds.entries[eds.num_entries].SubIndex = (uint8)os_strtoul(sub_index, NULL, 16);
-            eds.num_entries++;
+        if (range_start == -1)
+        {
+            range_start = eds.entries[i].SubIndex;
+        }
+        else if (eds.entries[i].SubIndex != last_sub_index + 1)
+        {
+            append_range(unavailable_subs, sizeof(unavailable_subs), range_start, last_sub_index, ", ");
+            range_start = eds.entries[i].SubIndex;
         }
+
+        last_sub_index = eds.entries[i].SubIndex;
+        err_count++;
+        status = EDS_OBJECT_NOT_AVAILABLE;
     }
 
-    if (0 == eds.num_entries)
+    if (current_index != 0xFFFF)
     {
-        return 1;
+        append_range(unavailable_subs, sizeof(unavailable_subs), range_start, last_sub_index, "");
+        os_log(LOG_INFO, "  0x%04X sub %s not available.", current_index, unavailable_subs);
     }
 
-    if (0 == os_strcmp(name, "ParameterName"))
+    os_log(LOG_INFO, "Conformity: %.2f%%", 100.f - (100.f / (float)eds.num_entries * (float)err_count));
+    os_log(LOG_INFO, "%d of %d objects not available.", err_count, eds.num_entries);
+
+    if (num_read > 0)
+    {
+        os_log(LOG_INFO, "Read time: %u ms average, %u ms max.", total_ms / (uint32)num_read, max_ms);
+    }
+
+    if (ALL_OK != table_init(&table, 1024))
+    {
+        return status;
+    }
+
+    table_print_header(&table);
+    table_print_row("Object", "Parameter name", "Time", &table);
+    table_print_divider(&table);
+
+    for (i = 0; i < eds.num_entries; i++)
+    {
+        const char* name;
+        char        object[8] = { 0 };
+        char        time[10]  = { 0 };
+
+        if (IS_TRUE == results[i].is_skipped)
+        {
+            continue;
+        }
+
+        os_snprintf(object, sizeof(object), "%04X:%02X", eds.entries[i].Index, eds.entries[i].SubIndex);
+
+        if (ABORT_TRANSFER == results[i].sdo_state)
+        {
+            os_strlcpy(time, "-", sizeof(time));
+        }
+        else
+        {
+            os_snprintf(time, sizeof(time), "%u ms", results[i].elapsed_ms);
+        }
+
+        name = dict_lookup(eds.entries[i].Index, eds.entries[i].SubIndex);
+        table_print_row(object, ((NULL != name) && ('\0' != name[0])) ? name : "-", time, &table);
+    }
+
+    table_print_footer(&table);
+    table_flush(&table);
+
+    return status;
+}
+
+static void append_range(char* buffer, size_t size, int range_start, int last_sub_index, const char* separator)
+{
+    if (-1 == range_start)
+    {
+        return;
+    }
+
+    if (last_sub_index == range_start)
+    {
+        os_snprintf(buffer + os_strlen(buffer), size - os_strlen(buffer), "%d%s", range_start, separator);
+    }
+    else
+    {
+        os_snprintf(buffer + os_strlen(buffer), size - os_strlen(buffer), "%d-%d%s", range_start, last_sub_index, separator);
+    }
+}
+
+/* Only a match at the end, so the compiled caches aren't listed. */
+static bool_t is_eds_file(const char* name)
+{
+    size_t len = os_strlen(name);
+
+    if ((len > 4) && (0 == os_strcmp(name + len - 4, ".eds")))
+    {
+        return IS_TRUE;
+    }
+
+    return IS_FALSE;
+}
+
+static status_t map_cache(const char* cache_path, uint32 hash, uint64 mtime, uint64 size)
+{
+    const eds_cache_header_t* header;
+    const eds_entry_t*        entries;
+    const char*               strings;
+    const void*               data;
+    uint32                    data_size = 0;
+    uint32                    i;
+
+    data = os_map_file(cache_path, &data_size);
+    if (NULL == data)
+    {
+        return OS_FILE_NOT_FOUND;
+    }
+
+    header = (const eds_cache_header_t*)data;
+
+    if ((data_size < sizeof(eds_cache_header_t)) ||
+        (EDS_CACHE_MAGIC   != header->magic)     ||
+        (EDS_CACHE_VERSION != header->version)   ||
+        (hash  != header->hash)                  ||
+        (mtime != header->mtime)                 ||
+        (size  != header->size)                  ||
+        (header->num_entries > 0xffff)           ||
+        (0 == header->strings_size)              ||
+        (data_size != sizeof(eds_cache_header_t) + (header->num_entries * sizeof(eds_entry_t)) + header->strings_size))
+    {
+        os_unmap_file(data, data_size);
+        return EDS_PARSE_ERROR;
+    }
+
+    entries = (const eds_entry_t*)(header + 1);
+    strings = (const char*)(entries + header->num_entries);
+
+    if ('\0' != strings[header->strings_size - 1])
+    {
+        os_unmap_file(data, data_size);
+        return EDS_PARSE_ERROR;
+    }
+
+    for (i = 0; i < header->num_entries; i += 1)
+    {
+        if (entries[i].ParameterName >= header->strings_size)
+        {
+            os_unmap_file(data, data_size);
+            return EDS_PARSE_ERROR;
+        }
+    }
+
+    /* Entries are only read from here on, so they stay in the mapping. */
+    eds.entries      = (eds_entry_t*)entries;
+    eds.num_entries  = (uint16)header->num_entries;
+    eds.strings      = strings;
+    eds.strings_size = header->strings_size;
+    eds.mapping      = data;
+    eds.mapping_size = data_size;
+
+    return ALL_OK;
+}
+
+static void write_cache(const char* cache_path, uint32 hash, uint64 mtime, uint64 size)
+{
+    eds_cache_header_t header;
+    FILE_t*            file;
+    size_t             written = 0;
+
+    os_memset(&header, 0, sizeof(eds_cache_header_t));
+    header.magic        = EDS_CACHE_MAGIC;
+    header.version      = EDS_CACHE_VERSION;
+    header.hash         = hash;
+    header.num_entries  = eds.num_entries;
+    header.mtime        = mtime;
+    header.size         = size;
+    header.strings_size = eds.strings_size;
+
+    /* Not being able to write next to the EDS only costs the speed-up. */
+    file = os_fopen(cache_path, "wb");
+    if (NULL == file)
+    {
+        return;
+    }
+
+    written += os_fwrite(&header, sizeof(eds_cache_header_t), 1, file);
+    if (eds.num_entries > 0)
+    {
+        written += os_fwrite(eds.entries, sizeof(eds_entry_t) * eds.num_entries, 1, file);
+    }
+    else
+    {
+        written += 1;
+    }
+    written += os_fwrite(eds.strings, eds.strings_size, 1, file);
+
+    os_fclose(file);
+
+    if (3 != written)
+    {
+        os_log(LOG_WARNING, "Could not write '%s'.", cache_path);
+    }
+}
+
+static uint32 hash_file(const char* path)
+{
+    const uint8* data;
+    uint32       size = 0;
+    uint32       hash;
+
+    data = (const uint8*)os_map_file(path, &size);
+    hash = hash_data(data, size);
+    os_unmap_file(data, size);
+
+    return hash;
+}
+
+/* FNV-1a. */
+static uint32 hash_data(const uint8* data, uint32 size)
+{
+    uint32 hash = 0x811c9dc5;
+    uint32 i;
+
+    for (i = 0; i < size; i += 1)
+    {
+        hash ^= data[i];
+        hash *= 0x01000193;
+    }
+
+    return hash;
+}
+
+static bool_t add_entry(const char* section)
+{
+    eds_entry_t* entry;
+    char         index[5]     = { 0 };
+    char         sub_index[3] = { 0 };
+    size_t       len          = os_strlen(section);
+
+    if ((len < 4) ||
+        (0 == os_isxdigit(section[0])) ||
+        (0 == os_isxdigit(section[1])) ||
+        (0 == os_isxdigit(section[2])) ||
+        (0 == os_isxdigit(section[3])))
+    {
+        return IS_FALSE;
+    }
+
+    /* Either a plain object or one of its sub-indices. */
+    if (len != 4)
+    {
+        if ((len < 8) || (len > 9) ||
+            (section[4] != 's') ||
+            (section[5] != 'u') ||
+            (section[6] != 'b') ||
+            (0 == os_isxdigit(section[7])) ||
+            ((len == 9) && (0 == os_isxdigit(section[8]))))
+        {
+            return IS_FALSE;
+        }
+        os_strlcpy(sub_index, section + 7, 3);
+    }
+    os_strlcpy(index, section, 5);
+
+    if (0xffff == eds.num_entries)
+    {
+        return IS_FALSE;
+    }
+
+    if (eds.num_entries == builder.entries_capacity)
+    {
+        uint32       capacity = (0 == builder.entries_capacity) ? 256 : (builder.entries_capacity * 2);
+        eds_entry_t* entries  = (eds_entry_t*)os_realloc(eds.entries, capacity * sizeof(eds_entry_t));
+
+        if (NULL == entries)
+        {
+            os_log(LOG_ERROR, "Memory allocation error.");
+            return IS_FALSE;
+        }
+
+        eds.entries              = entries;
+        builder.entries_capacity = capacity;
+    }
+
+    entry = &eds.entries[eds.num_entries];
+    os_memset(entry, 0, sizeof(eds_entry_t));
+    entry->Index    = (uint16)os_strtoul(index, NULL, 16);
+    entry->SubIndex = (uint8)os_strtoul(sub_index, NULL, 16);
+    eds.num_entries++;
+
+    return IS_TRUE;
+}
+
+static uint32 intern_string(const char* value)
+{
+    uint32 length = (uint32)os_strlen(value);
+    uint32 mask;
+    uint32 slot;
+    uint32 offset;
+
+    if (0 == length)
+    {
+        return 0;
+    }
+
+    /* Sub-indices repeat the same few names, store each one once. */
+    if (((builder.num_strings + 1) * 2) > builder.num_slots)
+    {
+        uint32  num_slots = (0 == builder.num_slots) ? 256 : (builder.num_slots * 2);
+        uint32* slots     = (uint32*)os_calloc(num_slots, sizeof(uint32));
+        uint32  i;
+
+        if (NULL == slots)
+        {
+            return 0;
+        }
+
+        for (i = 0; i < builder.num_slots; i += 1)
+        {
+            if (0 != builder.slots[i])
+            {
+                const char* string = builder.strings + builder.slots[i] - 1;
+
+                slot = hash_data((const uint8*)string, (uint32)os_strlen(string)) & (num_slots - 1);
+                while (0 != slots[slot])
+                {
+                    slot = (slot + 1) & (num_slots - 1);
+                }
+                slots[slot] = builder.slots[i];
+            }
+        }
+
+        os_free(builder.slots);
+        builder.slots     = slots;
+        builder.num_slots = num_slots;
+    }
+
+    mask = builder.num_slots - 1;
+    for (slot = hash_data((const uint8*)value, length) & mask; 0 != builder.slots[slot]; slot = (slot + 1) & mask)
     {
-        size_t len = os_strlen(value) + 1;
-        if (len > 242)
+        if (0 == os_strcmp(builder.strings + builder.slots[slot] - 1, value))
         {
-            len = 242;
+            return builder.slots[slot] - 1;
         }
+    }
+
+    if ((builder.strings_size + length + 1) > builder.strings_capacity)
+    {
+        uint32 capacity = builder.strings_capacity * 2;
+        char*  strings;
+
+        while ((builder.strings_size + length + 1) > capacity)
+        {
+            capacity *= 2;
+        }
+
+        strings = (char*)os_realloc(builder.strings, capacity);
+        if (NULL == strings)
+        {
+            return 0;
+        }
+
+        builder.strings          = strings;
+        builder.strings_capacity = capacity;
+    }
 
-        os_strlcpy(eds.entries[eds.num_entries - 1].ParameterName, value, len);
+    offset = builder.strings_size;
+    os_memcpy(builder.strings + offset, value, length + 1);
+    builder.strings_size += length + 1;
+
+    builder.slots[slot]  = offset + 1;
+    builder.num_strings += 1;
+
+    return offset;
+}
+
+static void finish_entries(void)
+{
+    uint32 i;
+    uint32 num_entries = 0;
+
+    /* Arrays and records only describe their sub-indices. */
+    for (i = 0; i < eds.num_entries; i += 1)
+    {
+        if ((EDS_OBJECT_ARRAY != eds.entries[i].ObjectType) && (EDS_OBJECT_RECORD != eds.entries[i].ObjectType))
+        {
+            eds.entries[num_entries] = eds.entries[i];
+            num_entries += 1;
+        }
+    }
+    eds.num_entries = (uint16)num_entries;
+
+    if (num_entries > 1)
+    {
+        os_qsort(eds.entries, num_entries, sizeof(eds_entry_t), compare_entries);
+    }
+
+    eds.strings      = builder.strings;
+    eds.strings_size = builder.strings_size;
+
+    os_free(builder.slots);
+    builder.slots       = NULL;
+    builder.num_slots   = 0;
+    builder.num_strings = 0;
+}
+
+static int compare_entries(const void* a, const void* b)
+{
+    const eds_entry_t* entry_a = (const eds_entry_t*)a;
+    const eds_entry_t* entry_b = (const eds_entry_t*)b;
+    uint32             key_a   = ((uint32)entry_a->Index << 8) | entry_a->SubIndex;
+    uint32             key_b   = ((uint32)entry_b->Index << 8) | entry_b->SubIndex;
+
+    if (key_a < key_b)
+    {
+        return -1;
+    }
+
+    return (key_a > key_b) ? 1 : 0;
+}
+
+static int parse_eds(void* user, const char* section, const char* name, const char* value)
+{
+    eds_entry_t* entry;
+
+    if (0 != os_strcmp(section, builder.section))
+    {
+        os_strlcpy(builder.section, section, sizeof(builder.section));
+        builder.is_object = add_entry(section);
+    }
+
+    if (IS_FALSE == builder.is_object)
+    {
+        return 1;
+    }
+
+    entry = &eds.entries[eds.num_entries - 1];
+
+    if (0 == os_strcmp(name, "ParameterName"))
+    {
+        entry->ParameterName = intern_string(value);
     }
     else if (0 == os_strcmp(name, "ObjectType"))
     {
-        eds.entries[eds.num_entries - 1].ObjectType = (uint8)os_strtoul(value, NULL, 0);
+        entry->ObjectType = (uint8)os_strtoul(value, NULL, 0);
     }
     else if (0 == os_strcmp(name, "DataType"))
     {
-        eds.entries[eds.num_entries - 1].DataType = (uint16)os_strtoul(value, NULL, 0);
+        entry->DataType = (uint16)os_strtoul(value, NULL, 0);
     }
     else if (0 == os_strcmp(name, "LowLimit"))
     {
-        eds.entries[eds.num_entries - 1].LowLimit = (uint32)os_strtoul(value, NULL, 0);
+        entry->LowLimit = (uint32)os_strtoul(value, NULL, 0);
     }
     else if (0 == os_strcmp(name, "HighLimit"))
     {
-        eds.entries[eds.num_entries - 1].HighLimit = (uint32)os_strtoul(value, NULL, 0);
+        entry->HighLimit = (uint32)os_strtoul(value, NULL, 0);
     }
     else if (0 == os_strcmp(name, "AccessType"))
     {
         if (0 == os_strcmp(value, "ro"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = RO;
+            entry->AccessType = RO;
         }
         else if (0 == os_strcmp(value, "wo"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = WO;
+            entry->AccessType = WO;
         }
         else if (0 == os_strcmp(value, "rw"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = RW;
+            entry->AccessType = RW;
         }
         else if (0 == os_strcmp(value, "rwr"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = RWR;
+            entry->AccessType = RWR;
         }
         else if (0 == os_strcmp(value, "rww"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = RWW;
+            entry->AccessType = RWW;
         }
         else if (0 == os_strcmp(value, "const"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = RO_CONST;
+            entry->AccessType = RO_CONST;
         }
     }
     else if (0 == os_strcmp(name, "DefaultValue"))
     {
-        eds.entries[eds.num_entries - 1].DefaultValue = (uint32)os_strtoul(value, NULL, 0);
+        entry->DefaultValue = (uint32)os_strtoul(value, NULL, 0);
     }
     else if (0 == os_strcmp(name, "PDOMapping"))
     {
-        eds.entries[eds.num_entries - 1].DefaultValue = (bool_t)os_strtoul(value, NULL, 0);
+        entry->PDOMapping = (uint8)os_strtoul(value, NULL, 0);
     }
 
     return 1;
@@ -13,8 +13,10 @@
 #include "core.h"
 
 void     list_eds(void);
-status_t run_conformance_test(const char* eds_file, uint32 node_id);
+status_t run_conformance_test(const char* eds_file, const uint8* node_ids, uint32 num_nodes);
 status_t validate_eds(uint32 file_no, uint32 node_id);
+status_t eds_load(const char* eds_file);
+void     eds_unload(void);
 
 typedef enum access_type
 {
@@ -27,19 +29,21 @@ typedef enum access_type
 
 } access_type_t;
 
+/* Laid out as stored in the compiled cache, sorted by index and
+ * sub-index.
+ */
 typedef struct eds_entry
 {
-    uint16        Index;
-    uint8         SubIndex;
-
-    char          ParameterName[242]; /* max. 241 characters, leading \0. */
-    uint8         ObjectType;
-    uint16        DataType;
-    uint32        LowLimit;
-    uint32        HighLimit;
-    access_type_t AccessType;
-    uint32        DefaultValue;
-    bool_t        PDOMapping;
+    uint16 Index;
+    uint8  SubIndex;
+    uint8  ObjectType;
+    uint16 DataType;
+    uint8  AccessType;    /* access_type_t */
+    uint8  PDOMapping;
+    uint32 LowLimit;
+    uint32 HighLimit;
+    uint32 DefaultValue;
+    uint32 ParameterName; /* Offset into eds_t.strings. */
 
 } eds_entry_t;
 
@@ -47,6 +51,10 @@ typedef struct eds
 {
     uint16       num_entries;
     eds_entry_t* entries;
+    const char*  strings;
+    uint32       strings_size;
+    const void*  mapping;      /* Cache file the above point into, if any. */
+    uint32       mapping_size;
 
 } eds_t;
 
@@ -10,6 +10,7 @@
 #include "can.h"
 #include "core.h"
 #include "nmt.h"
+#include "sdo_cache.h"
 #include "table.h"
 
 void nmt_print_error(const char* reason, nmt_command_t command, disp_mode_t disp_mode);
@@ -51,6 +52,12 @@ status_t nmt_send_command(uint8 node_id, nmt_command_t command, disp_mode_t disp
         }
         else
         {
+            /* Node ID 0 addresses all nodes, and drops all entries. */
+            if ((NMT_RESET_NODE == command) || (NMT_RESET_COMM == command))
+            {
+                sdo_cache_invalidate(node_id);
+            }
+
             if (SCRIPT_MODE == disp_mode)
             {
                 int  i;
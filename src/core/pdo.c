@@ -12,14 +12,88 @@
 #include "pdo.h"
 #include "table.h"
 
-static pdo_t pdo[PDO_MAX];
-
-static uint32 pdo_send_callback(uint32 interval, void *param);
+static pdo_t         pdo[PDO_MAX];
+static pdo_t*        wheel[PDO_WHEEL_LEVELS][PDO_WHEEL_SLOTS];
+static uint64        wheel_tick; /* Next tick to be run, in ms. */
+static uint32        num_scheduled;
+static os_thread*    scheduler_thread;
+static os_mutex*     wheel_lock;
+static os_sem*       wake_up;
+static os_atomic_t   is_scheduling;
+static can_message_t tx_burst[PDO_MAX];
+
+static void   cascade(uint32 level, uint32 slot);
+static void   link_pdo(pdo_t* entry);
+static int    pdo_thread(void* data);
+static uint32 run_tick(uint64 now_ms, uint32 num_frames);
+static void   unlink_pdo(pdo_t* entry);
 static void   print_error(const char* reason, disp_mode_t disp_mode, uint16 can_id);
 
+status_t pdo_init(void)
+{
+    if (NULL != scheduler_thread)
+    {
+        return ALL_OK;
+    }
+
+    if (NULL == wheel_lock)
+    {
+        wheel_lock = os_create_mutex();
+        if (NULL == wheel_lock)
+        {
+            return OS_INIT_ERROR;
+        }
+    }
+
+    wake_up = os_create_semaphore(0);
+    if (NULL == wake_up)
+    {
+        return OS_INIT_ERROR;
+    }
+
+    os_atomic_set(&is_scheduling, IS_TRUE);
+
+    scheduler_thread = os_create_thread(pdo_thread, "PDO scheduler thread", NULL);
+    if (NULL == scheduler_thread)
+    {
+        os_atomic_set(&is_scheduling, IS_FALSE);
+        os_destroy_semaphore(wake_up);
+        wake_up = NULL;
+        return OS_INIT_ERROR;
+    }
+
+    return ALL_OK;
+}
+
+void pdo_deinit(void)
+{
+    if (NULL != scheduler_thread)
+    {
+        os_atomic_set(&is_scheduling, IS_FALSE);
+        os_sem_post(wake_up);
+        os_wait_thread(scheduler_thread);
+        scheduler_thread = NULL;
+
+        os_destroy_semaphore(wake_up);
+        wake_up = NULL;
+    }
+
+    if (NULL != wheel_lock)
+    {
+        os_destroy_mutex(wheel_lock);
+        wheel_lock = NULL;
+    }
+
+    os_memset(pdo, 0, sizeof(pdo));
+    os_memset(wheel, 0, sizeof(wheel));
+    num_scheduled = 0;
+    wheel_tick    = 0;
+}
+
 bool_t pdo_add(uint16 can_id, uint32 event_time_ms, uint8 length, uint64 data, disp_mode_t disp_mode)
 {
-    int i;
+    pdo_t* entry;
+    uint64 now_ms;
 
     if (IS_FALSE == pdo_is_id_valid(can_id))
     {
@@ -37,25 +111,56 @@ bool_t pdo_add(uint16 can_id, uint32 event_time_ms, uint8 length, uint64 data, d
         /* Nothing to do here. */
     }
 
-    for (i = 0; i < PDO_MAX; i += 1)
+    /* Without the scheduler thread it's up to pdo_process() alone. */
+    if (NULL == wheel_lock)
     {
-        if (0 == pdo[i].can_id)
+        wheel_lock = os_create_mutex();
+        if (NULL == wheel_lock)
         {
-            pdo[i].can_id = can_id;
-            pdo[i].length = length;
-            pdo[i].data   = data;
-            pdo[i].id     = os_add_timer(event_time_ms, pdo_send_callback, &pdo[i]);
-            return IS_TRUE;
+            print_error("Could not add PDO: Unable to lock scheduler", disp_mode, can_id);
+            return IS_FALSE;
         }
     }
 
-    print_error("Could not add PDO: No empty slot available", disp_mode, can_id);
-    return IS_FALSE;
+    os_lock_mutex(wheel_lock);
+
+    now_ms = os_get_ticks_us() / 1000;
+
+    /* An idle wheel has stopped ticking, so pick it up at the present.
+     * It never goes back, as ticks that already ran must not run again.
+     */
+    if (0 == num_scheduled)
+    {
+        if (wheel_tick < now_ms)
+        {
+            wheel_tick = now_ms;
+        }
+
+        if (NULL != wake_up)
+        {
+            os_sem_post(wake_up);
+        }
+    }
+
+    entry                = &pdo[can_id];
+    entry->can_id        = can_id;
+    entry->length        = length;
+    entry->data          = data;
+    entry->event_time_ms = event_time_ms;
+    entry->due_ms        = ((wheel_tick > now_ms) ? wheel_tick : now_ms) + event_time_ms;
+    entry->is_active     = IS_TRUE;
+
+    link_pdo(entry);
+    num_scheduled += 1;
+
+    os_unlock_mutex(wheel_lock);
+
+    return IS_TRUE;
 }
 
 bool_t pdo_del(uint16 can_id, disp_mode_t disp_mode)
 {
-    int i;
+    pdo_t* entry;
 
     if (IS_FALSE == pdo_is_id_valid(can_id))
     {
@@ -63,41 +168,210 @@ bool_t pdo_del(uint16 can_id, disp_mode_t disp_mode)
         return IS_FALSE;
     }
 
-    for (i = 0; i < PDO_MAX; i += 1)
+    if (NULL == wheel_lock)
     {
-        if (can_id == pdo[i].can_id)
-        {
-            pdo[i].can_id = 0;
-            pdo[i].length = 0;
-            pdo[i].data   = 0;
+        return IS_TRUE;
+    }
 
-            os_remove_timer(pdo[i].id);
-            break;
-        }
+    os_lock_mutex(wheel_lock);
+
+    entry = &pdo[can_id];
+    if (IS_TRUE == entry->is_active)
+    {
+        unlink_pdo(entry);
+        entry->is_active = IS_FALSE;
+        num_scheduled   -= 1;
     }
 
+    os_unlock_mutex(wheel_lock);
+
     return IS_TRUE;
 }
 
-static uint32 pdo_send_callback(uint32 interval, void *pdo_pt)
+uint32 pdo_process(uint64 now_ms)
+{
+    uint32 num_frames = 0;
+    uint32 num_written;
+
+    if (NULL == wheel_lock)
+    {
+        return 0;
+    }
+
+    os_lock_mutex(wheel_lock);
+
+    if (0 == num_scheduled)
+    {
+        wheel_tick = now_ms + 1;
+    }
+
+    while (wheel_tick <= now_ms)
+    {
+        num_frames = run_tick(now_ms, num_frames);
+    }
+
+    os_unlock_mutex(wheel_lock);
+
+    /* Whatever fell due goes out in one burst. */
+    if (num_frames > 0)
+    {
+        can_write_batch(tx_burst, num_frames, &num_written);
+    }
+
+    return num_frames;
+}
+
+static void cascade(uint32 level, uint32 slot)
+{
+    pdo_t* entry = wheel[level][slot];
+
+    wheel[level][slot] = NULL;
+
+    /* Everything here falls due within this level's next turn, so it
+     * moves down to a finer one.
+     */
+    while (NULL != entry)
+    {
+        pdo_t* next = entry->next;
+
+        link_pdo(entry);
+        entry = next;
+    }
+}
+
+static void link_pdo(pdo_t* entry)
+{
+    pdo_t** head;
+    uint64  delta;
+    uint32  level = 0;
+
+    if (entry->due_ms < wheel_tick)
+    {
+        entry->due_ms = wheel_tick;
+    }
+
+    delta = entry->due_ms - wheel_tick;
+    if (delta > 0xffffffff)
+    {
+        delta         = 0xffffffff;
+        entry->due_ms = wheel_tick + delta;
+    }
+
+    while (((level + 1) < PDO_WHEEL_LEVELS) && (delta >= ((uint64)1 << (8 * (level + 1)))))
+    {
+        level += 1;
+    }
+
+    head = &wheel[level][(entry->due_ms >> (8 * level)) & (PDO_WHEEL_SLOTS - 1)];
+
+    entry->next  = *head;
+    entry->pprev = head;
+    if (NULL != entry->next)
+    {
+        entry->next->pprev = &entry->next;
+    }
+    *head = entry;
+}
+
+static int pdo_thread(void* data)
+{
+    uint64 now_ms;
+    bool_t is_idle;
+
+    (void)data;
+
+    while (IS_TRUE == os_atomic_get(&is_scheduling))
+    {
+        os_lock_mutex(wheel_lock);
+        is_idle = (0 == num_scheduled) ? IS_TRUE : IS_FALSE;
+        os_unlock_mutex(wheel_lock);
+
+        if (IS_TRUE == is_idle)
+        {
+            os_sem_wait_timeout(wake_up, PDO_IDLE_TIMEOUT_MS);
+            continue;
+        }
+
+        now_ms = os_get_ticks_us() / 1000;
+        pdo_process(now_ms);
+
+        os_delay_until_us((now_ms + 1) * 1000);
+    }
+
+    return 0;
+}
+
+static uint32 run_tick(uint64 now_ms, uint32 num_frames)
 {
-    int           i;
-    int           offset  = 0;
-    pdo_t*        pdo     = pdo_pt;
-    can_message_t message = { 0 };
+    pdo_t* entry;
+    uint32 level = 1;
+    uint32 slot  = (uint32)(wheel_tick & (PDO_WHEEL_SLOTS - 1));
+    uint32 index = slot;
 
-    message.id     = pdo->can_id;
-    message.length = pdo->length;
+    while ((0 == index) && (level < PDO_WHEEL_LEVELS))
+    {
+        index = (uint32)((wheel_tick >> (8 * level)) & (PDO_WHEEL_SLOTS - 1));
+        cascade(level, index);
+        level += 1;
+    }
 
-    for (i = (pdo->length - 1); i >= 0; i -= 1)
+    entry          = wheel[0][slot];
+    wheel[0][slot] = NULL;
+
+    while (NULL != entry)
     {
-        message.data[i] = ((pdo->data >> offset) & 0xFF);
-        offset += 8;
+        can_message_t* message = &tx_burst[num_frames];
+        pdo_t*         next    = entry->next;
+        int            i;
+        int            offset  = 0;
+
+        message->id     = entry->can_id;
+        message->length = entry->length;
+        os_memset(message->data, 0, sizeof(message->data));
+
+        for (i = (entry->length - 1); i >= 0; i -= 1)
+        {
+            message->data[i] = ((entry->data >> offset) & 0xFF);
+            offset += 8;
+        }
+        num_frames += 1;
+
+        /* An event time of zero sends once.  Cycles missed while late are
+         * skipped rather than sent in a row.
+         */
+        if (0 == entry->event_time_ms)
+        {
+            entry->is_active = IS_FALSE;
+            num_scheduled   -= 1;
+        }
+        else
+        {
+            entry->due_ms += entry->event_time_ms;
+            if (entry->due_ms <= now_ms)
+            {
+                entry->due_ms = now_ms + entry->event_time_ms;
+            }
+            link_pdo(entry);
+        }
+
+        entry = next;
     }
 
-    can_write(&message, SILENT, NULL);
+    wheel_tick += 1;
+
+    return num_frames;
+}
+
+static void unlink_pdo(pdo_t* entry)
+{
+    *entry->pprev = entry->next;
+    if (NULL != entry->next)
+    {
+        entry->next->pprev = entry->pprev;
+    }
 
-    return interval;
+    entry->next  = NULL;
+    entry->pprev = NULL;
 }
 
 status_t pdo_print_help(void)
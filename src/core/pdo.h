@@ -12,19 +12,35 @@
 
 #include "os.h"
 
-#define PDO_MAX 0x1f8 /* TPDO1 - TPDO4 */
+#define PDO_MAX             0x500 /* Indexed by CAN-ID, up to TPDO4. */
+#define PDO_WHEEL_LEVELS    4
+#define PDO_WHEEL_SLOTS     256
+#define PDO_IDLE_TIMEOUT_MS 100
 
+/* Entries hang off the timing wheel of the scheduler thread, one tick
+ * per millisecond and eight bits of the due time per level.
+ */
 typedef struct pdo
 {
-    os_timer_id id;
-    uint16      can_id;
-    uint8       length;
-    uint64      data;
+    struct pdo*  next;
+    struct pdo** pprev; /* Slot head or the next field pointing here. */
+    uint64       due_ms;
+    uint32       event_time_ms;
+    uint16       can_id;
+    uint8        length;
+    uint64       data;
+    bool_t       is_active;
 
 } pdo_t;
 
+/* pdo_init() starts the scheduler thread, which calls pdo_process() every
+ * millisecond.  Without it, PDOs only go out when pdo_process() is called.
+ */
+status_t pdo_init(void);
+void     pdo_deinit(void);
 bool_t   pdo_add(uint16 can_id, uint32 event_time_ms, uint8 length, uint64 data, disp_mode_t disp_mode);
 bool_t   pdo_del(uint16 can_id, disp_mode_t disp_mode);
+uint32   pdo_process(uint64 now_ms);
 status_t pdo_print_help(void);
 bool_t   pdo_is_id_valid(uint16 can_id);
 
@@ -11,7 +11,9 @@
 #include "lualib.h"
 #include "lauxlib.h"
 #include "dirent.h"
+#include "can.h"
 #include "core.h"
+#include "dispatch.h"
 #include "os.h"
 #include "pocketpy.h"
 #include "scripts.h"
@@ -26,6 +28,8 @@ static size_t   safe_strcpy(char* dest, const char* src, size_t size);
 static bool_t   script_already_listed(char** listed_scripts, int count, const char* script_name);
 static void     strip_lua_extension(char* filename);
 
+static dispatch_sub_t* script_sub;
+
 void scripts_init(core_t *core)
 {
     if (NULL == core)
@@ -101,6 +105,17 @@ void scripts_deinit(core_t* core)
     py_finalize();
 }
 
+dispatch_sub_t* scripts_get_subscriber(void)
+{
+    /* Created on first use, so scripts that never read cost nothing. */
+    if (NULL == script_sub)
+    {
+        script_sub = dispatch_subscribe(NULL, 0, SCRIPT_RING_SIZE);
+    }
+
+    return script_sub;
+}
+
 static char *get_script_description(const char *script_path)
 {
     static  char description[256] = { 0 };
@@ -310,6 +325,10 @@ void run_script(const char *name, core_t *core)
         }
     }
 
+    /* Don't leave a script's receive ring and filters behind. */
+    dispatch_unsubscribe(script_sub);
+    script_sub = NULL;
+
     if (OS_FILE_NOT_FOUND == status)
     {
         os_log(LOG_ERROR, "Script \"%s\" not found.\n", basename);
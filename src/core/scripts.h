@@ -11,11 +11,16 @@
 #define SCRIPTS_H
 
 #include "core.h"
+#include "dispatch.h"
 
-bool_t   has_valid_extension(const char* filename);
-void     scripts_init(core_t* core);
-void     scripts_deinit(core_t* core);
-status_t list_scripts(void);
-void     run_script(const char* name, core_t* core);
+#define SCRIPT_RING_SIZE       2048
+#define SCRIPT_READ_TIMEOUT_MS 100
+
+bool_t          has_valid_extension(const char* filename);
+void            scripts_init(core_t* core);
+void            scripts_deinit(core_t* core);
+dispatch_sub_t* scripts_get_subscriber(void);
+status_t        list_scripts(void);
+void            run_script(const char* name, core_t* core);
 
 #endif /* SCRIPTS_H */
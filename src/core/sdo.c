@@ -12,16 +12,25 @@
 #include "dict.h"
 #include "os.h"
 #include "sdo.h"
+#include "sdo_cache.h"
+#include "sdo_client.h"
 
-#define SEGMENT_DATA_SIZE     7u
 #define MAX_SDO_RESPONSE_SIZE 8u
-#define CAN_BASE_ID           0x600
 #define SDO_TIMEOUT_IN_MS     100u
+#define SDO_RETRIES           1u
 
-static void print_error(const char* reason, sdo_state_t sdo_state, uint8 node_id, uint16 index, uint8 sub_index, const char* comment, disp_mode_t disp_mode);
-static void print_read_result(uint8 node_id, uint16 index, uint8 sub_index, can_message_t* sdo_response, disp_mode_t disp_mode, sdo_state_t sdo_state, const char* comment);
-static void print_write_result(sdo_state_t sdo_state, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, disp_mode_t disp_mode, const char* comment);
-static int  wait_for_response(uint8 node_id, can_message_t* msg_in);
+static void        print_error(const char* reason, sdo_state_t sdo_state, uint8 node_id, uint16 index, uint8 sub_index, const char* comment, disp_mode_t disp_mode);
+static void        print_read_result(uint8 node_id, uint16 index, uint8 sub_index, can_message_t* sdo_response, disp_mode_t disp_mode, sdo_state_t sdo_state, const char* comment);
+static void        print_write_result(sdo_state_t sdo_state, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, disp_mode_t disp_mode, const char* comment);
+static sdo_state_t run_request(const sdo_request_t* request, sdo_completion_t* completion);
+static void        print_failure(const sdo_completion_t* completion, sdo_state_t sdo_state, const char* comment, disp_mode_t disp_mode);
+static uint32      run_many(sdo_item_t* items, uint32 num_items, sdo_request_type_t type);
+static bool_t      read_from_cache(const sdo_request_t* request, sdo_completion_t* completion);
+static void        store_in_cache(const sdo_completion_t* completion);
+static void        drop_from_cache(const sdo_request_t* request);
+
+static uint32 sdo_timeout_ms = SDO_TIMEOUT_IN_MS;
+static uint32 sdo_retries    = SDO_RETRIES;
 
 bool_t is_printable_string(const char *str, size_t length);
 
@@ -98,519 +107,236 @@ const char* sdo_lookup_abort_code(uint32 abort_code)
 
 sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment)
 {
-    can_message_t msg_in      = { 0 };
-    can_message_t msg_out     = { 0 };
-    char          reason[300] = { 0 };
-    sdo_state_t   sdo_state   = IS_READ_EXPEDITED;
-    uint32        abort_code  = 0;
-    uint32        can_status  = 0;
-
-    limit_node_id(&node_id);
-
-    msg_out.id      = CAN_BASE_ID + node_id;
-    msg_out.data[0] = UPLOAD_RESPONSE_SEGMENT_NO_SIZE;
-    msg_out.data[1] = (uint8)(index & 0x00ff);
-    msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
-    msg_out.data[3] = sub_index;
-    msg_out.length  = 8;
-
-    can_read(&msg_in); /* Clear buffer. */
-    os_memset(&msg_in, 0, sizeof(msg_in));
+    sdo_state_t sdo_state;
+    uint8*      data   = NULL;
+    uint32      length = 0;
+    uint32      preview_length;
 
-    can_status = can_write(&msg_out, SILENT, NULL);
-    if (0 != can_status)
+    /* Read the object whole and keep what fits, rather than refusing
+     * anything longer than the response buffer.
+     */
+    sdo_state = sdo_read_data(disp_mode, node_id, index, sub_index, &data, &length, comment);
+    if (ABORT_TRANSFER == sdo_state)
     {
-        print_error(can_get_error_message(can_status), IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
         return ABORT_TRANSFER;
     }
 
-    os_memset(&msg_in, 0, sizeof(msg_in));
-    while (((index & 0x00ff) != msg_in.data[1]) || (((index & 0xff00) >> 8) != msg_in.data[2]))
+    preview_length = (length < (CAN_BUF_SIZE - 1)) ? length : (CAN_BUF_SIZE - 1);
+    if (preview_length > 0)
     {
-        if (0 != wait_for_response(node_id, &msg_in))
-        {
-            print_error(reason, IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
-            return ABORT_TRANSFER;
-        }
+        os_memcpy(sdo_response->data, data, preview_length);
     }
 
-    switch (msg_in.data[0])
-    {
-        case UPLOAD_RESPONSE_SEGMENT_NO_SIZE:
-        case UPLOAD_RESPONSE_SEGMENT_SIZE_IN_DATA:
-            sdo_response->length = msg_in.data[4];
-            sdo_state = IS_READ_SEGMENTED;
-            break;
-        case UPLOAD_RESPONSE_EXPEDITED_4_BYTE:
-        case DOWNLOAD_INIT_EXPEDITED_4_BYTE:
-            sdo_response->length = 4;
-            break;
-        case UPLOAD_RESPONSE_EXPEDITED_3_BYTE:
-        case DOWNLOAD_INIT_EXPEDITED_3_BYTE:
-            sdo_response->length = 3;
-            break;
-        case UPLOAD_RESPONSE_EXPEDITED_2_BYTE:
-        case DOWNLOAD_INIT_EXPEDITED_2_BYTE:
-            sdo_response->length = 2;
-            break;
-        case UPLOAD_RESPONSE_EXPEDITED_1_BYTE:
-        case DOWNLOAD_INIT_EXPEDITED_1_BYTE:
-            sdo_response->length = 1;
-            break;
-        default:
-        case ABORT_TRANSFER: /* Error. */
-            abort_code = (abort_code & 0xffffff00) | msg_in.data[SEGMENT_DATA_SIZE];
-            abort_code = (abort_code & 0xffff00ff) | ((uint32)msg_in.data[6] << 8);
-            abort_code = (abort_code & 0xff00ffff) | ((uint32)msg_in.data[5] << 16);
-            abort_code = (abort_code & 0x00ffffff) | ((uint32)msg_in.data[4] << 24);
-            abort_code = os_swap_be_32(abort_code);
-
-            os_snprintf(reason, 300, "0x%08x: %s", abort_code, sdo_lookup_abort_code((abort_code)));
-            print_error(reason, IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
-            return ABORT_TRANSFER;
-    }
-
-    if (IS_READ_SEGMENTED == sdo_state)
-    {
-        int    n;
-        uint8  cmd            = UPLOAD_SEGMENT_REQUEST_1;
-        uint8  response_index = 0;
-        uint32 data_length    = sdo_response->length;
-        uint8  remainder      = data_length % SEGMENT_DATA_SIZE;
-        uint8  expected_msgs  = (data_length / SEGMENT_DATA_SIZE) + (remainder ? 1 : 0);
-        uint64 timeout_time;
-        uint64 time_a;
-        uint64 time_b;
-        uint64 delta_time;
-        bool_t response_received;
-
-        msg_out.id      = CAN_BASE_ID + node_id;
-        msg_out.length  = 8;
-        msg_out.data[0] = cmd;
-
-        can_status = can_write(&msg_out, SILENT, NULL);
-        if (0 != can_status)
-        {
-            print_error(can_get_error_message(can_status), IS_READ_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
-            return ABORT_TRANSFER;
-        }
+    sdo_response->length               = length;
+    sdo_response->data[preview_length] = '\0';
 
-        for (n = 0; n < expected_msgs; n += 1)
-        {
-            timeout_time      = 0;
-            time_a            = os_get_ticks();
-            response_received = IS_FALSE;
-
-            while ((IS_FALSE == response_received) && (timeout_time < SDO_TIMEOUT_IN_MS))
-            {
-                can_read(&msg_in);
-                if ((0x580 + node_id) == msg_in.id)
-                {
-                    int can_msg_index = 0;
-                    msg_out.data[0]   = cmd;
-
-                    if (0 == (msg_in.data[0] % 2))
-                    {
-                        if (UPLOAD_SEGMENT_REQUEST_1 == cmd)
-                        {
-                            cmd = UPLOAD_SEGMENT_REQUEST_2;
-                        }
-                        else
-                        {
-                            cmd = UPLOAD_SEGMENT_REQUEST_1;
-                        }
-
-                        msg_out.data[0] = cmd;
-
-                        can_status = can_write(&msg_out, SILENT, NULL);
-                        if (0 != can_status)
-                        {
-                            print_error(can_get_error_message(can_status), IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
-                            return ABORT_TRANSFER;
-                        }
-                    }
-
-                    for (can_msg_index = 1; can_msg_index <= SEGMENT_DATA_SIZE; can_msg_index += 1)
-                    {
-                        char printable_char;
-                        if (response_index >= data_length)
-                        {
-                            break;
-                        }
-                        else if (os_isprint(msg_in.data[can_msg_index]))
-                        {
-                            printable_char = msg_in.data[can_msg_index];
-                        }
-                        else
-                        {
-                            break;
-                        }
-                        sdo_response->data[response_index] = printable_char;
-
-                        response_index += 1;
-                    }
-
-                    response_received = IS_TRUE;
-                    continue;
-                }
-
-                time_b = time_a;
-                time_a = os_get_ticks();
-
-                if (time_a > time_b)
-                {
-                    delta_time = time_a - time_b;
-                }
-                else
-                {
-                    delta_time = time_b - time_a;
-                }
-                timeout_time += delta_time;
-            }
-
-            if (timeout_time >= SDO_TIMEOUT_IN_MS)
-            {
-                os_snprintf(reason, 300, "SDO timeout: CAN-dongle present?");
-                print_error(reason, IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
-                return ABORT_TRANSFER;
-            }
-        }
-    }
-    else /* Expedited SDO. */
-    {
-        os_memcpy(&sdo_response->data, &msg_in.data[4], sdo_response->length);
-    }
-
-    print_read_result(node_id, index, sub_index, sdo_response, disp_mode, sdo_state, comment);
+    os_free(data);
     return sdo_state;
 }
 
-sdo_state_t sdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment)
+sdo_state_t sdo_read_data(disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint8** data, uint32* length, const char* comment)
 {
-    can_message_t msg_in       = { 0 };
-    can_message_t msg_out      = { 0 };
-    char          reason[300]  = { 0 };
-    int           n;
-    uint32        abort_code   = 0;
-    uint32        can_status;
-    uint32        u32_value    = 0;
-    uint32*       u32_data_ptr = (uint32*)data;
+    sdo_request_t    request      = { 0 };
+    sdo_completion_t completion   = { 0 };
+    can_message_t    sdo_response = { 0 };
+    uint32           preview_length;
 
-    limit_node_id(&node_id);
-
-    if (NULL != u32_data_ptr)
-    {
-        u32_value = *u32_data_ptr;
-    }
-    else
+    if ((NULL == data) || (NULL == length))
     {
-        print_error("NULL data pointer", IS_WRITE_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
         return ABORT_TRANSFER;
     }
 
-    msg_out.id      = CAN_BASE_ID + node_id;
-    msg_out.data[1] = (uint8)(index & 0x00ff);
-    msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
-    msg_out.data[3] = sub_index;
-    msg_out.data[4] = (uint8)(u32_value & 0x000000ff);
-    msg_out.data[5] = (uint8)((u32_value & 0x0000ff00) >> 8);
-    msg_out.data[6] = (uint8)((u32_value & 0x00ff0000) >> 16);
-    msg_out.data[7] = (uint8)((u32_value & 0xff000000) >> 24);
-    msg_out.length  = 8;
-
-    switch (length)
-    {
-        case 1:
-            msg_out.data[0] = DOWNLOAD_INIT_EXPEDITED_1_BYTE;
-            break;
-        case 2:
-            msg_out.data[0] = DOWNLOAD_INIT_EXPEDITED_2_BYTE;
-            break;
-        case 3:
-            msg_out.data[0] = DOWNLOAD_INIT_EXPEDITED_3_BYTE;
-            break;
-        case 4:
-        default:
-            msg_out.data[0] = DOWNLOAD_INIT_EXPEDITED_4_BYTE;
-            break;
-    }
+    *data   = NULL;
+    *length = 0;
+
+    limit_node_id(&node_id);
 
-    can_status = can_write(&msg_out, SILENT, NULL);
-    if (0 != can_status)
+    /* No destination, so the client allocates whatever the object needs. */
+    request.type      = SDO_REQUEST_READ;
+    request.node_id   = node_id;
+    request.index     = index;
+    request.sub_index = sub_index;
+
+    if (ABORT_TRANSFER == run_request(&request, &completion))
     {
-        print_error(can_get_error_message(can_status), IS_WRITE_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
+        print_failure(&completion, IS_READ_EXPEDITED, comment, disp_mode);
         return ABORT_TRANSFER;
     }
 
-    os_memset(&msg_in, 0, sizeof(msg_in));
-    while (((index & 0x00ff) != msg_in.data[1]) || (((index & 0xff00) >> 8) != msg_in.data[2]))
-    {
-        if (0 != wait_for_response(node_id, &msg_in))
-        {
-            print_error(reason, IS_WRITE_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
-            return ABORT_TRANSFER;
-        }
-    }
+    *data   = completion.request.data;
+    *length = completion.length;
 
-    switch (msg_in.data[0])
+    /* The formatted output only ever shows the beginning. */
+    preview_length = (completion.length < (CAN_BUF_SIZE - 1)) ? completion.length : (CAN_BUF_SIZE - 1);
+    if (preview_length > 0)
     {
-        case UPLOAD_SEGMENT_REQUEST_1:
-        case UPLOAD_SEGMENT_REQUEST_2:
-            sdo_response->length = msg_out.length;
-            break;
-        default:
-        case ABORT_TRANSFER: /* Error. */
-            abort_code = (abort_code & 0xffffff00) | msg_in.data[SEGMENT_DATA_SIZE];
-            abort_code = (abort_code & 0xffff00ff) | ((uint32)msg_in.data[6] << 8);
-            abort_code = (abort_code & 0xff00ffff) | ((uint32)msg_in.data[5] << 16);
-            abort_code = (abort_code & 0x00ffffff) | ((uint32)msg_in.data[4] << 24);
-            abort_code = os_swap_be_32(abort_code);
-
-            os_snprintf(reason, 300, "0x%08x: %s", abort_code, sdo_lookup_abort_code((abort_code)));
-            print_error(reason, IS_WRITE_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
-            return ABORT_TRANSFER;
+        os_memcpy(sdo_response.data, completion.request.data, preview_length);
     }
+    sdo_response.length = completion.length;
 
-    print_write_result(IS_WRITE_EXPEDITED, node_id, index, sub_index, length, data, disp_mode, comment);
-
-    return IS_WRITE_EXPEDITED;
+    print_read_result(node_id, index, sub_index, &sdo_response, disp_mode, completion.sdo_state, comment);
+    return completion.sdo_state;
 }
 
-sdo_state_t sdo_write_block(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* filename, const char* comment)
+sdo_state_t sdo_read_block(disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint8* buffer, uint32* length, const char* comment)
 {
-    can_message_t msg_in         = { 0 };
-    can_message_t msg_out        = { 0 };
-    char          reason[300]    = { 0 };
-    void*         data           = NULL;
-    char*         byte_data      = NULL;
-    FILE*         file           = NULL;
-    long          file_size      = 0;
-    size_t        bytes_sent     = 0;
-    uint32        abort_code     = 0;
-    uint32        can_status     = 0;
-    uint8         block_size     = 0;
-    uint8         segment_number = 1;
-    uint8         i;
-    uint8         remaining_bytes;
-    uint8         final_segment_header;
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
 
-    if (NULL == filename)
+    if ((NULL == buffer) || (NULL == length))
     {
         return ABORT_TRANSFER;
     }
 
-    file = fopen(filename, "rb");
-    if (NULL == file)
-    {
-        return ABORT_TRANSFER;
-    }
+    limit_node_id(&node_id);
 
-    if (fseek(file, 0, SEEK_END) != 0)
-    {
-        fclose(file);
-        return ABORT_TRANSFER;
-    }
-    file_size = ftell(file);
-    if (file_size == -1L)
+    request.type      = SDO_REQUEST_READ_BLOCK;
+    request.node_id   = node_id;
+    request.index     = index;
+    request.sub_index = sub_index;
+    request.data      = buffer;
+    request.length    = *length;
+
+    if (ABORT_TRANSFER == run_request(&request, &completion))
     {
-        fclose(file);
+        *length = 0;
+        print_failure(&completion, IS_READ_BLOCK, comment, disp_mode);
         return ABORT_TRANSFER;
     }
-    rewind(file);
 
-    data = os_calloc((size_t)file_size, sizeof(char));
-    if (NULL == data)
+    *length = completion.length;
+    return completion.sdo_state;
+}
+
+sdo_state_t sdo_read_file(disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* filename, const char* comment)
+{
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    sdo_state_t      sdo_state;
+    FILE_t*          file;
+
+    if (NULL == filename)
     {
-        fclose(file);
         return ABORT_TRANSFER;
     }
 
-    if (fread(data, 1, file_size, file) != file_size)
+    file = os_fopen(filename, "wb");
+    if (NULL == file)
     {
-        os_free(data);
-        fclose(file);
         return ABORT_TRANSFER;
     }
 
     limit_node_id(&node_id);
 
-    msg_out.id      = CAN_BASE_ID + node_id;
-    msg_out.data[0] = UPLOAD_INIT_BLOCK_NO_CRC_SIZE_IN_DATA;
-    msg_out.data[1] = (uint8)(index & 0x00ff);
-    msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
-    msg_out.data[3] = sub_index;
-    msg_out.data[4] = (uint8)(file_size & 0xff);
-    msg_out.data[5] = (uint8)((file_size >> 8) & 0xff);
-    msg_out.data[6] = (uint8)((file_size >> 16) & 0xff);
-    msg_out.data[7] = (uint8)((file_size >> 24) & 0xff);
-    msg_out.length  = 8;
-
-    can_status = can_write(&msg_out, SILENT, NULL);
-    if (0 != can_status)
-    {
-        print_error(can_get_error_message(can_status), IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-        os_free(data);
-        fclose(file);
-        return ABORT_TRANSFER;
-    }
+    request.type      = SDO_REQUEST_READ_BLOCK;
+    request.node_id   = node_id;
+    request.index     = index;
+    request.sub_index = sub_index;
+    request.file      = file;
 
-    os_memset(&msg_in, 0, sizeof(msg_in));
-    while (((index & 0x00ff) != msg_in.data[1]) || (((index & 0xff00) >> 8) != msg_in.data[2]))
+    sdo_state = run_request(&request, &completion);
+    if (ABORT_TRANSFER == sdo_state)
     {
-        if (0 != wait_for_response(node_id, &msg_in))
-        {
-            print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-            os_free(data);
-            fclose(file);
-            return ABORT_TRANSFER;
-        }
+        print_failure(&completion, IS_READ_BLOCK, comment, disp_mode);
     }
 
-    switch (msg_in.data[0])
-    {
-        case BLOCK_DOWNLOAD_RESPONSE_NO_CRC:
-        case BLOCK_DOWNLOAD_RESPONSE_CRC:
-            block_size = msg_in.data[4];
-            break;
-        case ABORT_TRANSFER: /* Error. */
-            abort_code = (abort_code & 0xffffff00) | msg_in.data[SEGMENT_DATA_SIZE];
-            abort_code = (abort_code & 0xffff00ff) | ((uint32)msg_in.data[6] << 8);
-            abort_code = (abort_code & 0xff00ffff) | ((uint32)msg_in.data[5] << 16);
-            abort_code = (abort_code & 0x00ffffff) | ((uint32)msg_in.data[4] << 24);
-            abort_code = os_swap_be_32(abort_code);
-
-            os_snprintf(reason, 300, "0x%08x: %s", abort_code, sdo_lookup_abort_code(abort_code));
-            print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-            os_free(data);
-            fclose(file);
-            return ABORT_TRANSFER;
-    }
+    os_fclose(file);
+    return sdo_state;
+}
+
+sdo_state_t sdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment)
+{
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    uint8            value[4];
 
-    byte_data = (char*)data;
+    limit_node_id(&node_id);
 
-    while (bytes_sent < file_size)
+    if (NULL == data)
     {
-        msg_out.data[0] = segment_number;
+        print_error("NULL data pointer", IS_WRITE_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
 
-        for (i = 0; i < SEGMENT_DATA_SIZE && (bytes_sent + i) < file_size; ++i)
-        {
-            msg_out.data[i + 1] = byte_data[bytes_sent + i];
-        }
+    os_memcpy(value, data, sizeof(value));
 
-        /* Mark last segment of last block. */
-        if ((bytes_sent + SEGMENT_DATA_SIZE) >= file_size)
-        {
-            msg_out.data[0] |= 0x80;
-        }
+    request.type      = SDO_REQUEST_WRITE;
+    request.node_id   = node_id;
+    request.index     = index;
+    request.sub_index = sub_index;
+    request.data      = value;
+    request.length    = ((length > 0) && (length < 4)) ? length : 4;
 
-        can_status = can_write(&msg_out, SILENT, NULL);
-        if (0 != can_status)
-        {
-            print_error(can_get_error_message(can_status), IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-            os_free(data);
-            fclose(file);
-            return ABORT_TRANSFER;
-        }
+    if (ABORT_TRANSFER == run_request(&request, &completion))
+    {
+        print_failure(&completion, IS_WRITE_EXPEDITED, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
 
-        bytes_sent += SEGMENT_DATA_SIZE;
-        segment_number += 1;
+    sdo_response->length = 8;
 
-        if (block_size < segment_number)
-        {
-            msg_in.data[0] = 0x00;
-            msg_in.data[1] = 0x00;
-            msg_in.data[2] = 0x00;
+    print_write_result(IS_WRITE_EXPEDITED, node_id, index, sub_index, length, data, disp_mode, comment);
+    return IS_WRITE_EXPEDITED;
+}
 
-            while ((0xA2 != msg_in.data[0]) || (block_size != msg_in.data[1]))
-            {
-                if (0 != wait_for_response(node_id, &msg_in))
-                {
-                    print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-                    os_free(data);
-                    fclose(file);
-                    return ABORT_TRANSFER;
-                }
-            }
+sdo_state_t sdo_write_block(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* filename, const char* comment)
+{
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    sdo_state_t      sdo_state;
+    FILE_t*          file       = NULL;
+    long             file_size  = 0;
 
-            /* Adjust block_size based on receiver's response. */
-            if (msg_in.data[2] < block_size)
-            {
-                block_size = msg_in.data[2];
-            }
-            segment_number = 1;
-        }
+    if (NULL == filename)
+    {
+        return ABORT_TRANSFER;
     }
 
-    /* Handle the final segment. */
-    remaining_bytes = file_size - bytes_sent;
-
-    switch (remaining_bytes)
+    file = os_fopen(filename, "rb");
+    if (NULL == file)
     {
-        case 7:  final_segment_header = 0xC1; break;
-        case 6:  final_segment_header = 0xC5; break;
-        case 5:  final_segment_header = 0xC9; break;
-        case 4:  final_segment_header = 0xCD; break;
-        case 3:  final_segment_header = 0xD1; break;
-        case 2:  final_segment_header = 0xD5; break;
-        case 1:  final_segment_header = 0xD9; break;
-        default: final_segment_header = 0xDD; break;
+        return ABORT_TRANSFER;
     }
 
-    msg_out.data[0] = final_segment_header;
-
-    for (i = 0; i < SEGMENT_DATA_SIZE; ++i)
+    if (os_fseek(file, 0, SEEK_END) != 0)
     {
-        if (i < remaining_bytes)
-        {
-            msg_out.data[i + 1] = byte_data[bytes_sent + i];
-        }
-        else
-        {
-            msg_out.data[i + 1] = 0x00;
-        }
+        os_fclose(file);
+        return ABORT_TRANSFER;
     }
-
-    can_status = can_write(&msg_out, SILENT, NULL);
-    if (0 != can_status)
+    file_size = os_ftell(file);
+    if (file_size == -1L)
     {
-        print_error(can_get_error_message(can_status), IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-        os_free(data);
-        fclose(file);
+        os_fclose(file);
         return ABORT_TRANSFER;
     }
+    rewind(file);
 
-    while (1)
-    {
-        if (0 != wait_for_response(node_id, &msg_in))
-        {
-            print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-            os_free(data);
-            fclose(file);
-            return ABORT_TRANSFER;
-        }
+    limit_node_id(&node_id);
 
-        if (0xA1 == msg_in.data[0])
-        {
-            break;
-        }
+    /* Segments are read from the file as they go out, so memory use
+     * doesn't depend on the image size.
+     */
+    request.type      = SDO_REQUEST_WRITE_BLOCK;
+    request.node_id   = node_id;
+    request.index     = index;
+    request.sub_index = sub_index;
+    request.length    = (uint32)file_size;
+    request.file      = file;
+
+    sdo_state = run_request(&request, &completion);
+    if (ABORT_TRANSFER == sdo_state)
+    {
+        print_failure(&completion, IS_WRITE_BLOCK, comment, disp_mode);
     }
 
-    os_free(data);
-    fclose(file);
-    return IS_WRITE_BLOCK;
+    os_fclose(file);
+    return sdo_state;
 }
 
 sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment)
 {
-    can_message_t msg_in           = { 0 };
-    can_message_t msg_out          = { 0 };
-    char          reason[300]      = { 0 };
-    int           data_index       = 0;
-    int           remaining_length = length;
-    uint32        abort_code       = 0;
-    uint32        can_status       = 0;
-    uint8         cmd              = UPLOAD_SEGMENT_CONTINUE_1;
-    int           i;
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
 
     if (length <= 4)
     {
@@ -619,117 +345,61 @@ sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mo
 
     limit_node_id(&node_id);
 
-    msg_out.id      = CAN_BASE_ID + node_id;
-    msg_out.data[0] = DOWNLOAD_INIT_SEGMENT_SIZE_IN_DATA;
-    msg_out.data[1] = (uint8)(index & 0x00ff);
-    msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
-    msg_out.data[3] = sub_index;
-    msg_out.data[4] = (uint8)(length & 0x000000ff);
-    msg_out.data[5] = (uint8)((length & 0x0000ff00) >> 8);
-    msg_out.data[6] = (uint8)((length & 0x00ff0000) >> 16);
-    msg_out.data[7] = (uint8)((length & 0xff000000) >> 24);
-    msg_out.length  = 8;
-
-    can_status = can_write(&msg_out, SILENT, NULL);
-    if (0 != can_status)
-    {
-        print_error(can_get_error_message(can_status), IS_WRITE_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
-        return ABORT_TRANSFER;
-    }
-
-    os_memset(&msg_in, 0, sizeof(msg_in));
-    while (((index & 0x00ff) != msg_in.data[1]) || (((index & 0xff00) >> 8) != msg_in.data[2]))
-    {
-        if (0 != wait_for_response(node_id, &msg_in))
-        {
-            print_error(reason, IS_WRITE_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
-            return ABORT_TRANSFER;
-        }
-    }
+    request.type      = SDO_REQUEST_WRITE;
+    request.node_id   = node_id;
+    request.index     = index;
+    request.sub_index = sub_index;
+    request.data      = (uint8*)data;
+    request.length    = length;
 
-    switch (msg_in.data[0])
+    if (ABORT_TRANSFER == run_request(&request, &completion))
     {
-        case UPLOAD_SEGMENT_REQUEST_1:
-        case UPLOAD_SEGMENT_REQUEST_2:
-            sdo_response->length = msg_out.length;
-            break;
-        default:
-        case ABORT_TRANSFER: /* Error. */
-            abort_code = (abort_code & 0xffffff00) | msg_in.data[SEGMENT_DATA_SIZE];
-            abort_code = (abort_code & 0xffff00ff) | ((uint32)msg_in.data[6] << 8);
-            abort_code = (abort_code & 0xff00ffff) | ((uint32)msg_in.data[5] << 16);
-            abort_code = (abort_code & 0x00ffffff) | ((uint32)msg_in.data[4] << 24);
-            abort_code = os_swap_be_32(abort_code);
-
-            os_snprintf(reason, 300, "0x%08x: %s", abort_code, sdo_lookup_abort_code(abort_code));
-            print_error(reason, IS_WRITE_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
-            return ABORT_TRANSFER;
+        print_failure(&completion, IS_WRITE_SEGMENTED, comment, disp_mode);
+        return ABORT_TRANSFER;
     }
 
-    msg_out.id      = CAN_BASE_ID + node_id;
-    msg_out.length  = 8;
-    msg_out.data[0] = cmd;
+    sdo_response->length = 8;
 
-    while (msg_out.data[0] != (cmd | 0x01))
-    {
-        msg_out.data[0] = cmd;
+    print_write_result(IS_WRITE_SEGMENTED, node_id, index, sub_index, length, data, disp_mode, comment);
+    return IS_WRITE_SEGMENTED;
+}
 
-        for (i = 1; i <= 7; i++)
-        {
-            char* data_str = (char*)data;
+uint32 sdo_read_many(sdo_item_t* items, uint32 num_items)
+{
+    return run_many(items, num_items, SDO_REQUEST_READ);
+}
 
-            if ((0 == remaining_length) || ((cmd | 0x01) == msg_out.data[0]))
-            {
-                msg_out.data[i] = 0x00; /* Fill remaining bytes with 0x00. */
-            }
-            else
-            {
-                msg_out.data[i] = data_str[data_index];
-                data_index++;
-                remaining_length--;
-            }
-        }
+uint32 sdo_write_many(sdo_item_t* items, uint32 num_items)
+{
+    return run_many(items, num_items, SDO_REQUEST_WRITE);
+}
 
-        if (0 == remaining_length) /* No more data left to send. */
-        {
-            msg_out.data[0] = (cmd | 0x01);
-        }
+void sdo_set_timeout(uint32 timeout_ms)
+{
+    if (0 == timeout_ms)
+    {
+        timeout_ms = SDO_TIMEOUT_IN_MS;
+    }
 
-        can_status = can_write(&msg_out, SILENT, NULL);
-        if (0 != can_status)
-        {
-            print_error(can_get_error_message(can_status), IS_WRITE_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
-            return ABORT_TRANSFER;
-        }
+    sdo_timeout_ms = timeout_ms;
 
-        if ((cmd | 0x01) == msg_out.data[0])
-        {
-            break;
-        }
+    /* Every node starts over from the new timeout. */
+    sdo_client_reset_rtt();
+}
 
-        if (0 == wait_for_response(node_id, &msg_in))
-        {
-            msg_out.data[0] = cmd;
+uint32 sdo_get_timeout(void)
+{
+    return sdo_timeout_ms;
+}
 
-            switch (msg_in.data[0])
-            {
-                case DOWNLOAD_RESPONSE_1:
-                    cmd = UPLOAD_SEGMENT_CONTINUE_2;
-                    break;
-                case DOWNLOAD_RESPONSE_2:
-                    cmd = UPLOAD_SEGMENT_CONTINUE_1;
-                    break;
-            }
-        }
-        else
-        {
-            print_error(reason, IS_WRITE_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
-            return ABORT_TRANSFER;
-        }
-    }
+void sdo_set_retries(uint32 retries)
+{
+    sdo_retries = retries;
+}
 
-    print_write_result(IS_WRITE_SEGMENTED, node_id, index, sub_index, length, data, disp_mode, comment);
-    return IS_WRITE_SEGMENTED;
+uint32 sdo_get_retries(void)
+{
+    return sdo_retries;
 }
 
 bool_t is_printable_string(const char* str, size_t length)
@@ -762,6 +432,7 @@ static void print_error(const char* reason, sdo_state_t sdo_state, uint8 node_id
             {
                 case IS_READ_EXPEDITED:
                 case IS_READ_SEGMENTED:
+                case IS_READ_BLOCK:
                     os_log(LOG_ERROR, "Index %x, Sub-index %x: 0 byte(s) read error: %s", index, sub_index, reason);
                     break;
                 case IS_WRITE_EXPEDITED:
@@ -782,6 +453,8 @@ static void print_error(const char* reason, sdo_state_t sdo_state, uint8 node_id
             switch (sdo_state)
             {
                 case IS_READ_EXPEDITED:
+                case IS_READ_SEGMENTED:
+                case IS_READ_BLOCK:
                     os_print(color, "Read ");
                     os_print(DEFAULT_COLOR, "    0x%02X    0x%04X  0x%02X      -       ", node_id, index, sub_index);
                     break;
@@ -1087,44 +760,201 @@ void print_write_result(sdo_state_t sdo_state, uint8 node_id, uint16 index, uint
     }
 }
 
-static int wait_for_response(uint8 node_id, can_message_t* msg_in)
+static sdo_state_t run_request(const sdo_request_t* request, sdo_completion_t* completion)
+{
+    uint32 handle;
+
+    if (IS_TRUE == read_from_cache(request, completion))
+    {
+        return completion->sdo_state;
+    }
+
+    drop_from_cache(request);
+
+    handle = sdo_client_submit(request);
+    if ((0 == handle) || (ALL_OK != sdo_client_wait(handle, completion)))
+    {
+        completion->sdo_state  = ABORT_TRANSFER;
+        completion->abort_code = ABORT_GENERAL_ERROR;
+    }
+
+    store_in_cache(completion);
+    return completion->sdo_state;
+}
+
+static uint32 run_many(sdo_item_t* items, uint32 num_items, sdo_request_type_t type)
 {
-    uint64 time_a            = os_get_ticks();
-    uint64 timeout_time      = 0;
-    bool_t response_received = IS_FALSE;
+    uint32 index;
+    uint32 num_ok = 0;
+
+    if (NULL == items)
+    {
+        return 0;
+    }
+
+    /* Submit everything before waiting on anything, the client keeps one
+     * transfer per node going and so works through the nodes side by side.
+     */
+    for (index = 0; index < num_items; index += 1)
+    {
+        sdo_request_t request = { 0 };
+        sdo_item_t*   item    = &items[index];
+
+        limit_node_id(&item->node_id);
+
+        request.type      = type;
+        request.node_id   = item->node_id;
+        request.index     = item->index;
+        request.sub_index = item->sub_index;
+
+        if (SDO_REQUEST_WRITE == type)
+        {
+            request.data   = item->data;
+            request.length = item->length;
+        }
+        else
+        {
+            sdo_completion_t completion = { 0 };
+
+            item->data   = NULL;
+            item->length = 0;
+
+            if (IS_TRUE == read_from_cache(&request, &completion))
+            {
+                item->data       = completion.request.data;
+                item->length     = completion.length;
+                item->sdo_state  = completion.sdo_state;
+                item->abort_code = 0;
+                item->handle     = 0;
+                continue;
+            }
+        }
 
-    while ((IS_FALSE == response_received) && (timeout_time < SDO_TIMEOUT_IN_MS))
+        drop_from_cache(&request);
+
+        item->sdo_state = ABORT_TRANSFER;
+        item->handle    = sdo_client_submit(&request);
+    }
+
+    for (index = 0; index < num_items; index += 1)
     {
-        uint64 time_b;
-        uint64 delta_time;
+        sdo_completion_t completion = { 0 };
+        sdo_item_t*      item       = &items[index];
+
+        /* Answered from the cache already. */
+        if ((0 == item->handle) && (ABORT_TRANSFER != item->sdo_state))
+        {
+            num_ok += 1;
+            continue;
+        }
 
-        can_read(msg_in);
-        if ((0x580 + node_id) == msg_in->id)
+        if ((0 == item->handle) || (ALL_OK != sdo_client_wait(item->handle, &completion)))
         {
-            response_received = IS_TRUE;
+            item->sdo_state  = ABORT_TRANSFER;
+            item->abort_code = ABORT_GENERAL_ERROR;
             continue;
         }
 
-        time_b = time_a;
-        time_a = os_get_ticks();
+        item->sdo_state  = completion.sdo_state;
+        item->abort_code = completion.abort_code;
 
-        if (time_a > time_b)
+        if (SDO_REQUEST_READ == type)
         {
-            delta_time = time_a - time_b;
+            item->data   = completion.request.data;
+            item->length = completion.length;
+            store_in_cache(&completion);
         }
-        else
+
+        if (ABORT_TRANSFER != item->sdo_state)
+        {
+            num_ok += 1;
+        }
+    }
+
+    return num_ok;
+}
+
+static bool_t read_from_cache(const sdo_request_t* request, sdo_completion_t* completion)
+{
+    const sdo_cache_entry_t* entry;
+    uint8*                   data = request->data;
+
+    if (SDO_REQUEST_READ != request->type)
+    {
+        return IS_FALSE;
+    }
+
+    entry = sdo_cache_lookup(request->node_id, request->index, request->sub_index);
+    if (NULL == entry)
+    {
+        return IS_FALSE;
+    }
+
+    /* Hand out a copy just like the client would have. */
+    if (NULL == data)
+    {
+        data = (uint8*)os_calloc(1, (size_t)entry->length + 1);
+        if (NULL == data)
         {
-            delta_time = time_b - time_a;
+            return IS_FALSE;
         }
-        timeout_time += delta_time;
     }
+    else if (entry->length > request->length)
+    {
+        return IS_FALSE;
+    }
+
+    if (entry->length > 0)
+    {
+        os_memcpy(data, entry->data, entry->length);
+    }
+
+    os_memset(completion, 0, sizeof(sdo_completion_t));
+    completion->request      = *request;
+    completion->request.data = data;
+    completion->sdo_state    = entry->sdo_state;
+    completion->length       = entry->length;
+
+    return IS_TRUE;
+}
+
+static void store_in_cache(const sdo_completion_t* completion)
+{
+    if ((SDO_REQUEST_READ != completion->request.type) || (ABORT_TRANSFER == completion->sdo_state))
+    {
+        return;
+    }
+
+    sdo_cache_store(
+        completion->request.node_id,
+        completion->request.index,
+        completion->request.sub_index,
+        completion->sdo_state,
+        completion->request.data,
+        completion->length);
+}
+
+static void drop_from_cache(const sdo_request_t* request)
+{
+    /* Even a write that fails may have reached the object. */
+    if ((SDO_REQUEST_WRITE == request->type) || (SDO_REQUEST_WRITE_BLOCK == request->type))
+    {
+        sdo_cache_remove(request->node_id, request->index, request->sub_index);
+    }
+}
 
-    if (timeout_time >= SDO_TIMEOUT_IN_MS)
+static void print_failure(const sdo_completion_t* completion, sdo_state_t sdo_state, const char* comment, disp_mode_t disp_mode)
+{
+    char reason[300] = { 0 };
+
+    if (0 != completion->can_status)
+    {
+        os_snprintf(reason, sizeof(reason), "%s", can_get_error_message(completion->can_status));
+    }
+    else
     {
-        char reason[300] = { 0 };
-        os_snprintf(reason, 300, "SDO timeout: CAN-dongle present?");
-        return 1;
+        os_snprintf(reason, sizeof(reason), "0x%08x: %s", completion->abort_code, sdo_lookup_abort_code(completion->abort_code));
     }
 
-    return 0;
+    print_error(reason, sdo_state, completion->request.node_id, completion->request.index, completion->request.sub_index, comment, disp_mode);
 }
@@ -101,10 +101,38 @@ typedef enum
 
 } sdo_abort_code_t;
 
+/* One object of a batched transfer.  Reads hand back a buffer that has
+ * to be released with os_free(), writes send length bytes from data.
+ */
+typedef struct sdo_item
+{
+    uint8       node_id;
+    uint16      index;
+    uint8       sub_index;
+    uint8*      data;
+    uint32      length;
+    sdo_state_t sdo_state;
+    uint32      abort_code;
+    uint32      handle;
+
+} sdo_item_t;
+
+/* sdo_read() keeps as much of the object as fits into the response and
+ * reports its full length, which is larger if it was cut short.
+ */
 const char* sdo_lookup_abort_code(uint32 abort_code);
 sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment);
+sdo_state_t sdo_read_data(disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint8** data, uint32* length, const char* comment);
+sdo_state_t sdo_read_block(disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint8* buffer, uint32* length, const char* comment);
+sdo_state_t sdo_read_file(disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* filename, const char* comment);
 sdo_state_t sdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment);
 sdo_state_t sdo_write_block(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* filename, const char* comment);
 sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment);
+uint32      sdo_read_many(sdo_item_t* items, uint32 num_items);
+uint32      sdo_write_many(sdo_item_t* items, uint32 num_items);
+void        sdo_set_timeout(uint32 timeout_ms);
+uint32      sdo_get_timeout(void);
+void        sdo_set_retries(uint32 retries);
+uint32      sdo_get_retries(void);
 
 #endif /* SDO_H */
@@ -0,0 +1,359 @@
+/** @file sdo_cache.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "can.h"
+#include "core.h"
+#include "dispatch.h"
+#include "os.h"
+#include "sdo.h"
+#include "sdo_cache.h"
+#include "sdo_client.h"
+
+#define NMT_ERROR_CONTROL_ID 0x700
+#define NMT_BOOT_UP          0x00
+
+typedef struct sdo_cache_mark
+{
+    uint32 key;
+    bool_t is_cacheable;
+
+} sdo_cache_mark_t;
+
+static uint32 make_key(uint8 node_id, uint16 index, uint8 sub_index);
+static bool_t is_cacheable(uint8 node_id, uint16 index, uint8 sub_index);
+static bool_t find_mark(uint32 key, uint32* position);
+static void   poll_boot_up(void);
+static void   free_node(uint8 node_id);
+
+static sdo_cache_entry_t* buckets[SDO_CLIENT_MAX_NODES][SDO_CACHE_BUCKETS];
+static sdo_cache_mark_t*  marks;
+static uint32             num_marks;
+static uint32             marks_capacity;
+static dispatch_sub_t*    boot_up_sub;
+static can_message_t      boot_up_frames[CAN_BATCH_SIZE];
+static uint32             num_overruns;
+static bool_t             is_disabled;
+
+/* Constant by CiA 301: device type, names, versions and identity. */
+static const uint32 default_keys[] =
+{
+    0x00100000, 0x00100800, 0x00100900, 0x00100a00,
+    0x00101800, 0x00101801, 0x00101802, 0x00101803, 0x00101804
+};
+
+void sdo_cache_enable(bool_t is_enabled)
+{
+    is_disabled = (IS_TRUE == is_enabled) ? IS_FALSE : IS_TRUE;
+
+    if (IS_TRUE == is_disabled)
+    {
+        sdo_cache_invalidate(0);
+    }
+}
+
+bool_t sdo_cache_is_enabled(void)
+{
+    return (IS_TRUE == is_disabled) ? IS_FALSE : IS_TRUE;
+}
+
+void sdo_cache_mark(uint8 node_id, uint16 index, uint8 sub_index, bool_t is_cacheable)
+{
+    sdo_cache_mark_t* mark;
+    uint32            key = make_key(node_id, index, sub_index);
+    uint32            position;
+
+    if (node_id >= SDO_CLIENT_MAX_NODES)
+    {
+        return;
+    }
+
+    if (IS_FALSE == find_mark(key, &position))
+    {
+        if (num_marks == marks_capacity)
+        {
+            uint32 capacity = (0 == marks_capacity) ? 64 : (marks_capacity * 2);
+
+            mark = (sdo_cache_mark_t*)os_realloc(marks, capacity * sizeof(sdo_cache_mark_t));
+            if (NULL == mark)
+            {
+                return;
+            }
+
+            marks          = mark;
+            marks_capacity = capacity;
+        }
+
+        /* Kept sorted by key for the lookup on every read. */
+        os_memmove(&marks[position + 1], &marks[position], (num_marks - position) * sizeof(sdo_cache_mark_t));
+        marks[position].key = key;
+        num_marks += 1;
+    }
+
+    marks[position].is_cacheable = is_cacheable;
+
+    /* Drop whatever was cached under the old mark. */
+    if (IS_FALSE == is_cacheable)
+    {
+        sdo_cache_invalidate(node_id);
+    }
+}
+
+const sdo_cache_entry_t* sdo_cache_lookup(uint8 node_id, uint16 index, uint8 sub_index)
+{
+    sdo_cache_entry_t* entry;
+
+    if ((IS_TRUE == is_disabled) || (0 == node_id) || (node_id >= SDO_CLIENT_MAX_NODES))
+    {
+        return NULL;
+    }
+
+    poll_boot_up();
+
+    for (entry = buckets[node_id][(index ^ sub_index) & (SDO_CACHE_BUCKETS - 1)]; NULL != entry; entry = entry->next)
+    {
+        if ((index == entry->index) && (sub_index == entry->sub_index))
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+void sdo_cache_store(uint8 node_id, uint16 index, uint8 sub_index, sdo_state_t sdo_state, const uint8* data, uint32 length)
+{
+    sdo_cache_entry_t** bucket;
+    sdo_cache_entry_t*  entry;
+
+    if ((IS_TRUE == is_disabled) || (0 == node_id) || (node_id >= SDO_CLIENT_MAX_NODES))
+    {
+        return;
+    }
+
+    if ((length > SDO_CACHE_MAX_LENGTH) || ((length > 0) && (NULL == data)))
+    {
+        return;
+    }
+
+    if (IS_FALSE == is_cacheable(node_id, index, sub_index))
+    {
+        return;
+    }
+
+    /* Boot-ups only need watching once there's something to drop. */
+    if (NULL == boot_up_sub)
+    {
+        can_filter_t filter;
+
+        filter.id          = NMT_ERROR_CONTROL_ID;
+        filter.mask        = 0x780;
+        filter.is_extended = IS_FALSE;
+
+        boot_up_sub = dispatch_subscribe(&filter, 1, SDO_CACHE_RING_SIZE);
+        if (NULL == boot_up_sub)
+        {
+            return;
+        }
+        num_overruns = 0;
+    }
+
+    if (NULL != sdo_cache_lookup(node_id, index, sub_index))
+    {
+        return;
+    }
+
+    entry = (sdo_cache_entry_t*)os_calloc(1, sizeof(sdo_cache_entry_t) + length + 1);
+    if (NULL == entry)
+    {
+        return;
+    }
+
+    entry->index     = index;
+    entry->sub_index = sub_index;
+    entry->sdo_state = sdo_state;
+    entry->length    = length;
+    entry->data      = (uint8*)(entry + 1);
+
+    if (length > 0)
+    {
+        os_memcpy(entry->data, data, length);
+    }
+
+    bucket      = &buckets[node_id][(index ^ sub_index) & (SDO_CACHE_BUCKETS - 1)];
+    entry->next = *bucket;
+    *bucket     = entry;
+}
+
+void sdo_cache_remove(uint8 node_id, uint16 index, uint8 sub_index)
+{
+    sdo_cache_entry_t** link;
+
+    if ((0 == node_id) || (node_id >= SDO_CLIENT_MAX_NODES))
+    {
+        return;
+    }
+
+    for (link = &buckets[node_id][(index ^ sub_index) & (SDO_CACHE_BUCKETS - 1)]; NULL != *link; link = &(*link)->next)
+    {
+        if ((index == (*link)->index) && (sub_index == (*link)->sub_index))
+        {
+            sdo_cache_entry_t* entry = *link;
+
+            *link = entry->next;
+            os_free(entry);
+            return;
+        }
+    }
+}
+
+void sdo_cache_invalidate(uint8 node_id)
+{
+    uint32 id;
+
+    if (node_id >= SDO_CLIENT_MAX_NODES)
+    {
+        return;
+    }
+
+    if (0 != node_id)
+    {
+        free_node(node_id);
+        return;
+    }
+
+    for (id = 1; id < SDO_CLIENT_MAX_NODES; id += 1)
+    {
+        free_node((uint8)id);
+    }
+}
+
+void sdo_cache_deinit(void)
+{
+    sdo_cache_invalidate(0);
+
+    os_free(marks);
+    marks          = NULL;
+    num_marks      = 0;
+    marks_capacity = 0;
+
+    dispatch_unsubscribe(boot_up_sub);
+    boot_up_sub = NULL;
+}
+
+static uint32 make_key(uint8 node_id, uint16 index, uint8 sub_index)
+{
+    return ((uint32)node_id << 24) | ((uint32)index << 8) | (uint32)sub_index;
+}
+
+static bool_t is_cacheable(uint8 node_id, uint16 index, uint8 sub_index)
+{
+    uint32 position;
+    uint32 key = make_key(0, index, sub_index);
+
+    /* A mark for the node wins over one for all nodes, which wins over
+     * the defaults.
+     */
+    if (IS_TRUE == find_mark(make_key(node_id, index, sub_index), &position))
+    {
+        return marks[position].is_cacheable;
+    }
+
+    if (IS_TRUE == find_mark(key, &position))
+    {
+        return marks[position].is_cacheable;
+    }
+
+    for (position = 0; position < (sizeof(default_keys) / sizeof(default_keys[0])); position += 1)
+    {
+        if (key == default_keys[position])
+        {
+            return IS_TRUE;
+        }
+    }
+
+    return IS_FALSE;
+}
+
+static bool_t find_mark(uint32 key, uint32* position)
+{
+    uint32 low  = 0;
+    uint32 high = num_marks;
+
+    while (low < high)
+    {
+        uint32 middle = low + ((high - low) / 2);
+
+        if (marks[middle].key < key)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    *position = low;
+    return ((low < num_marks) && (key == marks[low].key)) ? IS_TRUE : IS_FALSE;
+}
+
+static void poll_boot_up(void)
+{
+    uint32 num_read;
+    uint32 index;
+    uint32 overruns;
+
+    if (NULL == boot_up_sub)
+    {
+        return;
+    }
+
+    do
+    {
+        num_read = dispatch_read(boot_up_sub, boot_up_frames, CAN_BATCH_SIZE, 0);
+
+        for (index = 0; index < num_read; index += 1)
+        {
+            if ((boot_up_frames[index].length >= 1) && (NMT_BOOT_UP == boot_up_frames[index].data[0]))
+            {
+                free_node((uint8)(boot_up_frames[index].id - NMT_ERROR_CONTROL_ID));
+            }
+        }
+    }
+    while (CAN_BATCH_SIZE == num_read);
+
+    /* Heartbeats may have pushed out a boot-up, so trust nothing. */
+    overruns = dispatch_get_overruns(boot_up_sub);
+    if (overruns != num_overruns)
+    {
+        num_overruns = overruns;
+        sdo_cache_invalidate(0);
+    }
+}
+
+static void free_node(uint8 node_id)
+{
+    uint32 bucket;
+
+    if ((0 == node_id) || (node_id >= SDO_CLIENT_MAX_NODES))
+    {
+        return;
+    }
+
+    for (bucket = 0; bucket < SDO_CACHE_BUCKETS; bucket += 1)
+    {
+        while (NULL != buckets[node_id][bucket])
+        {
+            sdo_cache_entry_t* entry = buckets[node_id][bucket];
+
+            buckets[node_id][bucket] = entry->next;
+            os_free(entry);
+        }
+    }
+}
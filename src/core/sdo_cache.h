@@ -0,0 +1,46 @@
+/** @file sdo_cache.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef SDO_CACHE_H
+#define SDO_CACHE_H
+
+#include "core.h"
+#include "os.h"
+#include "sdo.h"
+
+#define SDO_CACHE_BUCKETS    16
+#define SDO_CACHE_MAX_LENGTH 1024u
+#define SDO_CACHE_RING_SIZE  1024
+
+typedef struct sdo_cache_entry
+{
+    uint16                  index;
+    uint8                   sub_index;
+    sdo_state_t             sdo_state;
+    uint32                  length;
+    uint8*                  data;
+    struct sdo_cache_entry* next;
+
+} sdo_cache_entry_t;
+
+/* Only objects marked cacheable are kept, either for one node or, with
+ * node ID 0, for all of them.  A node's entries are dropped as soon as it
+ * is reset through NMT or announces its boot-up, a single entry whenever
+ * the object is written.
+ */
+void                     sdo_cache_enable(bool_t is_enabled);
+bool_t                   sdo_cache_is_enabled(void);
+void                     sdo_cache_mark(uint8 node_id, uint16 index, uint8 sub_index, bool_t is_cacheable);
+const sdo_cache_entry_t* sdo_cache_lookup(uint8 node_id, uint16 index, uint8 sub_index);
+void                     sdo_cache_store(uint8 node_id, uint16 index, uint8 sub_index, sdo_state_t sdo_state, const uint8* data, uint32 length);
+void                     sdo_cache_remove(uint8 node_id, uint16 index, uint8 sub_index);
+void                     sdo_cache_invalidate(uint8 node_id);
+void                     sdo_cache_deinit(void);
+
+#endif /* SDO_CACHE_H */
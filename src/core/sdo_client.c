@@ -0,0 +1,1483 @@
+/** @file sdo_client.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "can.h"
+#include "core.h"
+#include "dispatch.h"
+#include "os.h"
+#include "sdo.h"
+#include "sdo_client.h"
+
+#define SDO_RX_BASE_ID        0x580
+#define SDO_TX_BASE_ID        0x600
+#define SDO_SEGMENT_SIZE      7u
+#define SDO_MAX_BLOCK_SIZE    127u
+#define SDO_SWITCH_THRESHOLD  21u
+#define SDO_RTO_MIN_MS        10u
+#define SDO_RTO_MAX_MS        5000u
+#define SDO_FRAME_TIME_MS     14u /* Stuffed 8-byte frame at 10 kbit/s. */
+#define SDO_BLOCK_RETRIES     3u
+
+#define CCS_DOWNLOAD_SEGMENT  0x00
+#define CCS_DOWNLOAD_INIT     0x20
+#define CCS_UPLOAD_INIT       0x40
+#define CCS_UPLOAD_SEGMENT    0x60
+#define CCS_ABORT             0x80
+#define CCS_BLOCK_UPLOAD      0xa0
+#define CCS_BLOCK_DOWNLOAD    0xc0
+
+#define SCS_UPLOAD_SEGMENT    0x00
+#define SCS_DOWNLOAD_SEGMENT  0x20
+#define SCS_UPLOAD_INIT       0x40
+#define SCS_DOWNLOAD_INIT     0x60
+#define SCS_ABORT             0x80
+#define SCS_BLOCK_DOWNLOAD    0xa0
+#define SCS_BLOCK_UPLOAD      0xc0
+
+#define SDO_TOGGLE_BIT        0x10
+#define SDO_LAST_SEGMENT_BIT  0x01
+#define SDO_EXPEDITED_BIT     0x02
+#define SDO_SIZE_BIT          0x01
+#define SDO_BLOCK_SIZE_BIT    0x02
+#define SDO_LAST_BLOCK_BIT    0x80
+#define SDO_CRC_BIT           0x04
+
+#define SDO_BLOCK_END         0x01
+#define SDO_BLOCK_ACK         0x02
+#define SDO_BLOCK_START       0x03
+
+typedef enum sdo_phase
+{
+    SDO_PHASE_UPLOAD_INIT = 0,
+    SDO_PHASE_UPLOAD_SEGMENT,
+    SDO_PHASE_DOWNLOAD_INIT,
+    SDO_PHASE_DOWNLOAD_SEGMENT,
+    SDO_PHASE_BLOCK_DOWNLOAD_INIT,
+    SDO_PHASE_BLOCK_DOWNLOAD_ACK,
+    SDO_PHASE_BLOCK_DOWNLOAD_END,
+    SDO_PHASE_BLOCK_UPLOAD_INIT,
+    SDO_PHASE_BLOCK_UPLOAD_DATA,
+    SDO_PHASE_BLOCK_UPLOAD_END
+
+} sdo_phase_t;
+
+typedef struct sdo_job
+{
+    uint32          handle;
+    sdo_request_t   request;
+    sdo_phase_t     phase;
+    sdo_state_t     sdo_state;
+    uint32          offset;
+    uint32          size;
+    uint32          segment_length;
+    uint32          block_start;
+    uint8           toggle;
+    uint8           block_size;
+    uint8           seqno;
+    uint8           segment[SDO_SEGMENT_SIZE];
+    bool_t          has_segment;
+    bool_t          is_last_block;
+    bool_t          is_crc;
+    bool_t          is_allocated;
+    uint16          crc;
+    uint32          file_position;
+    uint32          crc_length;
+    uint64          deadline;
+    uint64          sent_at;
+    uint64          started_at;
+    uint32          elapsed_ms;
+    uint32          rto;
+    uint32          retries;
+    uint8           request_frame[8];
+    uint8           init_answer[8];
+    bool_t          is_timing;
+    bool_t          is_retransmitted;
+    uint32          abort_code;
+    uint32          can_status;
+    struct sdo_job* next;
+
+} sdo_job_t;
+
+/* Round-trip time estimate as in RFC 6298, kept in fixed point. */
+typedef struct sdo_rtt
+{
+    uint32 srtt;    /* Smoothed round-trip time in 1/8 ms. */
+    uint32 rttvar;  /* Round-trip time variation in 1/4 ms. */
+    uint32 rto;     /* Response timeout in ms. */
+    bool_t is_measured;
+
+} sdo_rtt_t;
+
+typedef struct sdo_node
+{
+    sdo_job_t* active;
+    sdo_job_t* head;
+    sdo_job_t* tail;
+    sdo_rtt_t  rtt;
+
+} sdo_node_t;
+
+static void   start_job(sdo_job_t* job);
+static void   start_next_jobs(sdo_node_t* node);
+static void   finish_job(sdo_job_t* job, sdo_state_t sdo_state);
+static void   take_completion(sdo_job_t* job, sdo_job_t* prev, sdo_completion_t* completion);
+static void   free_job(sdo_job_t* job);
+static void   abort_job(sdo_job_t* job, uint32 abort_code);
+static void   handle_timeout(sdo_job_t* job);
+static void   handle_frame(sdo_job_t* job, const can_message_t* msg_in);
+static void   handle_upload(sdo_job_t* job, const can_message_t* msg_in);
+static void   handle_download(sdo_job_t* job, const can_message_t* msg_in);
+static void   handle_block_download(sdo_job_t* job, const can_message_t* msg_in);
+static void   handle_block_upload(sdo_job_t* job, const can_message_t* msg_in);
+static void   receive_segment(sdo_job_t* job, const can_message_t* msg_in);
+static void   send_block_ack(sdo_job_t* job, bool_t is_complete);
+static uint32 store_data(sdo_job_t* job, const uint8* data, uint32 length);
+static uint32 reserve_data(sdo_job_t* job, uint32 size);
+static uint32 load_data(sdo_job_t* job, uint32 offset, uint8* data, uint32 length);
+static void   send_download_segment(sdo_job_t* job);
+static void   send_sub_block(sdo_job_t* job);
+static bool_t send_frame(sdo_job_t* job, const uint8 data[8]);
+static bool_t is_same_object(const sdo_job_t* job, const can_message_t* msg_in);
+static bool_t is_init_phase(const sdo_job_t* job);
+static uint32 get_initial_rto(const sdo_node_t* node);
+static void   update_rtt(sdo_rtt_t* rtt, uint32 sample_ms);
+static uint32 back_off(uint32 rto);
+static uint32 get_max_rto(void);
+static void   set_multiplexer(const sdo_job_t* job, uint8 data[8]);
+static uint16 crc16(uint16 crc, const uint8* data, uint32 length);
+static uint16 get_u16(const uint8* data);
+static uint32 get_u32(const uint8* data);
+static void   put_u32(uint8* data, uint32 value);
+
+static sdo_node_t      nodes[SDO_CLIENT_MAX_NODES];
+static sdo_job_t*      done_head;
+static sdo_job_t*      done_tail;
+static dispatch_sub_t* client_sub;
+static uint32          next_handle = 1;
+static uint32          num_pending;
+static bool_t          is_starting;
+static can_message_t   rx_frames[CAN_BATCH_SIZE];
+static sdo_rtt_t       bus_rtt;
+
+/* CRC-16-CCITT as required by CiA 301: polynomial 0x1021, seed 0. */
+static const uint16 crc_table[256] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
+    0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
+    0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
+    0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,
+    0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
+    0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
+    0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
+    0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
+    0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
+    0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
+    0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,
+    0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
+    0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
+    0x02b1, 0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
+    0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
+    0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
+    0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
+    0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
+    0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
+    0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
+    0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
+    0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0
+};
+
+uint32 sdo_client_submit(const sdo_request_t* request)
+{
+    sdo_job_t*  job;
+    sdo_node_t* node;
+
+    if ((NULL == request) || (0 == request->node_id) || (request->node_id >= SDO_CLIENT_MAX_NODES))
+    {
+        return 0;
+    }
+
+    if ((NULL == request->data) && (NULL == request->file) && (request->length > 0))
+    {
+        return 0;
+    }
+
+    if (NULL == client_sub)
+    {
+        can_filter_t filter;
+
+        filter.id          = SDO_RX_BASE_ID;
+        filter.mask        = 0x780;
+        filter.is_extended = IS_FALSE;
+
+        client_sub = dispatch_subscribe(&filter, 1, SDO_CLIENT_RING_SIZE);
+        if (NULL == client_sub)
+        {
+            return 0;
+        }
+    }
+    else if (0 == num_pending)
+    {
+        /* Nothing is listening while idle, so drop whatever is stale. */
+        dispatch_flush(client_sub);
+        dispatch_pause(client_sub, IS_FALSE);
+    }
+
+    job = (sdo_job_t*)os_calloc(1, sizeof(sdo_job_t));
+    if (NULL == job)
+    {
+        return 0;
+    }
+
+    os_memcpy(&job->request, request, sizeof(sdo_request_t));
+
+    /* Reads without a destination get a buffer that grows as needed. */
+    if (((SDO_REQUEST_READ == request->type) || (SDO_REQUEST_READ_BLOCK == request->type)) &&
+        (NULL == request->data) && (NULL == request->file))
+    {
+        job->is_allocated   = IS_TRUE;
+        job->request.length = 0;
+    }
+
+    job->handle  = next_handle;
+    next_handle += 1;
+    if (0 == next_handle)
+    {
+        next_handle = 1;
+    }
+
+    num_pending += 1;
+
+    /* A server handles one transfer at a time, so queue per node. */
+    node = &nodes[request->node_id];
+    if (NULL == node->tail)
+    {
+        node->head = job;
+    }
+    else
+    {
+        node->tail->next = job;
+    }
+    node->tail = job;
+
+    start_next_jobs(node);
+
+    return job->handle;
+}
+
+status_t sdo_client_process(uint32 timeout_ms)
+{
+    uint64 now;
+    uint64 next_deadline;
+    uint32 num_read;
+    uint32 index;
+    uint32 node_id;
+
+    if (0 == num_pending)
+    {
+        return NOTHING_TO_DO;
+    }
+
+    /* Don't sleep past the first transfer that's due to time out. */
+    now           = os_get_ticks();
+    next_deadline = now + timeout_ms;
+
+    for (node_id = 1; node_id < SDO_CLIENT_MAX_NODES; node_id += 1)
+    {
+        if ((NULL != nodes[node_id].active) && (nodes[node_id].active->deadline < next_deadline))
+        {
+            next_deadline = nodes[node_id].active->deadline;
+        }
+    }
+
+    num_read = dispatch_read(client_sub, rx_frames, CAN_BATCH_SIZE, (next_deadline > now) ? (uint32)(next_deadline - now) : 0);
+
+    for (index = 0; index < num_read; index += 1)
+    {
+        node_id = rx_frames[index].id - SDO_RX_BASE_ID;
+
+        if ((node_id < SDO_CLIENT_MAX_NODES) && (NULL != nodes[node_id].active))
+        {
+            handle_frame(nodes[node_id].active, &rx_frames[index]);
+        }
+    }
+
+    now = os_get_ticks();
+    for (node_id = 1; node_id < SDO_CLIENT_MAX_NODES; node_id += 1)
+    {
+        if ((NULL != nodes[node_id].active) && (now >= nodes[node_id].active->deadline))
+        {
+            handle_timeout(nodes[node_id].active);
+        }
+    }
+
+    return ALL_OK;
+}
+
+bool_t sdo_client_get_completion(sdo_completion_t* completion)
+{
+    if ((NULL == completion) || (NULL == done_head))
+    {
+        return IS_FALSE;
+    }
+
+    take_completion(done_head, NULL, completion);
+    return IS_TRUE;
+}
+
+status_t sdo_client_wait(uint32 handle, sdo_completion_t* completion)
+{
+    if (NULL == completion)
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    while (1)
+    {
+        sdo_job_t* job;
+        sdo_job_t* prev = NULL;
+
+        /* Leave other callers' completions queued in their order. */
+        for (job = done_head; NULL != job; prev = job, job = job->next)
+        {
+            if (handle == job->handle)
+            {
+                take_completion(job, prev, completion);
+                return ALL_OK;
+            }
+        }
+
+        if (NOTHING_TO_DO == sdo_client_process(sdo_get_timeout()))
+        {
+            return ITEM_NOT_FOUND;
+        }
+    }
+}
+
+uint32 sdo_client_get_pending(void)
+{
+    return num_pending;
+}
+
+uint32 sdo_client_get_rto(uint8 node_id)
+{
+    if ((0 == node_id) || (node_id >= SDO_CLIENT_MAX_NODES))
+    {
+        return sdo_get_timeout();
+    }
+
+    return get_initial_rto(&nodes[node_id]);
+}
+
+void sdo_client_reset_rtt(void)
+{
+    uint32 node_id;
+
+    for (node_id = 0; node_id < SDO_CLIENT_MAX_NODES; node_id += 1)
+    {
+        os_memset(&nodes[node_id].rtt, 0, sizeof(sdo_rtt_t));
+    }
+
+    os_memset(&bus_rtt, 0, sizeof(sdo_rtt_t));
+}
+
+void sdo_client_deinit(void)
+{
+    uint32 node_id;
+
+    for (node_id = 0; node_id < SDO_CLIENT_MAX_NODES; node_id += 1)
+    {
+        while (NULL != nodes[node_id].head)
+        {
+            sdo_job_t* job = nodes[node_id].head;
+
+            nodes[node_id].head = job->next;
+            free_job(job);
+        }
+
+        free_job(nodes[node_id].active);
+        nodes[node_id].active = NULL;
+        nodes[node_id].tail   = NULL;
+    }
+
+    sdo_client_reset_rtt();
+
+    while (NULL != done_head)
+    {
+        sdo_job_t* job = done_head;
+
+        done_head = job->next;
+        free_job(job);
+    }
+    done_tail = NULL;
+
+    num_pending = 0;
+
+    dispatch_unsubscribe(client_sub);
+    client_sub = NULL;
+}
+
+static void start_job(sdo_job_t* job)
+{
+    uint8 data[8] = { 0 };
+
+    job->started_at = os_get_ticks();
+    job->rto        = get_initial_rto(&nodes[job->request.node_id]);
+    job->retries    = sdo_get_retries();
+
+    set_multiplexer(job, data);
+
+    switch (job->request.type)
+    {
+        case SDO_REQUEST_READ:
+            job->phase     = SDO_PHASE_UPLOAD_INIT;
+            job->sdo_state = IS_READ_EXPEDITED;
+            data[0]        = CCS_UPLOAD_INIT;
+            break;
+        case SDO_REQUEST_WRITE:
+            if ((job->request.length > 0) && (job->request.length <= 4))
+            {
+                job->phase     = SDO_PHASE_DOWNLOAD_INIT;
+                job->sdo_state = IS_WRITE_EXPEDITED;
+                data[0]        = CCS_DOWNLOAD_INIT | ((4 - job->request.length) << 2) | SDO_EXPEDITED_BIT | SDO_SIZE_BIT;
+
+                job->abort_code = load_data(job, 0, &data[4], job->request.length);
+                if (0 != job->abort_code)
+                {
+                    finish_job(job, ABORT_TRANSFER);
+                    return;
+                }
+            }
+            else
+            {
+                job->phase     = SDO_PHASE_DOWNLOAD_INIT;
+                job->sdo_state = IS_WRITE_SEGMENTED;
+                data[0]        = CCS_DOWNLOAD_INIT | SDO_SIZE_BIT;
+                put_u32(&data[4], job->request.length);
+            }
+            break;
+        case SDO_REQUEST_WRITE_BLOCK:
+            job->phase     = SDO_PHASE_BLOCK_DOWNLOAD_INIT;
+            job->sdo_state = IS_WRITE_BLOCK;
+            data[0]        = CCS_BLOCK_DOWNLOAD | SDO_CRC_BIT | SDO_BLOCK_SIZE_BIT;
+            put_u32(&data[4], job->request.length);
+            break;
+        case SDO_REQUEST_READ_BLOCK:
+            job->phase      = SDO_PHASE_BLOCK_UPLOAD_INIT;
+            job->sdo_state  = IS_READ_BLOCK;
+            job->block_size = SDO_MAX_BLOCK_SIZE;
+            data[0]         = CCS_BLOCK_UPLOAD | SDO_CRC_BIT;
+            data[4]         = job->block_size;
+            data[5]         = SDO_SWITCH_THRESHOLD;
+            break;
+        default:
+            job->abort_code = ABORT_GENERAL_ERROR;
+            finish_job(job, ABORT_TRANSFER);
+            return;
+    }
+
+    send_frame(job, data);
+}
+
+static void start_next_jobs(sdo_node_t* node)
+{
+    /* A transfer that fails to start finishes straight away, keep going
+     * here instead of recursing through finish_job().
+     */
+    if (IS_TRUE == is_starting)
+    {
+        return;
+    }
+
+    is_starting = IS_TRUE;
+    while ((NULL == node->active) && (NULL != node->head))
+    {
+        node->active = node->head;
+        node->head   = node->head->next;
+        if (NULL == node->head)
+        {
+            node->tail = NULL;
+        }
+
+        node->active->next = NULL;
+        start_job(node->active);
+    }
+    is_starting = IS_FALSE;
+}
+
+static void finish_job(sdo_job_t* job, sdo_state_t sdo_state)
+{
+    sdo_node_t* node = &nodes[job->request.node_id];
+
+    job->sdo_state  = sdo_state;
+    job->elapsed_ms = (uint32)(os_get_ticks() - job->started_at);
+    job->next       = NULL;
+
+    if ((ABORT_TRANSFER == sdo_state) && (IS_TRUE == job->is_allocated))
+    {
+        os_free(job->request.data);
+        job->request.data   = NULL;
+        job->request.length = 0;
+    }
+
+    if (NULL == done_tail)
+    {
+        done_head = job;
+    }
+    else
+    {
+        done_tail->next = job;
+    }
+    done_tail = job;
+
+    num_pending -= 1;
+    if (0 == num_pending)
+    {
+        dispatch_pause(client_sub, IS_TRUE);
+    }
+
+    node->active = NULL;
+    start_next_jobs(node);
+}
+
+static void take_completion(sdo_job_t* job, sdo_job_t* prev, sdo_completion_t* completion)
+{
+    if (NULL == prev)
+    {
+        done_head = job->next;
+    }
+    else
+    {
+        prev->next = job->next;
+    }
+
+    if (done_tail == job)
+    {
+        done_tail = prev;
+    }
+
+    completion->handle     = job->handle;
+    completion->request    = job->request;
+    completion->sdo_state  = job->sdo_state;
+    completion->abort_code = job->abort_code;
+    completion->can_status = job->can_status;
+    completion->length     = job->offset;
+    completion->elapsed_ms = job->elapsed_ms;
+
+    os_free(job);
+}
+
+static void free_job(sdo_job_t* job)
+{
+    if (NULL == job)
+    {
+        return;
+    }
+
+    if (IS_TRUE == job->is_allocated)
+    {
+        os_free(job->request.data);
+    }
+
+    os_free(job);
+}
+
+static void abort_job(sdo_job_t* job, uint32 abort_code)
+{
+    uint8 data[8] = { 0 };
+
+    data[0] = CCS_ABORT;
+    set_multiplexer(job, data);
+    put_u32(&data[4], abort_code);
+
+    /* Tell the server, but the transfer is over either way. */
+    if (0 == job->can_status)
+    {
+        send_frame(job, data);
+    }
+
+    if (0 == job->abort_code)
+    {
+        job->abort_code = abort_code;
+    }
+
+    finish_job(job, ABORT_TRANSFER);
+}
+
+static void handle_timeout(sdo_job_t* job)
+{
+    sdo_node_t* node = &nodes[job->request.node_id];
+
+    /* Repeating a request is only safe as long as the transfer hasn't
+     * started, an initiate request simply restarts it on the server.
+     */
+    if ((job->retries > 0) && (IS_TRUE == is_init_phase(job)))
+    {
+        job->retries         -= 1;
+        job->rto              = back_off(job->rto);
+        job->is_retransmitted = IS_TRUE;
+
+        if (IS_TRUE == send_frame(job, job->request_frame))
+        {
+            /* Karn: the answer can't be told apart from one to the
+             * first attempt, so it makes no sample.
+             */
+            job->is_timing = IS_FALSE;
+        }
+        return;
+    }
+
+    /* The rest of a block was lost, most likely its last segment.  Ack
+     * what did arrive and the server resends from there.
+     */
+    if ((SDO_PHASE_BLOCK_UPLOAD_DATA == job->phase) && (job->retries > 0))
+    {
+        job->retries -= 1;
+        job->rto      = back_off(job->rto);
+        send_block_ack(job, IS_FALSE);
+        return;
+    }
+
+    /* Back off until the node answers again.  Nodes that never did are
+     * left to the bus estimate, so empty IDs stay cheap to scan.
+     */
+    if (IS_TRUE == node->rtt.is_measured)
+    {
+        node->rtt.rto = back_off(node->rtt.rto);
+    }
+
+    abort_job(job, ABORT_SDO_PROTOCOL_TIMED_OUT);
+}
+
+static void handle_frame(sdo_job_t* job, const can_message_t* msg_in)
+{
+    /* A repeated initiate request may be answered twice. */
+    if ((IS_TRUE == job->is_retransmitted) && (IS_FALSE == is_init_phase(job)) &&
+        (0 == os_memcmp(job->init_answer, msg_in->data, 8)))
+    {
+        return;
+    }
+
+    if ((IS_TRUE == job->is_timing) && ((IS_FALSE == is_init_phase(job)) || (IS_TRUE == is_same_object(job, msg_in))))
+    {
+        uint32 sample_ms = (uint32)(os_get_ticks() - job->sent_at);
+
+        job->is_timing = IS_FALSE;
+        update_rtt(&nodes[job->request.node_id].rtt, sample_ms);
+        update_rtt(&bus_rtt, sample_ms);
+    }
+
+    if (IS_TRUE == is_init_phase(job))
+    {
+        os_memcpy(job->init_answer, msg_in->data, 8);
+    }
+
+    if (SCS_ABORT == msg_in->data[0])
+    {
+        if (IS_FALSE == is_same_object(job, msg_in))
+        {
+            return;
+        }
+
+        /* Servers without block transfer support refuse the command, so
+         * retry the same object with a regular upload.
+         */
+        if ((SDO_PHASE_BLOCK_UPLOAD_INIT == job->phase) && (ABORT_CMD_SPECIFIER_INVALID_UNKNOWN == get_u32(&msg_in->data[4])))
+        {
+            uint8 data[8] = { 0 };
+
+            job->phase     = SDO_PHASE_UPLOAD_INIT;
+            job->sdo_state = IS_READ_EXPEDITED;
+            data[0]        = CCS_UPLOAD_INIT;
+            set_multiplexer(job, data);
+            send_frame(job, data);
+            return;
+        }
+
+        job->abort_code = get_u32(&msg_in->data[4]);
+        finish_job(job, ABORT_TRANSFER);
+        return;
+    }
+
+    switch (job->phase)
+    {
+        case SDO_PHASE_UPLOAD_INIT:
+        case SDO_PHASE_UPLOAD_SEGMENT:
+            handle_upload(job, msg_in);
+            break;
+        case SDO_PHASE_DOWNLOAD_INIT:
+        case SDO_PHASE_DOWNLOAD_SEGMENT:
+            handle_download(job, msg_in);
+            break;
+        case SDO_PHASE_BLOCK_DOWNLOAD_INIT:
+        case SDO_PHASE_BLOCK_DOWNLOAD_ACK:
+        case SDO_PHASE_BLOCK_DOWNLOAD_END:
+            handle_block_download(job, msg_in);
+            break;
+        case SDO_PHASE_BLOCK_UPLOAD_INIT:
+        case SDO_PHASE_BLOCK_UPLOAD_DATA:
+        case SDO_PHASE_BLOCK_UPLOAD_END:
+            handle_block_upload(job, msg_in);
+            break;
+    }
+}
+
+static void handle_upload(sdo_job_t* job, const can_message_t* msg_in)
+{
+    uint8  cmd     = msg_in->data[0];
+    uint8  data[8] = { 0 };
+    uint32 length;
+    uint32 abort_code;
+
+    if (SDO_PHASE_UPLOAD_INIT == job->phase)
+    {
+        /* Late answers to an earlier request don't belong to this one. */
+        if (((cmd & 0xe0) != SCS_UPLOAD_INIT) || (IS_FALSE == is_same_object(job, msg_in)))
+        {
+            return;
+        }
+
+        if (cmd & SDO_EXPEDITED_BIT)
+        {
+            length     = (cmd & SDO_SIZE_BIT) ? (4 - ((cmd >> 2) & 0x03)) : 4;
+            abort_code = store_data(job, &msg_in->data[4], length);
+            if (0 != abort_code)
+            {
+                abort_job(job, abort_code);
+                return;
+            }
+
+            finish_job(job, IS_READ_EXPEDITED);
+            return;
+        }
+
+        job->size  = (cmd & SDO_SIZE_BIT) ? get_u32(&msg_in->data[4]) : 0;
+        abort_code = reserve_data(job, job->size);
+        if (0 != abort_code)
+        {
+            abort_job(job, abort_code);
+            return;
+        }
+
+        job->phase     = SDO_PHASE_UPLOAD_SEGMENT;
+        job->sdo_state = IS_READ_SEGMENTED;
+        job->toggle    = 0;
+
+        data[0] = CCS_UPLOAD_SEGMENT;
+        send_frame(job, data);
+        return;
+    }
+
+    if ((cmd & 0xe0) != SCS_UPLOAD_SEGMENT)
+    {
+        abort_job(job, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+        return;
+    }
+
+    if ((cmd & SDO_TOGGLE_BIT) != job->toggle)
+    {
+        abort_job(job, ABORT_TOGGLE_BIT_NOT_ALTERED);
+        return;
+    }
+
+    length     = SDO_SEGMENT_SIZE - ((cmd >> 1) & 0x07);
+    abort_code = store_data(job, &msg_in->data[1], length);
+    if (0 != abort_code)
+    {
+        abort_job(job, abort_code);
+        return;
+    }
+
+    if (cmd & SDO_LAST_SEGMENT_BIT)
+    {
+        finish_job(job, IS_READ_SEGMENTED);
+        return;
+    }
+
+    job->toggle ^= SDO_TOGGLE_BIT;
+
+    data[0] = CCS_UPLOAD_SEGMENT | job->toggle;
+    send_frame(job, data);
+}
+
+static void handle_download(sdo_job_t* job, const can_message_t* msg_in)
+{
+    uint8 cmd = msg_in->data[0];
+
+    if (SDO_PHASE_DOWNLOAD_INIT == job->phase)
+    {
+        if ((SCS_DOWNLOAD_INIT != cmd) || (IS_FALSE == is_same_object(job, msg_in)))
+        {
+            return;
+        }
+
+        if (IS_WRITE_EXPEDITED == job->sdo_state)
+        {
+            job->offset = job->request.length;
+            finish_job(job, IS_WRITE_EXPEDITED);
+            return;
+        }
+
+        job->phase  = SDO_PHASE_DOWNLOAD_SEGMENT;
+        job->toggle = 0;
+        send_download_segment(job);
+        return;
+    }
+
+    if ((cmd & 0xe0) != SCS_DOWNLOAD_SEGMENT)
+    {
+        abort_job(job, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+        return;
+    }
+
+    if ((cmd & SDO_TOGGLE_BIT) != job->toggle)
+    {
+        abort_job(job, ABORT_TOGGLE_BIT_NOT_ALTERED);
+        return;
+    }
+
+    job->offset += job->segment_length;
+
+    if (job->offset >= job->request.length)
+    {
+        finish_job(job, IS_WRITE_SEGMENTED);
+        return;
+    }
+
+    job->toggle ^= SDO_TOGGLE_BIT;
+    send_download_segment(job);
+}
+
+static void handle_block_download(sdo_job_t* job, const can_message_t* msg_in)
+{
+    uint8 cmd     = msg_in->data[0];
+    uint8 data[8] = { 0 };
+
+    switch (job->phase)
+    {
+        case SDO_PHASE_BLOCK_DOWNLOAD_INIT:
+            if (((cmd & 0xe3) != SCS_BLOCK_DOWNLOAD) || (IS_FALSE == is_same_object(job, msg_in)))
+            {
+                return;
+            }
+
+            job->is_crc     = (cmd & SDO_CRC_BIT) ? IS_TRUE : IS_FALSE;
+            job->block_size = msg_in->data[4];
+            if ((0 == job->block_size) || (job->block_size > SDO_MAX_BLOCK_SIZE))
+            {
+                abort_job(job, ABORT_INVALID_BLOCK_SIZE);
+                return;
+            }
+
+            send_sub_block(job);
+            break;
+        case SDO_PHASE_BLOCK_DOWNLOAD_ACK:
+        {
+            uint8  ackseq = msg_in->data[1];
+            uint32 length = (uint32)ackseq * SDO_SEGMENT_SIZE;
+
+            if ((cmd & 0xe3) != (SCS_BLOCK_DOWNLOAD | SDO_BLOCK_ACK))
+            {
+                abort_job(job, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+                return;
+            }
+
+            if (ackseq > job->seqno)
+            {
+                abort_job(job, ABORT_INVALID_SEQUENCE_NUMBER);
+                return;
+            }
+
+            /* Everything after ackseq was lost and goes out again with the
+             * next block.
+             */
+            if (length > job->segment_length)
+            {
+                length = job->segment_length;
+            }
+            job->offset = job->block_start + length;
+
+            if ((job->offset >= job->request.length) && (ackseq == job->seqno))
+            {
+                uint32 last_length = job->request.length % SDO_SEGMENT_SIZE;
+
+                if ((0 == last_length) && (job->request.length > 0))
+                {
+                    last_length = SDO_SEGMENT_SIZE;
+                }
+
+                job->phase = SDO_PHASE_BLOCK_DOWNLOAD_END;
+                data[0]    = CCS_BLOCK_DOWNLOAD | ((SDO_SEGMENT_SIZE - last_length) << 2) | SDO_BLOCK_END;
+
+                if (IS_TRUE == job->is_crc)
+                {
+                    data[1] = (uint8)(job->crc & 0xff);
+                    data[2] = (uint8)(job->crc >> 8);
+                }
+
+                send_frame(job, data);
+                return;
+            }
+
+            job->block_size = msg_in->data[2];
+            if ((0 == job->block_size) || (job->block_size > SDO_MAX_BLOCK_SIZE))
+            {
+                abort_job(job, ABORT_INVALID_BLOCK_SIZE);
+                return;
+            }
+
+            send_sub_block(job);
+            break;
+        }
+        case SDO_PHASE_BLOCK_DOWNLOAD_END:
+            if ((cmd & 0xe3) != (SCS_BLOCK_DOWNLOAD | SDO_BLOCK_END))
+            {
+                abort_job(job, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+                return;
+            }
+
+            finish_job(job, IS_WRITE_BLOCK);
+            break;
+        default:
+            break;
+    }
+}
+
+static void handle_block_upload(sdo_job_t* job, const can_message_t* msg_in)
+{
+    uint8  cmd     = msg_in->data[0];
+    uint8  data[8] = { 0 };
+    uint32 abort_code;
+
+    switch (job->phase)
+    {
+        case SDO_PHASE_BLOCK_UPLOAD_INIT:
+            if (IS_FALSE == is_same_object(job, msg_in))
+            {
+                return;
+            }
+
+            /* Below the switch threshold the server may answer with a
+             * regular upload instead.
+             */
+            if ((cmd & 0xe0) == SCS_UPLOAD_INIT)
+            {
+                job->phase = SDO_PHASE_UPLOAD_INIT;
+                handle_upload(job, msg_in);
+                return;
+            }
+
+            if ((cmd & 0xe1) != SCS_BLOCK_UPLOAD)
+            {
+                return;
+            }
+
+            job->is_crc = (cmd & SDO_CRC_BIT) ? IS_TRUE : IS_FALSE;
+            job->size   = (cmd & SDO_BLOCK_SIZE_BIT) ? get_u32(&msg_in->data[4]) : 0;
+            abort_code  = reserve_data(job, job->size);
+            if (0 != abort_code)
+            {
+                abort_job(job, abort_code);
+                return;
+            }
+
+            job->phase   = SDO_PHASE_BLOCK_UPLOAD_DATA;
+            job->seqno   = 0;
+            job->retries = SDO_BLOCK_RETRIES;
+
+            data[0] = CCS_BLOCK_UPLOAD | SDO_BLOCK_START;
+            send_frame(job, data);
+            break;
+        case SDO_PHASE_BLOCK_UPLOAD_DATA:
+            receive_segment(job, msg_in);
+            break;
+        case SDO_PHASE_BLOCK_UPLOAD_END:
+        {
+            uint32 length;
+
+            if ((cmd & 0xe3) != (SCS_BLOCK_UPLOAD | SDO_BLOCK_END))
+            {
+                abort_job(job, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+                return;
+            }
+
+            /* Only now is it known how much of the last segment is data. */
+            length = SDO_SEGMENT_SIZE - ((cmd >> 2) & 0x07);
+            if (IS_TRUE == job->has_segment)
+            {
+                abort_code = store_data(job, job->segment, length);
+                if (0 != abort_code)
+                {
+                    abort_job(job, abort_code);
+                    return;
+                }
+            }
+
+            if ((IS_TRUE == job->is_crc) && (job->crc != get_u16(&msg_in->data[1])))
+            {
+                abort_job(job, ABORT_CRC_ERROR);
+                return;
+            }
+
+            if ((0 != job->size) && (job->offset != job->size))
+            {
+                abort_job(job, ABORT_DATA_TYPE_DOES_NOT_MATCH);
+                return;
+            }
+
+            data[0] = CCS_BLOCK_UPLOAD | SDO_BLOCK_END;
+            if (IS_TRUE == send_frame(job, data))
+            {
+                finish_job(job, IS_READ_BLOCK);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void receive_segment(sdo_job_t* job, const can_message_t* msg_in)
+{
+    uint8 cmd   = msg_in->data[0];
+    uint8 seqno = cmd & 0x7f;
+
+    if ((seqno == (job->seqno + 1)) && (IS_FALSE == job->is_last_block))
+    {
+        /* The previous segment is complete data, this one may be padded. */
+        if (IS_TRUE == job->has_segment)
+        {
+            uint32 abort_code = store_data(job, job->segment, SDO_SEGMENT_SIZE);
+
+            if (0 != abort_code)
+            {
+                abort_job(job, abort_code);
+                return;
+            }
+        }
+
+        os_memcpy(job->segment, &msg_in->data[1], SDO_SEGMENT_SIZE);
+        job->has_segment = IS_TRUE;
+        job->seqno       = seqno;
+        job->retries     = SDO_BLOCK_RETRIES;
+
+        if (cmd & SDO_LAST_BLOCK_BIT)
+        {
+            job->is_last_block = IS_TRUE;
+        }
+    }
+
+    /* A block takes as long as the bit rate needs, so the timeout only
+     * covers the gap to the next segment.  Segments out of sequence count
+     * too, the server is still busy with the block.
+     */
+    job->deadline = os_get_ticks() + job->rto;
+
+    /* Acknowledge once the block is over, either by count or because the
+     * server flagged its last segment.  The server resumes after ackseq.
+     */
+    if ((seqno < job->block_size) && (0 == (cmd & SDO_LAST_BLOCK_BIT)))
+    {
+        return;
+    }
+
+    send_block_ack(job, (job->seqno < seqno) ? IS_FALSE : IS_TRUE);
+}
+
+static void send_block_ack(sdo_job_t* job, bool_t is_complete)
+{
+    uint8 data[8] = { 0 };
+
+    /* Segments went missing, so ask for smaller blocks until it settles. */
+    if (IS_FALSE == is_complete)
+    {
+        job->block_size = (job->block_size > 1) ? (job->block_size / 2) : 1;
+    }
+    else if (job->block_size < SDO_MAX_BLOCK_SIZE)
+    {
+        job->block_size = ((job->block_size * 2) > SDO_MAX_BLOCK_SIZE) ? SDO_MAX_BLOCK_SIZE : (job->block_size * 2);
+    }
+
+    data[0] = CCS_BLOCK_UPLOAD | SDO_BLOCK_ACK;
+    data[1] = job->seqno;
+    data[2] = job->block_size;
+
+    if (IS_FALSE == send_frame(job, data))
+    {
+        return;
+    }
+
+    if (IS_TRUE == job->is_last_block)
+    {
+        job->phase = SDO_PHASE_BLOCK_UPLOAD_END;
+    }
+
+    job->seqno = 0;
+}
+
+static uint32 store_data(sdo_job_t* job, const uint8* data, uint32 length)
+{
+    job->crc = crc16(job->crc, data, length);
+
+    if (NULL != job->request.file)
+    {
+        if (os_fwrite(data, 1, length, job->request.file) != length)
+        {
+            return ABORT_DATA_CANNOT_BE_TRANSFERRED;
+        }
+    }
+    else
+    {
+        uint32 abort_code = reserve_data(job, job->offset + length);
+
+        if (0 != abort_code)
+        {
+            return abort_code;
+        }
+
+        os_memcpy(&job->request.data[job->offset], data, length);
+
+        /* Allocated buffers stay terminated so they can be used as strings. */
+        if (IS_TRUE == job->is_allocated)
+        {
+            job->request.data[job->offset + length] = '\0';
+        }
+    }
+
+    job->offset += length;
+    return 0;
+}
+
+static uint32 reserve_data(sdo_job_t* job, uint32 size)
+{
+    uint8* data;
+    uint32 capacity = job->request.length;
+
+    if ((NULL != job->request.file) || (size <= capacity))
+    {
+        return 0;
+    }
+
+    if ((IS_FALSE == job->is_allocated) || (0xffffffff == size))
+    {
+        return ABORT_OUT_OF_MEMORY;
+    }
+
+    /* An indicated size is allocated exactly, otherwise grow by doubling. */
+    if (0 == capacity)
+    {
+        capacity = size;
+    }
+
+    while (capacity < size)
+    {
+        capacity = (capacity > 0x7fffffff) ? size : (capacity * 2);
+    }
+
+    data = (uint8*)os_realloc(job->request.data, (size_t)capacity + 1);
+    if (NULL == data)
+    {
+        return ABORT_OUT_OF_MEMORY;
+    }
+
+    job->request.data   = data;
+    job->request.length = capacity;
+    return 0;
+}
+
+static uint32 load_data(sdo_job_t* job, uint32 offset, uint8* data, uint32 length)
+{
+    if (NULL == job->request.file)
+    {
+        os_memcpy(data, &job->request.data[offset], length);
+        return 0;
+    }
+
+    /* Segments are read as they go out, so only a retransmission ever
+     * has to seek.
+     */
+    if (offset != job->file_position)
+    {
+        if (0 != os_fseek(job->request.file, (long)offset, SEEK_SET))
+        {
+            return ABORT_DATA_CANNOT_BE_TRANSFERRED;
+        }
+        job->file_position = offset;
+    }
+
+    if (os_fread(data, 1, length, job->request.file) != length)
+    {
+        return ABORT_DATA_CANNOT_BE_TRANSFERRED;
+    }
+
+    job->file_position += length;
+    return 0;
+}
+
+static void send_download_segment(sdo_job_t* job)
+{
+    uint8  data[8]   = { 0 };
+    uint32 remaining = job->request.length - job->offset;
+    uint32 length    = (remaining > SDO_SEGMENT_SIZE) ? SDO_SEGMENT_SIZE : remaining;
+    uint32 abort_code;
+
+    abort_code = load_data(job, job->offset, &data[1], length);
+    if (0 != abort_code)
+    {
+        abort_job(job, abort_code);
+        return;
+    }
+
+    data[0] = CCS_DOWNLOAD_SEGMENT | job->toggle | ((SDO_SEGMENT_SIZE - length) << 1);
+    if (length == remaining)
+    {
+        data[0] |= SDO_LAST_SEGMENT_BIT;
+    }
+
+    job->segment_length = length;
+    send_frame(job, data);
+}
+
+static void send_sub_block(sdo_job_t* job)
+{
+    can_message_t frames[SDO_MAX_BLOCK_SIZE];
+    uint32        offset      = job->offset;
+    uint32        num_frames  = 0;
+    uint32        num_written = 0;
+
+    job->phase          = SDO_PHASE_BLOCK_DOWNLOAD_ACK;
+    job->block_start    = job->offset;
+    job->segment_length = 0;
+    job->seqno          = 0;
+
+    while (job->seqno < job->block_size)
+    {
+        can_message_t* frame     = &frames[num_frames];
+        uint32         remaining = job->request.length - offset;
+        uint32         length    = (remaining > SDO_SEGMENT_SIZE) ? SDO_SEGMENT_SIZE : remaining;
+        uint32         abort_code;
+
+        os_memset(frame, 0, sizeof(can_message_t));
+
+        abort_code = load_data(job, offset, &frame->data[1], length);
+        if (0 != abort_code)
+        {
+            abort_job(job, abort_code);
+            return;
+        }
+
+        /* Retransmitted segments are already part of the CRC. */
+        if (offset == job->crc_length)
+        {
+            job->crc         = crc16(job->crc, &frame->data[1], length);
+            job->crc_length += length;
+        }
+
+        job->seqno    += 1;
+        frame->id      = SDO_TX_BASE_ID + job->request.node_id;
+        frame->length  = 8;
+        frame->data[0] = job->seqno;
+
+        if (length == remaining)
+        {
+            frame->data[0] |= SDO_LAST_BLOCK_BIT;
+        }
+
+        num_frames          += 1;
+        offset              += length;
+        job->segment_length += length;
+
+        if (length == remaining)
+        {
+            break;
+        }
+    }
+
+    /* The whole block goes out as one batch and the server only answers
+     * once it's through, so allow for every frame at the slowest bit rate.
+     */
+    job->can_status = can_write_batch(frames, num_frames, &num_written);
+    job->deadline   = os_get_ticks() + job->rto + (num_frames * SDO_FRAME_TIME_MS);
+    job->is_timing  = IS_FALSE;
+
+    if (0 != job->can_status)
+    {
+        if (0 == job->abort_code)
+        {
+            job->abort_code = ABORT_GENERAL_ERROR;
+        }
+        finish_job(job, ABORT_TRANSFER);
+    }
+}
+
+static bool_t send_frame(sdo_job_t* job, const uint8 data[8])
+{
+    can_message_t msg_out = { 0 };
+
+    msg_out.id     = SDO_TX_BASE_ID + job->request.node_id;
+    msg_out.length = 8;
+    os_memcpy(msg_out.data, data, 8);
+
+    job->sent_at   = os_get_ticks();
+    job->deadline  = job->sent_at + job->rto;
+    job->is_timing = IS_TRUE;
+
+    /* Kept in case the request has to be repeated. */
+    if ((CCS_ABORT != data[0]) && (data != job->request_frame))
+    {
+        os_memcpy(job->request_frame, data, 8);
+    }
+
+    job->can_status = can_write(&msg_out, SILENT, NULL);
+    if (0 != job->can_status)
+    {
+        if (0 == job->abort_code)
+        {
+            job->abort_code = ABORT_GENERAL_ERROR;
+        }
+
+        /* Nothing was sent, so there's no server side to abort. */
+        if (CCS_ABORT != data[0])
+        {
+            finish_job(job, ABORT_TRANSFER);
+        }
+        return IS_FALSE;
+    }
+
+    return IS_TRUE;
+}
+
+static bool_t is_same_object(const sdo_job_t* job, const can_message_t* msg_in)
+{
+    return ((msg_in->data[1] == (uint8)(job->request.index & 0x00ff)) &&
+            (msg_in->data[2] == (uint8)((job->request.index & 0xff00) >> 8)) &&
+            (msg_in->data[3] == job->request.sub_index)) ? IS_TRUE : IS_FALSE;
+}
+
+static bool_t is_init_phase(const sdo_job_t* job)
+{
+    switch (job->phase)
+    {
+        case SDO_PHASE_UPLOAD_INIT:
+        case SDO_PHASE_DOWNLOAD_INIT:
+        case SDO_PHASE_BLOCK_DOWNLOAD_INIT:
+        case SDO_PHASE_BLOCK_UPLOAD_INIT:
+            return IS_TRUE;
+        default:
+            return IS_FALSE;
+    }
+}
+
+static uint32 get_initial_rto(const sdo_node_t* node)
+{
+    /* Until a node has answered, wait at least the configured timeout,
+     * or longer if the rest of the bus is slower than that.
+     */
+    if (IS_TRUE == node->rtt.is_measured)
+    {
+        return node->rtt.rto;
+    }
+    else if ((IS_TRUE == bus_rtt.is_measured) && (bus_rtt.rto > sdo_get_timeout()))
+    {
+        return bus_rtt.rto;
+    }
+
+    return sdo_get_timeout();
+}
+
+static void update_rtt(sdo_rtt_t* rtt, uint32 sample_ms)
+{
+    long   delta;
+    uint32 rto;
+
+    if (IS_FALSE == rtt->is_measured)
+    {
+        rtt->srtt        = sample_ms << 3;
+        rtt->rttvar      = sample_ms << 1;
+        rtt->is_measured = IS_TRUE;
+    }
+    else
+    {
+        /* srtt += (sample - srtt) / 8, rttvar += (|sample - srtt| - rttvar) / 4 */
+        delta        = (long)sample_ms - (long)(rtt->srtt >> 3);
+        rtt->srtt    = (uint32)((long)rtt->srtt + delta);
+        delta        = (delta < 0) ? -delta : delta;
+        delta       -= (long)(rtt->rttvar >> 2);
+        rtt->rttvar  = (uint32)((long)rtt->rttvar + delta);
+    }
+
+    rto = (rtt->srtt >> 3) + ((rtt->rttvar > 0) ? rtt->rttvar : 1);
+    if (rto < SDO_RTO_MIN_MS)
+    {
+        rto = SDO_RTO_MIN_MS;
+    }
+    else if (rto > get_max_rto())
+    {
+        rto = get_max_rto();
+    }
+
+    rtt->rto = rto;
+}
+
+static uint32 back_off(uint32 rto)
+{
+    return ((rto * 2) > get_max_rto()) ? get_max_rto() : (rto * 2);
+}
+
+static uint32 get_max_rto(void)
+{
+    /* Never cap below what the user asked to wait for. */
+    return (sdo_get_timeout() > SDO_RTO_MAX_MS) ? sdo_get_timeout() : SDO_RTO_MAX_MS;
+}
+
+static void set_multiplexer(const sdo_job_t* job, uint8 data[8])
+{
+    data[1] = (uint8)(job->request.index & 0x00ff);
+    data[2] = (uint8)((job->request.index & 0xff00) >> 8);
+    data[3] = job->request.sub_index;
+}
+
+static uint16 crc16(uint16 crc, const uint8* data, uint32 length)
+{
+    uint32 index;
+
+    for (index = 0; index < length; index += 1)
+    {
+        crc = (uint16)((crc << 8) ^ crc_table[((crc >> 8) ^ data[index]) & 0xff]);
+    }
+
+    return crc;
+}
+
+static uint16 get_u16(const uint8* data)
+{
+    return (uint16)((uint16)data[0] | ((uint16)data[1] << 8));
+}
+
+static uint32 get_u32(const uint8* data)
+{
+    return (uint32)data[0] | ((uint32)data[1] << 8) | ((uint32)data[2] << 16) | ((uint32)data[3] << 24);
+}
+
+static void put_u32(uint8* data, uint32 value)
+{
+    data[0] = (uint8)(value & 0xff);
+    data[1] = (uint8)((value >> 8) & 0xff);
+    data[2] = (uint8)((value >> 16) & 0xff);
+    data[3] = (uint8)((value >> 24) & 0xff);
+}
@@ -0,0 +1,68 @@
+/** @file sdo_client.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef SDO_CLIENT_H
+#define SDO_CLIENT_H
+
+#include "can.h"
+#include "core.h"
+#include "os.h"
+#include "sdo.h"
+
+#define SDO_CLIENT_MAX_NODES 128
+#define SDO_CLIENT_RING_SIZE 1024
+
+typedef enum sdo_request_type
+{
+    SDO_REQUEST_READ = 0,
+    SDO_REQUEST_READ_BLOCK,
+    SDO_REQUEST_WRITE,
+    SDO_REQUEST_WRITE_BLOCK
+
+} sdo_request_type_t;
+
+/* A read with neither data nor file gets a buffer allocated by the
+ * client.  It's handed over as completion.request.data, terminated but
+ * not counted in completion.length, and must be released with os_free().
+ */
+typedef struct sdo_request
+{
+    sdo_request_type_t type;
+    uint8              node_id;
+    uint16             index;
+    uint8              sub_index;
+    uint8*             data;      /* Source for writes, destination for reads. */
+    uint32             length;    /* Bytes to write, or size of the read buffer. */
+    FILE_t*            file;      /* Streamed from or to instead of data, if set. */
+    void*              user_data;
+
+} sdo_request_t;
+
+typedef struct sdo_completion
+{
+    uint32        handle;
+    sdo_request_t request;
+    sdo_state_t   sdo_state;
+    uint32        abort_code;
+    uint32        can_status;
+    uint32        length;
+    uint32        elapsed_ms; /* From the first request frame to completion. */
+
+} sdo_completion_t;
+
+uint32   sdo_client_submit(const sdo_request_t* request);
+status_t sdo_client_process(uint32 timeout_ms);
+bool_t   sdo_client_get_completion(sdo_completion_t* completion);
+status_t sdo_client_wait(uint32 handle, sdo_completion_t* completion);
+uint32   sdo_client_get_pending(void);
+uint32   sdo_client_get_rto(uint8 node_id);
+void     sdo_client_reset_rtt(void);
+void     sdo_client_deinit(void);
+
+#endif /* SDO_CLIENT_H */
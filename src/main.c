@@ -13,19 +13,25 @@
 #include "eds.h"
 #include "os.h"
 #include "scripts.h"
+#include "sdo.h"
 
 core_t* core = NULL;
 
 int main(int argc, char* argv[])
 {
-    bool_t   is_plain_mode   = IS_FALSE;
-    char*    can_interface   = DEFAULT_CAN_INTERFACE;
-    char*    eds_file        = NULL;
-    char*    script          = NULL;
-    int      i;
-    int      status          = EXIT_SUCCESS;
-    uint32   node_id         = 0x01;
-    uint8    baud_rate_index = 0;
+    bool_t          is_plain_mode   = IS_FALSE;
+    char*           can_interface   = DEFAULT_CAN_INTERFACE;
+    char*           eds_file        = NULL;
+    char*           script          = NULL;
+    int             i;
+    int             status          = EXIT_SUCCESS;
+    uint8           node_ids[127]   = { 0x01 };
+    uint32          num_node_ids    = 1;
+    uint32          tx_gap_us       = 0;
+    uint32          sdo_timeout_ms  = 0;
+    uint32          sdo_retries     = 1;
+    uint8           baud_rate_index = 0;
+    can_tx_pacing_t tx_pacing       = CAN_TX_PACING_BACKOFF;
 
     core_register_ctrl_c_handler();
 
@@ -58,15 +64,69 @@ int main(int argc, char* argv[])
         }
         else if (0 == os_strcmp(argv[i], "-n") && (i + 1) < argc)
         {
-            char* endptr;
+            char* endptr = argv[++i];
+
+            /* A comma-separated list tests several nodes at once. */
+            num_node_ids = 0;
+            while (1)
+            {
+                long node_id = os_strtol(endptr, &endptr, 0);
+
+                if (node_id < 1 || node_id > 127 || num_node_ids >= 127)
+                {
+                    os_printf("Invalid node ID.  Must be between 0x01 and 0x7F.\n");
+                    exit(EXIT_FAILURE);
+                }
+                node_ids[num_node_ids++] = (uint8)node_id;
 
-            node_id = os_strtol(argv[++i], &endptr, 0);
-            if (node_id < 1 || node_id > 127 || *endptr != '\0')
+                if (',' != *endptr)
+                {
+                    break;
+                }
+                endptr += 1;
+            }
+
+            if (*endptr != '\0')
             {
                 os_printf("Invalid node ID.  Must be between 0x01 and 0x7F.\n");
                 exit(EXIT_FAILURE);
             }
         }
+        else if (0 == os_strcmp(argv[i], "-g") && (i + 1) < argc)
+        {
+            char* endptr;
+
+            tx_gap_us = os_strtoul(argv[++i], &endptr, 0);
+            if (*endptr != '\0')
+            {
+                os_printf("Invalid TX gap.  Must be a number of microseconds.\n");
+                exit(EXIT_FAILURE);
+            }
+
+            tx_pacing = (0 == tx_gap_us) ? CAN_TX_PACING_NONE : CAN_TX_PACING_FIXED_GAP;
+        }
+        else if (0 == os_strcmp(argv[i], "-T") && (i + 1) < argc)
+        {
+            char* endptr;
+
+            sdo_timeout_ms = os_strtoul(argv[++i], &endptr, 0);
+            if (0 == sdo_timeout_ms || *endptr != '\0')
+            {
+                os_printf("Invalid SDO timeout.  Must be a positive number of milliseconds.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (0 == os_strcmp(argv[i], "-R") && (i + 1) < argc)
+        {
+            char* endptr;
+
+            sdo_retries = os_strtoul(argv[++i], &endptr, 0);
+            if (*endptr != '\0')
+            {
+                os_printf("Invalid SDO retries.  Must be a number.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
         else if (0 == os_strcmp(argv[i], "-p"))
         {
             is_plain_mode = IS_TRUE;
@@ -83,6 +143,11 @@ int main(int argc, char* argv[])
             os_printf("                        3 = 250 kBit/s\n");
             os_printf("                        4 = 125 kBit/s\n");
             os_printf("    -n NODE_ID        Set node ID, default: 0x01\n");
+            os_printf("                      a comma-separated list is tested in parallel\n");
+            os_printf("    -g GAP_US         Set fixed TX inter-frame gap in microseconds,\n");
+            os_printf("                      0 = no pacing, default: back-off on full TX queue\n");
+            os_printf("    -T TIMEOUT_MS     Set initial SDO response timeout, default: 100 ms\n");
+            os_printf("    -R RETRIES        Set SDO request retries, default: 1\n");
             os_printf("    -p                Run in plain mode\n");
             exit(EXIT_FAILURE);
         }
@@ -94,6 +159,10 @@ int main(int argc, char* argv[])
     }
 
     os_strlcpy(core->can_interface, can_interface, sizeof(core->can_interface));
+    can_set_tx_pacing(tx_pacing, tx_gap_us);
+    sdo_set_timeout(sdo_timeout_ms);
+    sdo_set_retries(sdo_retries);
+
     if (baud_rate_index != 0)
     {
         while (IS_FALSE == is_can_initialised(core)) {}
@@ -107,7 +176,7 @@ int main(int argc, char* argv[])
     }
     else if (eds_file != NULL)
     {
-        run_conformance_test(eds_file, node_id);
+        run_conformance_test(eds_file, node_ids, num_node_ids);
         core->is_running = IS_FALSE;
     }
 
@@ -129,6 +129,10 @@ size_t os_strlcpy(char* dst, const char* src, size_t dstsize);
 #error  os_ftell() not defined
 #endif
 
+#ifndef os_fwrite
+#error  os_fwrite() not defined
+#endif
+
 #ifndef os_isdigit
 #error  os_isdigit() not defined
 #endif
@@ -149,6 +153,10 @@ size_t os_strlcpy(char* dst, const char* src, size_t dstsize);
 #error  os_itoa() not defined
 #endif
 
+#ifndef os_memcmp
+#error  os_memcmp() not defined
+#endif
+
 #ifndef os_memcpy
 #error  os_memcpy() not defined
 #endif
@@ -169,6 +177,10 @@ size_t os_strlcpy(char* dst, const char* src, size_t dstsize);
 #error  os_printf() not defined
 #endif
 
+#ifndef os_qsort
+#error  os_qsort() not defined
+#endif
+
 #ifndef os_readdir
 #error  os_readdir() not defined
 #endif
@@ -257,6 +269,18 @@ size_t os_strlcpy(char* dst, const char* src, size_t dstsize);
 #error  os_vsnprintf() not defined
 #endif
 
+#ifndef os_atomic_t
+#error  os_atomic_t not defined
+#endif
+
+#ifndef os_mutex
+#error  os_mutex not defined
+#endif
+
+#ifndef os_sem
+#error  os_sem not defined
+#endif
+
 #ifndef os_thread
 #error  os_thread not defined
 #endif
@@ -289,6 +313,10 @@ size_t os_strlcpy(char* dst, const char* src, size_t dstsize);
 #error  FILE_t not defined
 #endif
 
+#ifndef sint64
+#error  sint64 not defined
+#endif
+
 #ifndef uint8
 #define uint8 char
 #endif
@@ -326,22 +354,40 @@ size_t os_strlcpy(char* dst, const char* src, size_t dstsize);
 #endif
 
 os_timer_id os_add_timer(uint32 interval, os_timer_cb callback, void* param);
+int         os_atomic_get(os_atomic_t* atomic);
+void        os_atomic_set(os_atomic_t* atomic, int value);
 status_t    os_console_init(bool_t is_plain_mode);
+os_mutex*   os_create_mutex(void);
+os_sem*     os_create_semaphore(uint32 initial_value);
 os_thread*  os_create_thread(os_thread_func fn, const char* name, void* data);
 void        os_delay(uint32 delay_in_ms);
+void        os_delay_us(uint32 delay_in_us);
+void        os_delay_until_us(uint64 deadline_us);
+void        os_destroy_mutex(os_mutex* mutex);
+void        os_destroy_semaphore(os_sem* sem);
 void        os_detach_thread(os_thread* thread);
 const char* os_get_error(void);
+status_t    os_get_file_info(const char* path, uint64* mtime, uint64* size);
 status_t    os_get_prompt(char prompt[PROMPT_BUFFER_SIZE]);
 uint64      os_get_ticks(void);
+uint64      os_get_ticks_us(void);
 const char* os_get_user_directory(void);
 status_t    os_init(void);
 bool_t      os_key_is_hit(void);
+void        os_lock_mutex(os_mutex* mutex);
 void        os_log(const log_level_t level, const char* format, ...);
+const void* os_map_file(const char* path, uint32* size);
 void        os_print(const color_t color, const char* format, ...);
 void        os_print_prompt(void);
 bool_t      os_remove_timer(os_timer_id id);
+void        os_sem_post(os_sem* sem);
+uint32      os_sem_value(os_sem* sem);
+bool_t      os_sem_wait_timeout(os_sem* sem, uint32 timeout_ms);
 uint64      os_swap_64(uint64 n);
 uint32      os_swap_be_32(uint32 n);
+void        os_unlock_mutex(os_mutex* mutex);
+void        os_unmap_file(const void* data, uint32 size);
+void        os_wait_thread(os_thread* thread);
 void        os_quit(void);
 
 #endif /* OS_H */
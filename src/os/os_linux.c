@@ -9,11 +9,15 @@
 
 #include "SDL.h"
 #include "dirent.h"
+#include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
 #include <readline/readline.h>
 #include <readline/history.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
 #include "os.h"
 
@@ -28,12 +32,36 @@ os_timer_id os_add_timer(uint32 interval, os_timer_cb callback, void* param)
     return SDL_AddTimer(interval, callback, param);
 }
 
+int os_atomic_get(os_atomic_t* atomic)
+{
+    int value = SDL_AtomicGet(atomic);
+
+    SDL_MemoryBarrierAcquire();
+    return value;
+}
+
+void os_atomic_set(os_atomic_t* atomic, int value)
+{
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(atomic, value);
+}
+
 status_t os_console_init(bool_t is_plain_mode)
 {
     console_is_plain_mode = is_plain_mode;
     return ALL_OK;
 }
 
+os_mutex* os_create_mutex(void)
+{
+    return SDL_CreateMutex();
+}
+
+os_sem* os_create_semaphore(uint32 initial_value)
+{
+    return SDL_CreateSemaphore(initial_value);
+}
+
 os_thread* os_create_thread(os_thread_func fn, const char* name, void* data)
 {
     return SDL_CreateThread(fn, name, data);
@@ -44,6 +72,37 @@ void os_delay(uint32 delay_in_ms)
     SDL_Delay(delay_in_ms);
 }
 
+void os_delay_us(uint32 delay_in_us)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = delay_in_us / 1000000;
+    ts.tv_nsec = (delay_in_us % 1000000) * 1000;
+
+    while ((-1 == nanosleep(&ts, &ts)) && (EINTR == errno)) {}
+}
+
+void os_delay_until_us(uint64 deadline_us)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = (time_t)(deadline_us / 1000000);
+    ts.tv_nsec = (long)((deadline_us % 1000000) * 1000);
+
+    /* Absolute, so an interrupted or late wake-up doesn't add up. */
+    while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)) {}
+}
+
+void os_destroy_mutex(os_mutex* mutex)
+{
+    SDL_DestroyMutex(mutex);
+}
+
+void os_destroy_semaphore(os_sem* sem)
+{
+    SDL_DestroySemaphore(sem);
+}
+
 void os_detach_thread(os_thread* thread)
 {
     SDL_DetachThread(thread);
@@ -54,6 +113,21 @@ const char* os_get_error(void)
     return SDL_GetError();
 }
 
+status_t os_get_file_info(const char* path, uint64* mtime, uint64* size)
+{
+    struct stat st;
+
+    if (0 != stat(path, &st))
+    {
+        return OS_FILE_NOT_FOUND;
+    }
+
+    *mtime = (uint64)st.st_mtime;
+    *size  = (uint64)st.st_size;
+
+    return ALL_OK;
+}
+
 status_t os_get_prompt(char prompt[PROMPT_BUFFER_SIZE])
 {
     status_t status = ALL_OK;
@@ -80,6 +154,14 @@ uint64 os_get_ticks(void)
     return SDL_GetTicks64();
 }
 
+uint64 os_get_ticks_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64)ts.tv_sec * 1000000) + ((uint64)ts.tv_nsec / 1000);
+}
+
 const char *os_get_user_directory(void)
 {
     static char user_directory[PATH_MAX] = { 0 };
@@ -132,6 +214,11 @@ bool_t os_key_is_hit(void)
     }
 }
 
+void os_lock_mutex(os_mutex* mutex)
+{
+    SDL_LockMutex(mutex);
+}
+
 void os_log(const log_level_t level, const char* format, ...)
 {
     char      buffer[1024];
@@ -168,6 +255,35 @@ void os_log(const log_level_t level, const char* format, ...)
     os_print(DARK_WHITE, "%s\r\n", buffer);
 }
 
+const void* os_map_file(const char* path, uint32* size)
+{
+    struct stat st;
+    void*       data;
+    int         fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    if ((0 != fstat(fd, &st)) || (0 == st.st_size) || ((uint64)st.st_size > 0xffffffffu))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (MAP_FAILED == data)
+    {
+        return NULL;
+    }
+
+    *size = (uint32)st.st_size;
+    return data;
+}
+
 void os_print(const color_t color, const char* format, ...)
 {
     char        buffer[1024];
@@ -230,6 +346,26 @@ bool_t os_remove_timer(os_timer_id id)
     return SDL_RemoveTimer(id);
 }
 
+void os_sem_post(os_sem* sem)
+{
+    SDL_SemPost(sem);
+}
+
+uint32 os_sem_value(os_sem* sem)
+{
+    return SDL_SemValue(sem);
+}
+
+bool_t os_sem_wait_timeout(os_sem* sem, uint32 timeout_ms)
+{
+    if (0 == SDL_SemWaitTimeout(sem, timeout_ms))
+    {
+        return IS_TRUE;
+    }
+
+    return IS_FALSE;
+}
+
 uint64 os_swap_64(uint64 n)
 {
     return SDL_Swap64(n);
@@ -240,6 +376,24 @@ uint32 os_swap_be_32(uint32 n)
     return SDL_SwapBE32(n);
 }
 
+void os_unlock_mutex(os_mutex* mutex)
+{
+    SDL_UnlockMutex(mutex);
+}
+
+void os_unmap_file(const void* data, uint32 size)
+{
+    if (NULL != data)
+    {
+        munmap((void*)data, size);
+    }
+}
+
+void os_wait_thread(os_thread* thread)
+{
+    SDL_WaitThread(thread, NULL);
+}
+
 void os_quit(void)
 {
     SDL_Quit();
@@ -29,6 +29,7 @@
 #define os_ftell     ftell
 #define os_fclose    fclose
 #define os_fgets     fgets
+#define os_fwrite    fwrite
 #define os_fopen     fopen
 #define os_fprintf   fprintf
 #define os_isdigit   SDL_isdigit
@@ -36,11 +37,13 @@
 #define os_isspace   SDL_isspace
 #define os_isxdigit  SDL_isxdigit
 #define os_itoa      SDL_itoa
+#define os_memcmp    SDL_memcmp
 #define os_memcpy    SDL_memcpy
 #define os_memmove   SDL_memmove
 #define os_memset    SDL_memset
 #define os_opendir   opendir
 #define os_printf    printf
+#define os_qsort     SDL_qsort
 #define os_readdir   readdir
 #define os_realloc   SDL_realloc
 #define os_snprintf  SDL_snprintf
@@ -64,6 +67,9 @@
 #define os_va_start  va_start
 #define os_vsnprintf SDL_vsnprintf
 
+#define os_atomic_t    SDL_atomic_t
+#define os_mutex       SDL_mutex
+#define os_sem         SDL_sem
 #define os_thread      SDL_Thread
 #define os_thread_func SDL_ThreadFunction
 #define os_timer_cb    SDL_TimerCallback
@@ -73,6 +79,7 @@
 #define DIR_t     DIR
 #define dirent_t  dirent
 #define FILE_t    FILE
+#define sint64    Sint64
 #define uint8     Uint8
 #define uint16    Uint16
 #define uint32    Uint32
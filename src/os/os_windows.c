@@ -22,6 +22,20 @@ os_timer_id os_add_timer(uint32 interval, os_timer_cb callback, void* param)
     return SDL_AddTimer(interval, callback, param);
 }
 
+int os_atomic_get(os_atomic_t* atomic)
+{
+    int value = SDL_AtomicGet(atomic);
+
+    SDL_MemoryBarrierAcquire();
+    return value;
+}
+
+void os_atomic_set(os_atomic_t* atomic, int value)
+{
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(atomic, value);
+}
+
 status_t os_console_init(bool_t is_plain_mode)
 {
     SetConsoleOutputCP(65001);
@@ -52,6 +66,16 @@ status_t os_console_init(bool_t is_plain_mode)
     return ALL_OK;
 }
 
+os_mutex* os_create_mutex(void)
+{
+    return SDL_CreateMutex();
+}
+
+os_sem* os_create_semaphore(uint32 initial_value)
+{
+    return SDL_CreateSemaphore(initial_value);
+}
+
 os_thread* os_create_thread(os_thread_func fn, const char* name, void* data)
 {
     return SDL_CreateThread(fn, name, data);
@@ -62,6 +86,41 @@ void os_delay(uint32 delay_in_ms)
     SDL_Delay(delay_in_ms);
 }
 
+void os_delay_us(uint32 delay_in_us)
+{
+    uint64 start = SDL_GetPerformanceCounter();
+    uint64 ticks = (SDL_GetPerformanceFrequency() * delay_in_us) / 1000000;
+
+    /* Sleep for the bulk of longer delays, spin for the remainder. */
+    if (delay_in_us >= 2000)
+    {
+        SDL_Delay((delay_in_us / 1000) - 1);
+    }
+
+    while ((SDL_GetPerformanceCounter() - start) < ticks) {}
+}
+
+void os_delay_until_us(uint64 deadline_us)
+{
+    uint64 now = os_get_ticks_us();
+
+    if (deadline_us > now)
+    {
+        deadline_us -= now;
+        os_delay_us((deadline_us > 0xffffffff) ? 0xffffffff : (uint32)deadline_us);
+    }
+}
+
+void os_destroy_mutex(os_mutex* mutex)
+{
+    SDL_DestroyMutex(mutex);
+}
+
+void os_destroy_semaphore(os_sem* sem)
+{
+    SDL_DestroySemaphore(sem);
+}
+
 void os_detach_thread(os_thread* thread)
 {
     SDL_DetachThread(thread);
@@ -72,6 +131,21 @@ const char* os_get_error(void)
     return SDL_GetError();
 }
 
+status_t os_get_file_info(const char* path, uint64* mtime, uint64* size)
+{
+    WIN32_FILE_ATTRIBUTE_DATA info;
+
+    if (0 == GetFileAttributesExA(path, GetFileExInfoStandard, &info))
+    {
+        return OS_FILE_NOT_FOUND;
+    }
+
+    *mtime = ((uint64)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+    *size  = ((uint64)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+
+    return ALL_OK;
+}
+
 status_t os_get_prompt(char prompt[PROMPT_BUFFER_SIZE])
 {
     status_t status = ALL_OK;
@@ -92,6 +166,15 @@ uint64 os_get_ticks(void)
     return SDL_GetTicks64();
 }
 
+uint64 os_get_ticks_us(void)
+{
+    uint64 counter   = SDL_GetPerformanceCounter();
+    uint64 frequency = SDL_GetPerformanceFrequency();
+
+    /* Split up so the multiplication can't overflow. */
+    return ((counter / frequency) * 1000000) + (((counter % frequency) * 1000000) / frequency);
+}
+
 const char* os_get_user_directory(void)
 {
     static char user_directory[MAX_PATH] = { 0 };
@@ -131,6 +214,11 @@ bool_t os_key_is_hit(void)
     }
 }
 
+void os_lock_mutex(os_mutex* mutex)
+{
+    SDL_LockMutex(mutex);
+}
+
 void os_log(const log_level_t level, const char* format, ...)
 {
     char      buffer[1024];
@@ -166,6 +254,41 @@ void os_log(const log_level_t level, const char* format, ...)
     os_print(DARK_WHITE, "%s\r\n", buffer);
 }
 
+const void* os_map_file(const char* path, uint32* size)
+{
+    HANDLE        file;
+    HANDLE        mapping;
+    LARGE_INTEGER file_size;
+    void*         data = NULL;
+
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (INVALID_HANDLE_VALUE == file)
+    {
+        return NULL;
+    }
+
+    if ((0 == GetFileSizeEx(file, &file_size)) || (0 == file_size.QuadPart) || (file_size.QuadPart > 0xffffffff))
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (NULL != mapping)
+    {
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+
+    if (NULL != data)
+    {
+        *size = (uint32)file_size.QuadPart;
+    }
+
+    return data;
+}
+
 void os_print(const color_t color, const char* format, ...)
 {
     char      buffer[1024];
@@ -263,6 +386,26 @@ bool_t os_remove_timer(os_timer_id id)
     return SDL_RemoveTimer(id);
 }
 
+void os_sem_post(os_sem* sem)
+{
+    SDL_SemPost(sem);
+}
+
+uint32 os_sem_value(os_sem* sem)
+{
+    return SDL_SemValue(sem);
+}
+
+bool_t os_sem_wait_timeout(os_sem* sem, uint32 timeout_ms)
+{
+    if (0 == SDL_SemWaitTimeout(sem, timeout_ms))
+    {
+        return IS_TRUE;
+    }
+
+    return IS_FALSE;
+}
+
 uint64 os_swap_64(uint64 n)
 {
     return SDL_Swap64(n);
@@ -273,6 +416,26 @@ uint32 os_swap_be_32(uint32 n)
     return SDL_SwapBE32(n);
 }
 
+void os_unlock_mutex(os_mutex* mutex)
+{
+    SDL_UnlockMutex(mutex);
+}
+
+void os_unmap_file(const void* data, uint32 size)
+{
+    (void)size;
+
+    if (NULL != data)
+    {
+        UnmapViewOfFile(data);
+    }
+}
+
+void os_wait_thread(os_thread* thread)
+{
+    SDL_WaitThread(thread, NULL);
+}
+
 void os_quit(void)
 {
     SDL_Quit();
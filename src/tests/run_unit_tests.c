@@ -13,11 +13,16 @@
 #include <stdint.h>
 #include "cmocka.h"
 #include "test_buffer.h"
+#include "test_dbc.h"
 #include "test_dict.h"
+#include "test_dispatch.h"
 #include "test_nmt.h"
 #include "test_os.h"
+#include "test_pdo.h"
 #include "test_scripts.h"
 #include "test_sdo.h"
+#include "test_sdo_cache.h"
+#include "test_sdo_client.h"
 
 int main(void)
 {
@@ -25,7 +30,15 @@ int main(void)
     {
         cmocka_unit_test(test_buffer_init),
         cmocka_unit_test(test_use_buffer),
+        cmocka_unit_test(test_dbc_decode),
+        cmocka_unit_test(test_dbc_encode),
+        cmocka_unit_test(test_dbc_find_messages),
+        cmocka_unit_test(test_dbc_multiplexing),
+        cmocka_unit_test(test_dbc_registry),
         cmocka_unit_test(test_dict_lookup),
+        cmocka_unit_test(test_dict_eds_overlay),
+        cmocka_unit_test(test_dispatch_filter),
+        cmocka_unit_test(test_dispatch_overrun),
         cmocka_unit_test(test_has_valid_extension),
         cmocka_unit_test(test_lua),
         cmocka_unit_test(test_picoc_00_assignment),
@@ -234,7 +247,20 @@ int main(void)
         cmocka_unit_test(test_os_delay),
         cmocka_unit_test(test_os_get_error),
         cmocka_unit_test(test_os_get_ticks),
+        cmocka_unit_test(test_pdo_periods),
+        cmocka_unit_test(test_pdo_reschedule),
         cmocka_unit_test(test_sdo_lookup_abort_code),
+        cmocka_unit_test(test_sdo_cache_marks),
+        cmocka_unit_test(test_sdo_cache_boot_up),
+        cmocka_unit_test(test_sdo_client_expedited_read),
+        cmocka_unit_test(test_sdo_client_concurrent_nodes),
+        cmocka_unit_test(test_sdo_client_segmented_upload),
+        cmocka_unit_test(test_sdo_client_block_upload),
+        cmocka_unit_test(test_sdo_client_block_upload_lost_segment),
+        cmocka_unit_test(test_sdo_client_block_download_file),
+        cmocka_unit_test(test_sdo_client_block_download_retransmit),
+        cmocka_unit_test(test_sdo_client_timeout_retry),
+        cmocka_unit_test(test_sdo_client_slow_node),
         cmocka_unit_test(test_uint8),
         cmocka_unit_test(test_uint16),
         cmocka_unit_test(test_uint32),
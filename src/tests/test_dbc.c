@@ -0,0 +1,276 @@
+/** @file test_dbc.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "cmocka.h"
+#include "core.h"
+#include "dbc.h"
+#include "os.h"
+#include "test_dbc.h"
+
+static void write_dbc(const char* filename);
+
+void test_dbc_decode(void** state)
+{
+    const message_t* message;
+    dbc_value_t      values[DBC_MAX_VALUES];
+    uint64           frames[2];
+    double           rows[4 * 2];
+
+    (void)state;
+
+    write_dbc("test.dbc");
+    assert_true(dbc_load("test.dbc") == ALL_OK);
+
+    /* Extended IDs match by J1939 PGN whatever the priority and source. */
+    message = dbc_find_message(0x18FF0017);
+    assert_non_null(message);
+    assert_ptr_equal(message, dbc_find_message(0x0CFF00FE));
+    assert_null(dbc_find_message(0x456));
+
+    /* Standard IDs never match extended messages, and the placeholder of
+     * signals in no frame matches neither ID 0 nor PGN 0.
+     */
+    assert_null(dbc_find_message(0x000));
+    assert_string_equal(dbc_decode(0x000, 0), "");
+    assert_string_equal(dbc_find_message(0x0C000003)->name, "TSC1");
+    assert_string_equal(dbc_find_message(0x124)->name, "TesterPresent");
+    assert_string_equal(dbc_find_message(0x80000124)->name, "Ext_Request");
+
+    frames[0] = 0x003412FECC0A1234ULL;
+    frames[1] = 0x0000000000000000ULL;
+
+    assert_int_equal(dbc_decode_values(message, frames[0], values, DBC_MAX_VALUES), 4);
+    assert_true(values[0].raw == 0x234);
+    assert_true(values[1].raw == 0x2B3); /* Motorola, not byte-aligned. */
+    assert_true(values[2].value == 9.0); /* Signed, -2 * 0.5 + 10. */
+    assert_true(values[3].raw == 0x1234);
+
+    dbc_decode_batch(message, frames, 2, rows);
+    assert_true(rows[0] == 564.0);
+    assert_true(rows[1] == 0.0);
+    assert_true(rows[2] == 691.0);
+    assert_true(rows[4] == 9.0);
+    assert_true(rows[5] == 10.0);
+    assert_true(rows[6] == 4660.0);
+
+    dbc_unload();
+    remove("test.dbc");
+}
+
+void test_dbc_encode(void** state)
+{
+    const message_t* message;
+    dbc_value_t      values[DBC_MAX_VALUES];
+    dbc_value_t      decoded[DBC_MAX_VALUES];
+    uint64           data = 0;
+    int              i;
+
+    (void)state;
+
+    write_dbc("test.dbc");
+    assert_true(dbc_load("test.dbc") == ALL_OK);
+
+    message = dbc_find_message(0x18FF0017);
+    assert_non_null(message);
+
+    /* Decoding what was encoded gives the same values back. */
+    assert_int_equal(dbc_decode_values(message, 0x003412FECC0A1234ULL, values, DBC_MAX_VALUES), 4);
+    assert_true(dbc_encode(message, values, 4, &data) == ALL_OK);
+    assert_int_equal(dbc_decode_values(message, data, decoded, DBC_MAX_VALUES), 4);
+    for (i = 0; i < 4; ++i)
+    {
+        assert_true(decoded[i].value == values[i].value);
+    }
+
+    /* Other bits are left alone. */
+    data             = 0xFFFFFFFFFFFFFFFFULL;
+    values[0].signal = dbc_find_signal(message, "A");
+    values[0].value  = 0.0;
+    assert_true(dbc_encode(message, values, 1, &data) == ALL_OK);
+    assert_true(data == 0xFFFFFFFFFFFFF000ULL);
+
+    /* Clamped to the signal's range, and signed. */
+    values[0].signal = dbc_find_signal(message, "C");
+    values[0].value  = 100.0;
+    values[1].signal = values[0].signal;
+    values[1].value  = -2.0;
+    assert_true(dbc_encode(message, values, 1, &data) == ALL_OK);
+    dbc_decode_values(message, data, decoded, DBC_MAX_VALUES);
+    assert_true(decoded[2].value == 73.5);
+    assert_true(dbc_encode(message, &values[1], 1, &data) == ALL_OK);
+    dbc_decode_values(message, data, decoded, DBC_MAX_VALUES);
+    assert_true(decoded[2].value == -2.0);
+
+    values[0].signal = dbc_find_signal(message, "missing");
+    assert_true(dbc_encode(message, values, 1, &data) == OS_INVALID_ARGUMENT);
+
+    /* A multiplexed signal selects its group. */
+    message          = dbc_find_message(0x7E8);
+    data             = 0;
+    values[0].signal = dbc_find_signal(message, "Voltage");
+    values[0].value  = 12.345;
+    assert_true(dbc_encode(message, values, 1, &data) == ALL_OK);
+    assert_true(data == 0x0000000030390002ULL);
+    assert_int_equal(dbc_decode_values(message, data, decoded, DBC_MAX_VALUES), 3);
+    assert_string_equal(message->signals[decoded[2].signal].name, "Voltage");
+
+    dbc_unload();
+    remove("test.dbc");
+}
+
+void test_dbc_find_messages(void** state)
+{
+    const message_t* messages[4];
+    uint32           id = 0;
+
+    (void)state;
+
+    write_dbc("test.dbc");
+    assert_true(dbc_load("test.dbc") == ALL_OK);
+
+    assert_int_equal(dbc_find_messages("test", DBC_MATCH_EXACT, messages, 4), 1);
+    assert_string_equal(messages[0]->name, "TEST");
+
+    /* Sorted by name, so prefix matches can feed completion. */
+    assert_int_equal(dbc_find_messages("Te", DBC_MATCH_PREFIX, messages, 4), 3);
+    assert_string_equal(messages[0]->name, "TEST");
+    assert_string_equal(messages[1]->name, "Tester_Status");
+    assert_string_equal(messages[2]->name, "TesterPresent");
+
+    assert_int_equal(dbc_find_messages("STATUS", DBC_MATCH_SUBSTRING, messages, 4), 2);
+    assert_int_equal(dbc_find_messages("status", DBC_MATCH_SUBSTRING, NULL, 0), 2);
+    assert_int_equal(dbc_find_messages("missing", DBC_MATCH_SUBSTRING, messages, 4), 0);
+
+    /* The first match in file order, as it always was. */
+    assert_true(dbc_find_id_by_name(&id, "status") == ALL_OK);
+    assert_true(id == 0x123);
+
+    dbc_unload();
+    remove("test.dbc");
+}
+
+void test_dbc_multiplexing(void** state)
+{
+    const message_t* message;
+    dbc_value_t      values[DBC_MAX_VALUES];
+
+    (void)state;
+
+    write_dbc("test.dbc");
+    assert_true(dbc_load("test.dbc") == ALL_OK);
+
+    message = dbc_find_message(0x7E8);
+    assert_non_null(message);
+    assert_int_equal(message->mux_count, 2);
+
+    /* Only the multiplexer, the plain signal and the selected group. */
+    assert_int_equal(dbc_decode_values(message, 0x0000000000AB0201ULL, values, DBC_MAX_VALUES), 3);
+    assert_string_equal(message->signals[values[0].signal].name, "Service");
+    assert_string_equal(message->signals[values[1].signal].name, "Status");
+    assert_string_equal(values[1].label, "Busy");
+    assert_string_equal(message->signals[values[2].signal].name, "Temperature");
+    assert_true(values[2].raw == 0xAB);
+
+    assert_int_equal(dbc_decode_values(message, 0x0000000012340302ULL, values, DBC_MAX_VALUES), 3);
+    assert_string_equal(message->signals[values[2].signal].name, "Voltage");
+    assert_null(values[1].label);
+
+    /* No group for this value, so just the always active signals. */
+    assert_int_equal(dbc_decode_values(message, 0x0000000000000007ULL, values, DBC_MAX_VALUES), 2);
+    assert_string_equal(values[1].label, "Off");
+
+    dbc_unload();
+    remove("test.dbc");
+}
+
+void test_dbc_registry(void** state)
+{
+    FILE*  file;
+    uint32 powertrain;
+    uint32 body;
+
+    (void)state;
+
+    write_dbc("test.dbc");
+    file = fopen("body.dbc", "w");
+    assert_non_null(file);
+    fprintf(file, "BO_ 291 Door_Status: 8 BCM\n");
+    fprintf(file, " SG_ Open : 0|1@1+ (1,0) [0|1] \"\" Vector__XXX\n\n");
+    fprintf(file, "BO_ 1024 Light_Status: 8 BCM\n");
+    fclose(file);
+
+    assert_true(dbc_open("test.dbc", &powertrain) == ALL_OK);
+    assert_true(dbc_open("body.dbc", &body) == ALL_OK);
+
+    /* The first database defining an ID wins. */
+    assert_string_equal(dbc_find_message(0x123)->name, "Tester_Status");
+    assert_string_equal(dbc_find_message(0x400)->name, "Light_Status");
+
+    /* A bound database only counts on its interface, but there it wins. */
+    assert_true(dbc_bind(body, "can1", 0, 0x7FF) == ALL_OK);
+    assert_null(dbc_find_message(0x400));
+    assert_true(dbc_select_interface("can1") == ALL_OK);
+    assert_string_equal(dbc_find_message(0x123)->name, "Door_Status");
+    assert_string_equal(dbc_find_message(0x7E8)->name, "Diagnostics");
+    assert_int_equal(dbc_find_messages("status", DBC_MATCH_SUBSTRING, NULL, 0), 4);
+
+    /* Outside its range, the next database is asked. */
+    assert_true(dbc_bind(body, "can1", 0x200, 0x7FF) == ALL_OK);
+    assert_string_equal(dbc_find_message(0x123)->name, "Tester_Status");
+    assert_string_equal(dbc_find_message(0x400)->name, "Light_Status");
+
+    assert_true(dbc_close(powertrain) == ALL_OK);
+    assert_null(dbc_find_message(0x123));
+    assert_true(dbc_close(powertrain) == OS_INVALID_ARGUMENT);
+
+    dbc_select_interface(NULL);
+    dbc_unload();
+    assert_null(dbc_find_message(0x400));
+
+    remove("test.dbc");
+    remove("body.dbc");
+}
+
+static void write_dbc(const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+
+    assert_non_null(file);
+
+    fprintf(file, "VERSION \"\"\n\n");
+    fprintf(file, "BU_: ECU\n\n");
+    fprintf(file, "BO_ 3221225472 VECTOR__INDEPENDENT_SIG_MSG: 0 Vector__XXX\n");
+    fprintf(file, " SG_ Spare : 0|8@1+ (1,0) [0|255] \"\" Vector__XXX\n\n");
+    fprintf(file, "BO_ 2348875518 TSC1: 8 Vector__XXX\n");
+    fprintf(file, " SG_ Speed : 8|16@1+ (0.125,0) [0|8031.875] \"rpm\" Vector__XXX\n\n");
+    fprintf(file, "BO_ 2566848766 TEST: 8 ECU\n");
+    fprintf(file, " SG_ A : 0|12@1+ (1,0) [0|4095] \"\" Vector__XXX\n");
+    fprintf(file, " SG_ B : 19|10@0+ (1,0) [0|1023] \"\" Vector__XXX\n");
+    fprintf(file, " SG_ C : 32|8@1- (0.5,10) [-54|73.5] \"V\" Vector__XXX\n");
+    fprintf(file, " SG_ D : 47|16@0+ (1,0) [0|65535] \"rpm\" Vector__XXX\n\n");
+    fprintf(file, "BO_ 291 Tester_Status: 8 ECU\n");
+    fprintf(file, " SG_ State : 0|8@1+ (1,0) [0|255] \"\" Vector__XXX\n\n");
+    fprintf(file, "BO_ 2147483940 Ext_Request: 8 ECU\n\n");
+    fprintf(file, "BO_ 292 TesterPresent: 1 ECU\n\n");
+    fprintf(file, "BO_ 293 Gateway_Status: 8 ECU\n\n");
+    fprintf(file, "BO_ 2024 Diagnostics: 8 ECU\n");
+    fprintf(file, " SG_ Temperature m1 : 16|8@1+ (1,0) [0|255] \"degC\" Vector__XXX\n");
+    fprintf(file, " SG_ Service M : 0|8@1+ (1,0) [0|255] \"\" Vector__XXX\n");
+    fprintf(file, " SG_ Voltage m2 : 16|16@1+ (0.001,0) [0|65.535] \"V\" Vector__XXX\n");
+    fprintf(file, " SG_ Status : 8|2@1+ (1,0) [0|3] \"\" Vector__XXX\n\n");
+    fprintf(file, "VAL_ 3221225472 Spare 0 \"None\" ;\n");
+    fprintf(file, "VAL_ 2024 Status 0 \"Off\" 2 \"Busy\" 1 \"On\" ;\n");
+
+    fclose(file);
+}
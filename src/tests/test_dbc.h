@@ -0,0 +1,19 @@
+/** @file test_dbc.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef TEST_DBC_H
+#define TEST_DBC_H
+
+void test_dbc_decode(void** state);
+void test_dbc_encode(void** state);
+void test_dbc_find_messages(void** state);
+void test_dbc_multiplexing(void** state);
+void test_dbc_registry(void** state);
+
+#endif /* TEST_DBC_H */
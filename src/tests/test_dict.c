@@ -255,3 +255,42 @@ void test_dict_lookup(void** state)
     assert_string_equal(dict_lookup(0xC000, 0x00), "Reserved");
     assert_string_equal(dict_lookup(0xFFFF, 0xFF), "Reserved");
 }
+
+void test_dict_eds_overlay(void** state)
+{
+    static const char        strings[] = "\0Drive type\0Vendor name";
+    static const eds_entry_t entries[] =
+    {
+        { 0x1000, 0x00, 0x7, 0x0007, RO,       0, 0, 0,     0x191, 1 },
+        { 0x1018, 0x01, 0x7, 0x0007, RO_CONST, 0, 1, 0xff,  0,     0 },
+        { 0x2000, 0x00, 0x7, 0x0005, RW,       1, 0, 0x64,  0x10,  12 }
+    };
+    dict_meta_t meta;
+
+    (void)state;
+
+    dict_set_eds(entries, 3, strings);
+
+    assert_string_equal(dict_lookup(0x1000, 0x00), "Drive type");
+    assert_string_equal(dict_lookup(0x2000, 0x00), "Vendor name");
+
+    /* No name in the EDS falls back to the built-in one. */
+    assert_string_equal(dict_lookup(0x1018, 0x01), "Identity object, Vendor-ID");
+    assert_string_equal(dict_lookup(0x1018, 0x02), "Identity object, Product code");
+
+    assert_true(dict_get_meta(0x2000, 0x00, &meta));
+    assert_true(meta.is_from_eds);
+    assert_string_equal(meta.access, "rw");
+    assert_int_equal(meta.data_type, 0x0005);
+    assert_int_equal(meta.high_limit, 0x64);
+    assert_int_equal(meta.default_value, 0x10);
+
+    assert_true(dict_get_meta(0x1018, 0x02, &meta));
+    assert_false(meta.is_from_eds);
+    assert_null(meta.access);
+
+    dict_set_eds(NULL, 0, NULL);
+
+    assert_string_equal(dict_lookup(0x1000, 0x00), "Device type");
+    assert_string_equal(dict_lookup(0x2000, 0x00), "Manufacturer-specific profile area");
+}
@@ -0,0 +1,109 @@
+/** @file test_dispatch.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include "cmocka.h"
+#include "can.h"
+#include "core.h"
+#include "dispatch.h"
+#include "os.h"
+#include "test_dispatch.h"
+
+void test_dispatch_filter(void** state)
+{
+    core_t          core          = { 0 };
+    can_filter_t    filter        = { 0x581, CAN_SFF_ID_MASK, IS_FALSE };
+    can_filter_t    ext_filter    = { 0x18ff0581, CAN_EFF_ID_MASK, IS_TRUE };
+    can_message_t   frames[3]     = { { 0 } };
+    can_message_t   ext_frames[2] = { { 0 } };
+    can_message_t   received[8]   = { { 0 } };
+    dispatch_sub_t* sub;
+    dispatch_sub_t* ext_sub;
+    dispatch_sub_t* sniffer;
+
+    (void)state;
+
+    frames[0].id = 0x581;
+    frames[1].id = 0x182;
+    frames[2].id = 0x581;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    sub     = dispatch_subscribe(&filter, 1, 32);
+    sniffer = dispatch_subscribe(NULL, 0, 32);
+    assert_non_null(sub);
+    assert_non_null(sniffer);
+
+    dispatch_deliver(frames, 3);
+
+    assert_true(dispatch_read(sub, received, 8, 0) == 2);
+    assert_true(received[0].id == 0x581);
+    assert_true(received[1].id == 0x581);
+    assert_true(dispatch_read(sub, received, 8, 0) == 0);
+    assert_true(dispatch_read(sniffer, received, 8, 0) == 3);
+
+    dispatch_pause(sub, IS_TRUE);
+    dispatch_deliver(frames, 3);
+    assert_true(dispatch_read(sub, received, 8, 0) == 0);
+
+    /* 29-bit frames carry the EFF flag in the ID, as read from SocketCAN. */
+    ext_frames[0].id          = 0x98ff0581;
+    ext_frames[0].is_extended = IS_TRUE;
+    ext_frames[1].id          = 0x581;
+
+    ext_sub = dispatch_subscribe(&ext_filter, 1, 32);
+    assert_non_null(ext_sub);
+
+    dispatch_deliver(ext_frames, 2);
+    assert_true(dispatch_read(ext_sub, received, 8, 0) == 1);
+    assert_true(received[0].id == 0x98ff0581);
+
+    dispatch_unsubscribe(ext_sub);
+    dispatch_unsubscribe(sub);
+    dispatch_unsubscribe(sniffer);
+    dispatch_deinit(&core);
+}
+
+void test_dispatch_overrun(void** state)
+{
+    core_t          core = { 0 };
+    can_message_t   frames[DISPATCH_MIN_CAPACITY + 4] = { { 0 } };
+    can_message_t   received[DISPATCH_MIN_CAPACITY + 4];
+    dispatch_sub_t* sub;
+    uint32          index;
+
+    (void)state;
+
+    for (index = 0; index < DISPATCH_MIN_CAPACITY + 4; index += 1)
+    {
+        frames[index].id = index;
+    }
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    sub = dispatch_subscribe(NULL, 0, 1);
+    assert_non_null(sub);
+    assert_true(sub->capacity == DISPATCH_MIN_CAPACITY);
+
+    dispatch_deliver(frames, DISPATCH_MIN_CAPACITY + 4);
+
+    assert_true(dispatch_read(sub, received, DISPATCH_MIN_CAPACITY + 4, 0) == DISPATCH_MIN_CAPACITY);
+    assert_true(received[DISPATCH_MIN_CAPACITY - 1].id == DISPATCH_MIN_CAPACITY - 1);
+    assert_true(dispatch_get_overruns(sub) == 4);
+
+    dispatch_deliver(frames, 1);
+    dispatch_flush(sub);
+    assert_true(dispatch_read(sub, received, 1, 0) == 0);
+
+    dispatch_unsubscribe(sub);
+    dispatch_deinit(&core);
+}
@@ -0,0 +1,16 @@
+/** @file test_dispatch.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef TEST_DISPATCH_H
+#define TEST_DISPATCH_H
+
+void test_dispatch_filter(void** state);
+void test_dispatch_overrun(void** state);
+
+#endif /* TEST_DISPATCH_H */
@@ -0,0 +1,174 @@
+/** @file test_pdo.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include "cmocka.h"
+#include "can.h"
+#include "os.h"
+#include "pdo.h"
+#include "test_pdo.h"
+#include "test_wrapper.h"
+
+static uint32 count_frames(uint32 num_frames, uint16 can_id, const can_message_t** frame)
+{
+    uint32 index;
+    uint32 count = 0;
+
+    for (index = 0; (index < num_frames) && (index < wrap_num_written); index += 1)
+    {
+        if (can_id == wrap_written[index].id)
+        {
+            *frame  = &wrap_written[index];
+            count  += 1;
+        }
+    }
+
+    return count;
+}
+
+void test_pdo_periods(void** state)
+{
+    const can_message_t* frame;
+    const uint16         can_id[3]    = { 0x181, 0x182, 0x183 };
+    const uint32         period[3]    = { 1, 300, 70000 };
+    uint32               num_sent[3]  = { 0 };
+    uint64               last_sent[3] = { 0 };
+    uint64               start;
+    uint64               now;
+    uint32               num_frames;
+    uint32               index;
+
+    (void)state;
+
+    start = os_get_ticks_us() / 1000;
+    for (index = 0; index < 3; index += 1)
+    {
+        assert_true(pdo_add(can_id[index], period[index], 2, 0x1234, TERM_MODE) == IS_TRUE);
+    }
+
+    /* Long enough to cascade down from the second and third level. */
+    for (now = start + 1; now <= start + 150000; now += 1)
+    {
+        num_frames = pdo_process(now);
+
+        for (index = 0; index < 3; index += 1)
+        {
+            if (0 == count_frames(num_frames, can_id[index], &frame))
+            {
+                continue;
+            }
+
+            if (0 == num_sent[index])
+            {
+                assert_true((now - start) >= period[index]);
+                assert_true((now - start) <= (period[index] + 10));
+            }
+            else
+            {
+                assert_true((now - last_sent[index]) == period[index]);
+            }
+
+            assert_true(frame->length == 2);
+            assert_true(frame->data[0] == 0x12);
+            assert_true(frame->data[1] == 0x34);
+
+            last_sent[index]  = now;
+            num_sent[index]  += 1;
+        }
+    }
+
+    assert_true(num_sent[0] >= 149990);
+    assert_true(num_sent[1] >= 499);
+    assert_true(num_sent[2] == 2);
+
+    pdo_deinit();
+}
+
+void test_pdo_reschedule(void** state)
+{
+    const can_message_t* frame;
+    uint64               now;
+    uint64               last_sent = 0;
+    uint32               num_sent  = 0;
+    uint32               num_frames;
+    uint32               step;
+
+    (void)state;
+
+    now = os_get_ticks_us() / 1000;
+
+    /* Deleted while linked into the same slot as another. */
+    assert_true(pdo_add(0x201, 10, 1, 0x01, TERM_MODE) == IS_TRUE);
+    assert_true(pdo_add(0x202, 10, 1, 0x02, TERM_MODE) == IS_TRUE);
+    assert_true(pdo_del(0x201, TERM_MODE) == IS_TRUE);
+
+    for (step = 0; step < 40; step += 1)
+    {
+        now       += 1;
+        num_frames = pdo_process(now);
+        assert_true(count_frames(num_frames, 0x201, &frame) == 0);
+        num_sent  += count_frames(num_frames, 0x202, &frame);
+    }
+    assert_true(num_sent >= 3);
+
+    /* Adding it again replaces the old entry, counting from now. */
+    assert_true(pdo_add(0x202, 20, 1, 0x22, TERM_MODE) == IS_TRUE);
+    last_sent = now + 1;
+    num_sent  = 0;
+
+    for (step = 0; step < 100; step += 1)
+    {
+        now       += 1;
+        num_frames = pdo_process(now);
+
+        if (0 == count_frames(num_frames, 0x202, &frame))
+        {
+            continue;
+        }
+
+        assert_true(count_frames(num_frames, 0x202, &frame) == 1);
+        assert_true(frame->data[0] == 0x22);
+        assert_true((now - last_sent) == 20);
+
+        last_sent  = now;
+        num_sent  += 1;
+    }
+    assert_true(num_sent == 4);
+    assert_true(pdo_del(0x202, TERM_MODE) == IS_TRUE);
+
+    /* An event time of zero sends once. */
+    assert_true(pdo_add(0x203, 0, 1, 0x03, TERM_MODE) == IS_TRUE);
+    num_sent = 0;
+
+    for (step = 0; step < 100; step += 1)
+    {
+        now       += 1;
+        num_frames = pdo_process(now);
+        num_sent  += count_frames(num_frames, 0x203, &frame);
+    }
+    assert_true(num_sent == 1);
+
+    /* Waking up late sends once and skips the cycles that were missed. */
+    assert_true(pdo_add(0x204, 10, 1, 0x04, TERM_MODE) == IS_TRUE);
+
+    now       += 55;
+    num_frames = pdo_process(now);
+    assert_true(count_frames(num_frames, 0x204, &frame) == 1);
+
+    for (step = 1; step <= 10; step += 1)
+    {
+        num_frames = pdo_process(now + step);
+        assert_true(count_frames(num_frames, 0x204, &frame) == ((10 == step) ? 1 : 0));
+    }
+
+    pdo_deinit();
+}
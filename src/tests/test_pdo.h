@@ -0,0 +1,16 @@
+/** @file test_pdo.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef TEST_PDO_H
+#define TEST_PDO_H
+
+void test_pdo_periods(void** state);
+void test_pdo_reschedule(void** state);
+
+#endif /* TEST_PDO_H */
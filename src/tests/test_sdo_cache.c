@@ -0,0 +1,107 @@
+/** @file test_sdo_cache.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include "cmocka.h"
+#include "can.h"
+#include "core.h"
+#include "dispatch.h"
+#include "os.h"
+#include "sdo.h"
+#include "sdo_cache.h"
+#include "test_sdo_cache.h"
+
+void test_sdo_cache_marks(void** state)
+{
+    core_t                   core    = { 0 };
+    const uint8              name[6] = { 'M', 'o', 't', 'o', 'r', '\0' };
+    const sdo_cache_entry_t* entry;
+    uint32                   value   = 0x00020192;
+
+    (void)state;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    /* Constant objects are kept by default, anything else isn't. */
+    sdo_cache_store(0x05, 0x1000, 0x00, IS_READ_EXPEDITED, (const uint8*)&value, sizeof(value));
+    sdo_cache_store(0x05, 0x1008, 0x00, IS_READ_SEGMENTED, name, 5);
+    sdo_cache_store(0x05, 0x1017, 0x00, IS_READ_EXPEDITED, (const uint8*)&value, 2);
+
+    entry = sdo_cache_lookup(0x05, 0x1000, 0x00);
+    assert_non_null(entry);
+    assert_true(entry->length == sizeof(value));
+    assert_memory_equal(entry->data, &value, sizeof(value));
+
+    entry = sdo_cache_lookup(0x05, 0x1008, 0x00);
+    assert_non_null(entry);
+    assert_true(entry->sdo_state == IS_READ_SEGMENTED);
+    assert_memory_equal(entry->data, name, 5);
+
+    assert_true(sdo_cache_lookup(0x05, 0x1017, 0x00) == NULL);
+    assert_true(sdo_cache_lookup(0x06, 0x1000, 0x00) == NULL);
+
+    /* A mark for one node doesn't apply to the others. */
+    sdo_cache_mark(0x05, 0x2000, 0x01, IS_TRUE);
+    sdo_cache_store(0x05, 0x2000, 0x01, IS_READ_EXPEDITED, (const uint8*)&value, 1);
+    sdo_cache_store(0x06, 0x2000, 0x01, IS_READ_EXPEDITED, (const uint8*)&value, 1);
+    assert_true(sdo_cache_lookup(0x05, 0x2000, 0x01) != NULL);
+    assert_true(sdo_cache_lookup(0x06, 0x2000, 0x01) == NULL);
+
+    /* A write drops the object, but nothing else. */
+    sdo_cache_remove(0x05, 0x2000, 0x01);
+    assert_true(sdo_cache_lookup(0x05, 0x2000, 0x01) == NULL);
+    assert_true(sdo_cache_lookup(0x05, 0x1008, 0x00) != NULL);
+
+    /* Unmarking drops what's there. */
+    sdo_cache_mark(0, 0x1000, 0x00, IS_FALSE);
+    assert_true(sdo_cache_lookup(0x05, 0x1000, 0x00) == NULL);
+    sdo_cache_store(0x05, 0x1000, 0x00, IS_READ_EXPEDITED, (const uint8*)&value, sizeof(value));
+    assert_true(sdo_cache_lookup(0x05, 0x1000, 0x00) == NULL);
+
+    sdo_cache_deinit();
+    dispatch_deinit(&core);
+}
+
+void test_sdo_cache_boot_up(void** state)
+{
+    core_t        core      = { 0 };
+    can_message_t heartbeat = { 0 };
+    uint32        value     = 0x00020192;
+
+    (void)state;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    sdo_cache_store(0x05, 0x1000, 0x00, IS_READ_EXPEDITED, (const uint8*)&value, sizeof(value));
+    sdo_cache_store(0x06, 0x1000, 0x00, IS_READ_EXPEDITED, (const uint8*)&value, sizeof(value));
+
+    /* Heartbeats leave the entries alone. */
+    heartbeat.id      = 0x705;
+    heartbeat.length  = 1;
+    heartbeat.data[0] = 0x05;
+    dispatch_deliver(&heartbeat, 1);
+
+    assert_true(sdo_cache_lookup(0x05, 0x1000, 0x00) != NULL);
+
+    /* A boot-up only drops what belongs to that node. */
+    heartbeat.data[0] = 0x00;
+    dispatch_deliver(&heartbeat, 1);
+
+    assert_true(sdo_cache_lookup(0x05, 0x1000, 0x00) == NULL);
+    assert_true(sdo_cache_lookup(0x06, 0x1000, 0x00) != NULL);
+
+    sdo_cache_invalidate(0);
+    assert_true(sdo_cache_lookup(0x06, 0x1000, 0x00) == NULL);
+
+    sdo_cache_deinit();
+    dispatch_deinit(&core);
+}
@@ -0,0 +1,16 @@
+/** @file test_sdo_cache.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef TEST_SDO_CACHE_H
+#define TEST_SDO_CACHE_H
+
+void test_sdo_cache_marks(void** state);
+void test_sdo_cache_boot_up(void** state);
+
+#endif /* TEST_SDO_CACHE_H */
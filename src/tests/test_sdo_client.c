@@ -0,0 +1,497 @@
+/** @file test_sdo_client.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "cmocka.h"
+#include "can.h"
+#include "core.h"
+#include "dispatch.h"
+#include "os.h"
+#include "sdo.h"
+#include "sdo_client.h"
+#include "test_sdo_client.h"
+
+static void deliver_response(uint8 node_id, uint8 cmd, uint16 index, uint8 sub_index, uint32 value)
+{
+    can_message_t response = { 0 };
+
+    response.id      = 0x580 + node_id;
+    response.length  = 8;
+    response.data[0] = cmd;
+    response.data[1] = (uint8)(index & 0xff);
+    response.data[2] = (uint8)(index >> 8);
+    response.data[3] = sub_index;
+    response.data[4] = (uint8)(value & 0xff);
+    response.data[5] = (uint8)((value >> 8) & 0xff);
+    response.data[6] = (uint8)((value >> 16) & 0xff);
+    response.data[7] = (uint8)((value >> 24) & 0xff);
+
+    dispatch_deliver(&response, 1);
+}
+
+static void deliver_frame(uint8 node_id, const uint8 data[8])
+{
+    can_message_t response = { 0 };
+
+    response.id     = 0x580 + node_id;
+    response.length = 8;
+    os_memcpy(response.data, data, 8);
+
+    dispatch_deliver(&response, 1);
+}
+
+void test_sdo_client_expedited_read(void** state)
+{
+    core_t           core       = { 0 };
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    uint8            buffer[4]  = { 0 };
+    uint32           handle;
+
+    (void)state;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    request.type      = SDO_REQUEST_READ;
+    request.node_id   = 0x10;
+    request.index     = 0x1000;
+    request.sub_index = 0x00;
+    request.data      = buffer;
+    request.length    = sizeof(buffer);
+
+    handle = sdo_client_submit(&request);
+    assert_true(handle != 0);
+    assert_true(sdo_client_get_pending() == 1);
+
+    deliver_response(0x10, 0x43, 0x1000, 0x00, 0x00020192);
+
+    assert_true(sdo_client_process(0) == ALL_OK);
+    assert_true(sdo_client_get_pending() == 0);
+    assert_true(sdo_client_get_completion(&completion) == IS_TRUE);
+    assert_true(completion.handle == handle);
+    assert_true(completion.sdo_state == IS_READ_EXPEDITED);
+    assert_true(completion.length == 4);
+    assert_true(buffer[0] == 0x92);
+    assert_true(buffer[1] == 0x01);
+    assert_true(buffer[2] == 0x02);
+    assert_true(sdo_client_process(0) == NOTHING_TO_DO);
+
+    sdo_client_deinit();
+    dispatch_deinit(&core);
+}
+
+void test_sdo_client_concurrent_nodes(void** state)
+{
+    core_t           core       = { 0 };
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    uint8            buffer[3][4];
+    uint32           handle[3];
+
+    (void)state;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    request.type      = SDO_REQUEST_READ;
+    request.index     = 0x1018;
+    request.sub_index = 0x01;
+    request.length    = 4;
+
+    request.node_id = 0x01;
+    request.data    = buffer[0];
+    handle[0]       = sdo_client_submit(&request);
+
+    request.node_id = 0x02;
+    request.data    = buffer[1];
+    handle[1]       = sdo_client_submit(&request);
+
+    /* Same node as the first, so it has to wait its turn. */
+    request.node_id   = 0x01;
+    request.sub_index = 0x02;
+    request.data      = buffer[2];
+    handle[2]         = sdo_client_submit(&request);
+
+    assert_true(sdo_client_get_pending() == 3);
+
+    deliver_response(0x02, 0x43, 0x1018, 0x01, 0x0000affe);
+    deliver_response(0x01, 0x80, 0x1018, 0x01, ABORT_OBJECT_DOES_NOT_EXIST);
+    assert_true(sdo_client_process(0) == ALL_OK);
+
+    assert_true(sdo_client_get_completion(&completion) == IS_TRUE);
+    assert_true(completion.handle == handle[1]);
+    assert_true(completion.sdo_state == IS_READ_EXPEDITED);
+
+    assert_true(sdo_client_get_completion(&completion) == IS_TRUE);
+    assert_true(completion.handle == handle[0]);
+    assert_true(completion.sdo_state == ABORT_TRANSFER);
+    assert_true(completion.abort_code == ABORT_OBJECT_DOES_NOT_EXIST);
+
+    assert_true(sdo_client_get_pending() == 1);
+
+    deliver_response(0x01, 0x4b, 0x1018, 0x02, 0x00001234);
+    assert_true(sdo_client_wait(handle[2], &completion) == ALL_OK);
+    assert_true(completion.sdo_state == IS_READ_EXPEDITED);
+    assert_true(completion.length == 2);
+
+    sdo_client_deinit();
+    dispatch_deinit(&core);
+}
+
+void test_sdo_client_segmented_upload(void** state)
+{
+    core_t           core       = { 0 };
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    uint8            segment[8] = { 0 };
+    uint32           handle;
+    uint32           offset;
+    uint32           index;
+    uint8            toggle     = 0;
+    const uint32     size       = 300;
+
+    (void)state;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    /* No buffer given, so the client has to allocate one. */
+    request.type      = SDO_REQUEST_READ;
+    request.node_id   = 0x06;
+    request.index     = 0x1021;
+    request.sub_index = 0x00;
+
+    handle = sdo_client_submit(&request);
+    assert_true(handle != 0);
+
+    deliver_response(0x06, 0x41, 0x1021, 0x00, size);
+
+    /* Longer than a byte can count and with embedded zeros. */
+    for (offset = 0; offset < size; offset += 7)
+    {
+        uint32 length = ((size - offset) > 7) ? 7 : (size - offset);
+
+        os_memset(segment, 0, sizeof(segment));
+        segment[0] = toggle | (uint8)((7 - length) << 1) | (((offset + length) == size) ? 0x01 : 0x00);
+
+        for (index = 0; index < length; index += 1)
+        {
+            segment[1 + index] = (uint8)((offset + index) & 0xff);
+        }
+
+        deliver_frame(0x06, segment);
+        toggle ^= 0x10;
+    }
+
+    assert_true(sdo_client_wait(handle, &completion) == ALL_OK);
+    assert_true(completion.sdo_state == IS_READ_SEGMENTED);
+    assert_true(completion.length == size);
+    assert_non_null(completion.request.data);
+
+    for (index = 0; index < size; index += 1)
+    {
+        assert_true(completion.request.data[index] == (uint8)(index & 0xff));
+    }
+    assert_true(completion.request.data[size] == 0x00);
+
+    os_free(completion.request.data);
+
+    sdo_client_deinit();
+    dispatch_deinit(&core);
+}
+
+void test_sdo_client_block_upload(void** state)
+{
+    core_t           core       = { 0 };
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    uint8            buffer[32] = { 0 };
+    uint32           handle;
+    const uint8      segment_1[8] = { 0x01, '0', '1', '2', '3', '4', '5', '6' };
+    const uint8      segment_2[8] = { 0x82, '7', '8', '9', 0x00, 0x00, 0x00, 0x00 };
+    const uint8      end[8]       = { 0xd1, 0x58, 0x9c, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+    (void)state;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    request.type      = SDO_REQUEST_READ_BLOCK;
+    request.node_id   = 0x03;
+    request.index     = 0x2000;
+    request.sub_index = 0x01;
+    request.data      = buffer;
+    request.length    = sizeof(buffer);
+
+    handle = sdo_client_submit(&request);
+    assert_true(handle != 0);
+
+    /* CRC and size indicated, then two segments and the end frame. */
+    deliver_response(0x03, 0xc6, 0x2000, 0x01, 10);
+    deliver_frame(0x03, segment_1);
+    deliver_frame(0x03, segment_2);
+    deliver_frame(0x03, end);
+
+    assert_true(sdo_client_wait(handle, &completion) == ALL_OK);
+    assert_true(completion.sdo_state == IS_READ_BLOCK);
+    assert_true(completion.length == 10);
+    assert_memory_equal(buffer, "0123456789", 10);
+
+    sdo_client_deinit();
+    dispatch_deinit(&core);
+}
+
+void test_sdo_client_block_upload_lost_segment(void** state)
+{
+    core_t           core       = { 0 };
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    uint8            buffer[32] = { 0 };
+    uint32           handle;
+    uint32           rto;
+    uint64           start;
+    const uint8      segment_1[8] = { 0x01, '0', '1', '2', '3', '4', '5', '6' };
+    const uint8      segment_2[8] = { 0x02, '7', '8', '9', 'a', 'b', 'c', 'd' };
+    const uint8      resent[8]    = { 0x81, 'e', 'f', 'g', 'h', 'i', 'j', 'k' };
+    const uint8      end[8]       = { 0xc1, 0xdd, 0xf1, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+    (void)state;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    request.type      = SDO_REQUEST_READ_BLOCK;
+    request.node_id   = 0x07;
+    request.index     = 0x2000;
+    request.sub_index = 0x02;
+    request.data      = buffer;
+    request.length    = sizeof(buffer);
+
+    handle = sdo_client_submit(&request);
+    assert_true(handle != 0);
+
+    /* The last segment of the block never arrives. */
+    deliver_response(0x07, 0xc6, 0x2000, 0x02, 21);
+    deliver_frame(0x07, segment_1);
+    deliver_frame(0x07, segment_2);
+
+    rto   = sdo_client_get_rto(0x07);
+    start = os_get_ticks();
+    while ((os_get_ticks() - start) < (rto + (rto / 2)))
+    {
+        sdo_client_process(1);
+    }
+    assert_true(sdo_client_get_pending() == 1);
+
+    /* The first two were acked, so the server resends the third. */
+    deliver_frame(0x07, resent);
+    deliver_frame(0x07, end);
+
+    assert_true(sdo_client_wait(handle, &completion) == ALL_OK);
+    assert_true(completion.sdo_state == IS_READ_BLOCK);
+    assert_true(completion.length == 21);
+    assert_memory_equal(buffer, "0123456789abcdefghijk", 21);
+
+    sdo_client_deinit();
+    dispatch_deinit(&core);
+}
+
+void test_sdo_client_block_download_file(void** state)
+{
+    core_t           core       = { 0 };
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    FILE_t*          file;
+    uint32           handle;
+    const uint8      ack[8] = { 0xa2, 0x02, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    const uint8      end[8] = { 0xa1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+    (void)state;
+
+    file = tmpfile();
+    assert_non_null(file);
+    assert_true(os_fwrite("0123456789", 1, 10, file) == 10);
+    rewind(file);
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    request.type      = SDO_REQUEST_WRITE_BLOCK;
+    request.node_id   = 0x04;
+    request.index     = 0x1f50;
+    request.sub_index = 0x01;
+    request.length    = 10;
+    request.file      = file;
+
+    handle = sdo_client_submit(&request);
+    assert_true(handle != 0);
+
+    /* Both segments go out in one block, acknowledged at once. */
+    deliver_response(0x04, 0xa4, 0x1f50, 0x01, 0x7f);
+    deliver_frame(0x04, ack);
+    deliver_frame(0x04, end);
+
+    assert_true(sdo_client_wait(handle, &completion) == ALL_OK);
+    assert_true(completion.sdo_state == IS_WRITE_BLOCK);
+    assert_true(completion.length == 10);
+
+    sdo_client_deinit();
+    dispatch_deinit(&core);
+    os_fclose(file);
+}
+
+void test_sdo_client_block_download_retransmit(void** state)
+{
+    core_t           core       = { 0 };
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    uint8            data[20]   = { 0 };
+    uint32           handle;
+    const uint8      partial[8] = { 0xa2, 0x01, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    const uint8      invalid[8] = { 0xa2, 0x05, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    const uint8      ack[8]     = { 0xa2, 0x02, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    const uint8      end[8]     = { 0xa1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+    (void)state;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    request.type      = SDO_REQUEST_WRITE_BLOCK;
+    request.node_id   = 0x05;
+    request.index     = 0x1f50;
+    request.sub_index = 0x01;
+    request.data      = data;
+    request.length    = sizeof(data);
+
+    /* Three segments, the server only got the first and resumes there. */
+    handle = sdo_client_submit(&request);
+    deliver_response(0x05, 0xa4, 0x1f50, 0x01, 0x7f);
+    deliver_frame(0x05, partial);
+    deliver_frame(0x05, ack);
+    deliver_frame(0x05, end);
+
+    assert_true(sdo_client_wait(handle, &completion) == ALL_OK);
+    assert_true(completion.sdo_state == IS_WRITE_BLOCK);
+    assert_true(completion.length == sizeof(data));
+
+    /* Acknowledging more than was sent is a protocol error. */
+    handle = sdo_client_submit(&request);
+    deliver_response(0x05, 0xa4, 0x1f50, 0x01, 0x7f);
+    deliver_frame(0x05, invalid);
+
+    assert_true(sdo_client_wait(handle, &completion) == ALL_OK);
+    assert_true(completion.sdo_state == ABORT_TRANSFER);
+    assert_true(completion.abort_code == ABORT_INVALID_SEQUENCE_NUMBER);
+
+    sdo_client_deinit();
+    dispatch_deinit(&core);
+}
+
+void test_sdo_client_timeout_retry(void** state)
+{
+    core_t           core       = { 0 };
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    uint8            buffer[4]  = { 0 };
+    uint32           handle;
+    uint32           rto;
+    uint64           start;
+
+    (void)state;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    request.type      = SDO_REQUEST_READ;
+    request.node_id   = 0x22;
+    request.index     = 0x1000;
+    request.sub_index = 0x00;
+    request.data      = buffer;
+    request.length    = sizeof(buffer);
+
+    /* Nothing measured yet, so the configured timeout applies. */
+    rto = sdo_client_get_rto(0x22);
+    assert_true(rto == sdo_get_timeout());
+
+    /* The first answer is lost, the repeated request still gets one. */
+    start  = os_get_ticks();
+    handle = sdo_client_submit(&request);
+    while ((os_get_ticks() - start) < (rto + (rto / 2)))
+    {
+        sdo_client_process(1);
+    }
+    assert_true(sdo_client_get_pending() == 1);
+
+    deliver_response(0x22, 0x43, 0x1000, 0x00, 0x00020192);
+
+    assert_true(sdo_client_wait(handle, &completion) == ALL_OK);
+    assert_true(completion.sdo_state == IS_READ_EXPEDITED);
+
+    /* Repeated requests make no sample, so nothing's known yet. */
+    assert_true(sdo_client_get_rto(0x22) == rto);
+
+    /* A quick answer brings the timeout down for this node. */
+    handle = sdo_client_submit(&request);
+    deliver_response(0x22, 0x43, 0x1000, 0x00, 0x00020192);
+
+    assert_true(sdo_client_wait(handle, &completion) == ALL_OK);
+    assert_true(completion.sdo_state == IS_READ_EXPEDITED);
+    assert_true(sdo_client_get_rto(0x22) < rto);
+
+    sdo_client_deinit();
+    dispatch_deinit(&core);
+}
+
+void test_sdo_client_slow_node(void** state)
+{
+    core_t           core       = { 0 };
+    sdo_request_t    request    = { 0 };
+    sdo_completion_t completion = { 0 };
+    uint8            buffer[4]  = { 0 };
+    uint32           handle;
+    uint64           start;
+
+    (void)state;
+
+    assert_true(dispatch_init(&core) == ALL_OK);
+
+    request.type      = SDO_REQUEST_READ;
+    request.node_id   = 0x23;
+    request.index     = 0x1000;
+    request.sub_index = 0x00;
+    request.data      = buffer;
+    request.length    = sizeof(buffer);
+
+    /* A quick node brings the timeout of the bus down. */
+    handle = sdo_client_submit(&request);
+    deliver_response(0x23, 0x43, 0x1000, 0x00, 0x00020192);
+    assert_true(sdo_client_wait(handle, &completion) == ALL_OK);
+    assert_true(sdo_client_get_rto(0x23) < sdo_get_timeout());
+
+    /* One that hasn't answered yet still gets the configured timeout. */
+    assert_true(sdo_client_get_rto(0x24) == sdo_get_timeout());
+
+    request.node_id = 0x24;
+    start           = os_get_ticks();
+    handle          = sdo_client_submit(&request);
+    while ((os_get_ticks() - start) < (sdo_get_timeout() / 2))
+    {
+        sdo_client_process(1);
+    }
+    assert_true(sdo_client_get_pending() == 1);
+
+    deliver_response(0x24, 0x43, 0x1000, 0x00, 0x00020192);
+    assert_true(sdo_client_wait(handle, &completion) == ALL_OK);
+    assert_true(completion.sdo_state == IS_READ_EXPEDITED);
+
+    /* Starting over, every node goes by the configured timeout again. */
+    sdo_client_reset_rtt();
+    assert_true(sdo_client_get_rto(0x23) == sdo_get_timeout());
+
+    sdo_client_deinit();
+    dispatch_deinit(&core);
+}
@@ -0,0 +1,23 @@
+/** @file test_sdo_client.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef TEST_SDO_CLIENT_H
+#define TEST_SDO_CLIENT_H
+
+void test_sdo_client_expedited_read(void** state);
+void test_sdo_client_concurrent_nodes(void** state);
+void test_sdo_client_segmented_upload(void** state);
+void test_sdo_client_block_upload(void** state);
+void test_sdo_client_block_upload_lost_segment(void** state);
+void test_sdo_client_block_download_file(void** state);
+void test_sdo_client_block_download_retransmit(void** state);
+void test_sdo_client_timeout_retry(void** state);
+void test_sdo_client_slow_node(void** state);
+
+#endif /* TEST_SDO_CLIENT_H */
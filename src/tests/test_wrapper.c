@@ -9,9 +9,10 @@
 
 #include "can.h"
 #include "os.h"
+#include "test_wrapper.h"
 
-#include "can.h"
-#include "os.h"
+can_message_t wrap_written[CAN_BATCH_SIZE];
+uint32        wrap_num_written;
 
 uint32 __wrap_can_read(can_message_t* message, disp_mode_t disp_mode, const char* comment)
 {
@@ -42,3 +43,23 @@ uint32 __wrap_can_write(can_message_t* message, disp_mode_t disp_mode, const cha
 
     return status;
 }
+
+uint32 __wrap_can_write_batch(can_message_t* messages, uint32 num_messages, uint32* num_written)
+{
+    uint32 status = 0;
+
+    if ((NULL == messages) || (NULL == num_written))
+    {
+        status = 1;
+    }
+    else
+    {
+        /* Kept for inspection, as much as fits. */
+        wrap_num_written = (num_messages < CAN_BATCH_SIZE) ? num_messages : CAN_BATCH_SIZE;
+        os_memcpy(wrap_written, messages, wrap_num_written * sizeof(can_message_t));
+
+        *num_written = num_messages;
+    }
+
+    return status;
+}
@@ -0,0 +1,20 @@
+/** @file test_wrapper.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2024, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef TEST_WRAPPER_H
+#define TEST_WRAPPER_H
+
+#include "can.h"
+#include "os.h"
+
+/* The last batch passed to can_write_batch(). */
+extern can_message_t wrap_written[CAN_BATCH_SIZE];
+extern uint32        wrap_num_written;
+
+#endif /* TEST_WRAPPER_H */